@@ -180,6 +180,23 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 	ERR_FAIL_V(-1);
 }
 
+int Compression::compress_zstd_with_dictionary(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, const uint8_t *p_dict, int p_dict_size) {
+	ZSTD_CCtx *cctx = ZSTD_createCCtx();
+	int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
+	size_t ret = ZSTD_compress_usingDict(cctx, p_dst, max_dst_size, p_src, p_src_size, p_dict, p_dict_size, zstd_level);
+	ZSTD_freeCCtx(cctx);
+	ERR_FAIL_COND_V(ZSTD_isError(ret), -1);
+	return ret;
+}
+
+int Compression::decompress_zstd_with_dictionary(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, const uint8_t *p_dict, int p_dict_size) {
+	ZSTD_DCtx *dctx = ZSTD_createDCtx();
+	size_t ret = ZSTD_decompress_usingDict(dctx, p_dst, p_dst_max_size, p_src, p_src_size, p_dict, p_dict_size);
+	ZSTD_freeDCtx(dctx);
+	ERR_FAIL_COND_V(ZSTD_isError(ret), -1);
+	return ret;
+}
+
 /**
 	This will handle both Gzip and Deflate streams. It will automatically allocate the output buffer into the provided p_dst_vect Vector.
 	This is required for compressed data whose final uncompressed size is unknown, as is the case for HTTP response bodies.
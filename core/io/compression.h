@@ -54,6 +54,11 @@ public:
 	static int get_max_compressed_buffer_size(int p_src_size, Mode p_mode = MODE_ZSTD);
 	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
 	static int decompress_dynamic(Vector<uint8_t> *p_dst_vect, int p_max_dst_size, const uint8_t *p_src, int p_src_size, Mode p_mode);
+
+	// Zstandard with a raw content dictionary, which helps with many small buffers sharing content.
+	// The output buffer must fit get_max_compressed_buffer_size(p_src_size, MODE_ZSTD) bytes.
+	static int compress_zstd_with_dictionary(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, const uint8_t *p_dict, int p_dict_size);
+	static int decompress_zstd_with_dictionary(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, const uint8_t *p_dict, int p_dict_size);
 };
 
 #endif // COMPRESSION_H
@@ -674,16 +674,16 @@ void FileAccess::store_buffer(const Vector<uint8_t> &p_buffer) {
 	store_buffer(&r[0], len);
 }
 
-void FileAccess::store_var(const Variant &p_var, bool p_full_objects) {
+void FileAccess::store_var(const Variant &p_var, bool p_full_objects, bool p_compact) {
 	int len;
-	Error err = encode_variant(p_var, nullptr, len, p_full_objects);
+	Error err = p_compact ? encode_variant_compact(p_var, nullptr, len, p_full_objects) : encode_variant(p_var, nullptr, len, p_full_objects);
 	ERR_FAIL_COND_MSG(err != OK, "Error when trying to encode Variant.");
 
 	Vector<uint8_t> buff;
 	buff.resize(len);
 
 	uint8_t *w = buff.ptrw();
-	err = encode_variant(p_var, &w[0], len, p_full_objects);
+	err = p_compact ? encode_variant_compact(p_var, &w[0], len, p_full_objects) : encode_variant(p_var, &w[0], len, p_full_objects);
 	ERR_FAIL_COND_MSG(err != OK, "Error when trying to encode Variant.");
 
 	store_32(len);
@@ -851,7 +851,7 @@ void FileAccess::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("store_line", "line"), &FileAccess::store_line);
 	ClassDB::bind_method(D_METHOD("store_csv_line", "values", "delim"), &FileAccess::store_csv_line, DEFVAL(","));
 	ClassDB::bind_method(D_METHOD("store_string", "string"), &FileAccess::store_string);
-	ClassDB::bind_method(D_METHOD("store_var", "value", "full_objects"), &FileAccess::store_var, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("store_var", "value", "full_objects", "compact"), &FileAccess::store_var, DEFVAL(false), DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("store_pascal_string", "string"), &FileAccess::store_pascal_string);
 	ClassDB::bind_method(D_METHOD("get_pascal_string"), &FileAccess::get_pascal_string);
@@ -128,6 +128,7 @@ public:
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
 	Vector<uint8_t> get_buffer(int64_t p_length) const;
+	virtual const uint8_t *get_mapped_buffer() const { return nullptr; } ///< read-only view of the whole file if it's memory mapped (or in memory), valid while the file is open. Returns nullptr if not supported.
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -164,7 +165,7 @@ public:
 	virtual void store_buffer(const uint8_t *p_src, uint64_t p_length); ///< store an array of bytes
 	void store_buffer(const Vector<uint8_t> &p_buffer);
 
-	void store_var(const Variant &p_var, bool p_full_objects = false);
+	void store_var(const Variant &p_var, bool p_full_objects = false, bool p_compact = false);
 
 	virtual bool file_exists(const String &p_name) = 0; ///< return true if a file exists
 
@@ -30,7 +30,10 @@
 
 #include "file_access_compressed.h"
 
+#include "core/io/marshalls.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size) {
 	magic = p_magic.ascii().get_data();
@@ -58,6 +61,97 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 		}                                                   \
 	}
 
+int FileAccessCompressed::_decompress_block(uint8_t *p_dst, const uint8_t *p_src, uint32_t p_block) const {
+	int dst_max_size = read_blocks.size() == 1 ? read_total : block_size;
+	if (cmode == Compression::MODE_ZSTD && !dictionary.is_empty()) {
+		return Compression::decompress_zstd_with_dictionary(p_dst, dst_max_size, p_src, read_blocks[p_block].csize, dictionary.ptr(), dictionary.size());
+	}
+	return Compression::decompress(p_dst, dst_max_size, p_src, read_blocks[p_block].csize, cmode);
+}
+
+bool FileAccessCompressed::_read_next_block() const {
+	if (read_block + 1 >= read_block_count) {
+		at_end = true;
+		return false;
+	}
+
+	//read another block of compressed data
+	read_block++;
+	f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
+	int ret = _decompress_block(buffer.ptrw(), comp_buffer.ptr(), read_block);
+	read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+	read_pos = 0;
+	if (ret == -1) {
+		at_end = true;
+		ERR_FAIL_V_MSG(false, "Compressed file is corrupt.");
+	}
+	if (read_block_size == 0) {
+		// The last block is empty when the length is a multiple of the block size.
+		at_end = true;
+		return false;
+	}
+	return true;
+}
+
+void FileAccessCompressed::_decompress_blocks_task(void *p_userdata, uint32_t p_index) {
+	DecompressBlocksData *data = (DecompressBlocksData *)p_userdata;
+	const FileAccessCompressed *file = data->file;
+	uint32_t block = data->first_block + p_index;
+
+	const uint8_t *src = data->src + (file->read_blocks[block].offset - data->src_offset);
+	int ret = file->_decompress_block(data->dst + (uint64_t)p_index * file->block_size, src, block);
+	if (ret != (int)file->block_size) {
+		data->failed.set();
+	}
+}
+
+// Decompresses the next p_count full blocks straight into p_dst, skipping the intermediate buffer.
+// The last of them is also kept in the buffer, so seeking back inside it does not read it again.
+bool FileAccessCompressed::_read_blocks_direct(uint8_t *p_dst, uint32_t p_count) const {
+	uint32_t first_block = read_block + 1;
+	uint32_t last_block = first_block + p_count - 1;
+	uint64_t block_bytes = (uint64_t)p_count * block_size;
+
+	bool failed = false;
+	if (block_bytes >= PARALLEL_DECOMPRESSION_MIN_SIZE && WorkerThreadPool::get_singleton()->get_thread_count() > 1 && WorkerThreadPool::get_singleton()->get_thread_index() == -1) {
+		// Read the compressed data of all blocks at once and decompress them in parallel.
+		// Not done from pool threads, which would otherwise block waiting for the group.
+		uint64_t src_offset = read_blocks[first_block].offset;
+		uint64_t src_size = read_blocks[last_block].offset + read_blocks[last_block].csize - src_offset;
+		LocalVector<uint8_t> src;
+		src.resize(src_size);
+		if (f->get_buffer(src.ptr(), src_size) != src_size) {
+			failed = true;
+		} else {
+			DecompressBlocksData data;
+			data.file = this;
+			data.src = src.ptr();
+			data.src_offset = src_offset;
+			data.dst = p_dst;
+			data.first_block = first_block;
+
+			WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(&_decompress_blocks_task, &data, p_count, -1, true, "Decompress file blocks");
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+			failed = data.failed.is_set();
+		}
+	} else {
+		for (uint32_t i = first_block; i <= last_block && !failed; i++) {
+			f->get_buffer(comp_buffer.ptrw(), read_blocks[i].csize);
+			failed = _decompress_block(p_dst + (uint64_t)(i - first_block) * block_size, comp_buffer.ptr(), i) != (int)block_size;
+		}
+	}
+
+	read_block = last_block;
+	read_block_size = block_size;
+	read_pos = block_size;
+	if (failed) {
+		at_end = true;
+		ERR_FAIL_V_MSG(false, "Compressed file is corrupt.");
+	}
+	memcpy(read_ptr, p_dst + block_bytes - block_size, block_size);
+	return true;
+}
+
 Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	f = p_base;
 	cmode = (Compression::Mode)f->get_32();
@@ -88,7 +182,7 @@ Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	read_block_count = bc;
 	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
 
-	int ret = Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
+	int ret = _decompress_block(buffer.ptrw(), comp_buffer.ptr(), 0);
 	read_block = 0;
 	read_pos = 0;
 
@@ -138,37 +232,8 @@ void FileAccessCompressed::_close() {
 
 	if (writing) {
 		//save block table and all compressed blocks
-
-		CharString mgc = magic.utf8();
-		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //write header 4
-		f->store_32(cmode); //write compression mode 4
-		f->store_32(block_size); //write block size 4
-		f->store_32(write_max); //max amount of data written 4
-		uint32_t bc = (write_max / block_size) + 1;
-
-		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(0); //compressed sizes, will update later
-		}
-
-		Vector<int> block_sizes;
-		for (uint32_t i = 0; i < bc; i++) {
-			uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
-
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
-
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
-		}
-
-		f->seek(16); //ok write block sizes
-		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(block_sizes[i]);
-		}
-		f->seek_end();
-		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //magic at the end too
+		Vector<uint8_t> data = compress_buffer(write_ptr, write_max, magic, cmode, block_size, dictionary);
+		f->store_buffer(data.ptr(), data.size());
 
 		buffer.clear();
 
@@ -180,6 +245,48 @@ void FileAccessCompressed::_close() {
 	f.unref();
 }
 
+Vector<uint8_t> FileAccessCompressed::compress_buffer(const uint8_t *p_data, uint64_t p_length, const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size, const Vector<uint8_t> &p_dictionary) {
+	ERR_FAIL_COND_V(p_block_size == 0, Vector<uint8_t>());
+	ERR_FAIL_COND_V_MSG(p_length > UINT32_MAX, Vector<uint8_t>(), "Compressed files can't be larger than 4 GiB.");
+	CharString mgc = p_magic.utf8();
+	ERR_FAIL_COND_V(mgc.length() != 4, Vector<uint8_t>());
+
+	bool use_dictionary = p_mode == Compression::MODE_ZSTD && !p_dictionary.is_empty();
+	uint32_t bc = (p_length / p_block_size) + 1;
+	uint32_t header_size = 16 + bc * 4;
+
+	Vector<uint8_t> out;
+	out.resize(header_size);
+	uint8_t *w = out.ptrw();
+	memcpy(w, mgc.get_data(), 4); //write header 4
+	encode_uint32(p_mode, &w[4]); //write compression mode 4
+	encode_uint32(p_block_size, &w[8]); //write block size 4
+	encode_uint32(p_length, &w[12]); //max amount of data written 4
+
+	for (uint32_t i = 0; i < bc; i++) {
+		uint32_t bl = i == (bc - 1) ? p_length % p_block_size : p_block_size;
+		const uint8_t *bp = &p_data[(uint64_t)i * p_block_size];
+
+		int cofs = out.size();
+		out.resize(cofs + Compression::get_max_compressed_buffer_size(bl, p_mode));
+		int s;
+		if (use_dictionary) {
+			s = Compression::compress_zstd_with_dictionary(out.ptrw() + cofs, bp, bl, p_dictionary.ptr(), p_dictionary.size());
+		} else {
+			s = Compression::compress(out.ptrw() + cofs, bp, bl, p_mode);
+		}
+		ERR_FAIL_COND_V(s < 0, Vector<uint8_t>());
+		out.resize(cofs + s);
+		encode_uint32(s, out.ptrw() + 16 + i * 4); //compressed size of the block
+	}
+
+	int end = out.size();
+	out.resize(end + 4);
+	memcpy(out.ptrw() + end, mgc.get_data(), 4); //magic at the end too
+
+	return out;
+}
+
 bool FileAccessCompressed::is_open() const {
 	return f.is_valid();
 }
@@ -220,7 +327,7 @@ void FileAccessCompressed::seek(uint64_t p_position) {
 				read_block = block_idx;
 				f->seek(read_blocks[read_block].offset);
 				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
+				int ret = _decompress_block(buffer.ptrw(), comp_buffer.ptr(), read_block);
 				ERR_FAIL_COND_MSG(ret == -1, "Compressed file is corrupt.");
 				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
 			}
@@ -270,7 +377,7 @@ uint8_t FileAccessCompressed::get_8() const {
 	ERR_FAIL_COND_V_MSG(f.is_null(), 0, "File must be opened before use.");
 	ERR_FAIL_COND_V_MSG(writing, 0, "File has not been opened in read mode.");
 
-	if (at_end) {
+	if (at_end || (read_pos >= read_block_size && !_read_next_block())) {
 		read_eof = true;
 		return 0;
 	}
@@ -279,20 +386,7 @@ uint8_t FileAccessCompressed::get_8() const {
 
 	read_pos++;
 	if (read_pos >= read_block_size) {
-		read_block++;
-
-		if (read_block < read_block_count) {
-			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			int total = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			ERR_FAIL_COND_V_MSG(total == -1, 0, "Compressed file is corrupt.");
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-			read_pos = 0;
-
-		} else {
-			read_block--;
-			at_end = true;
-		}
+		_read_next_block();
 	}
 
 	return ret;
@@ -308,32 +402,39 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 		return 0;
 	}
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
+	uint64_t read = 0;
+	while (read < p_length) {
+		if (read_pos >= read_block_size && !_read_next_block()) {
+			break;
+		}
 
-			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_V_MSG(ret == -1, -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-				read_pos = 0;
-
-			} else {
-				read_block--;
-				at_end = true;
-				if (i + 1 < p_length) {
-					read_eof = true;
-				}
-				return i + 1;
+		uint64_t to_copy = MIN(p_length - read, (uint64_t)(read_block_size - read_pos));
+		memcpy(p_dst + read, read_ptr + read_pos, to_copy);
+		read_pos += to_copy;
+		read += to_copy;
+		if (read_pos < read_block_size) {
+			break;
+		}
+
+		// Full blocks left to read (never the last one, which is always short) skip the buffer.
+		uint32_t full_blocks_left = read_block + 2 < read_block_count ? read_block_count - 2 - read_block : 0;
+		uint64_t full_blocks = MIN((p_length - read) / block_size, (uint64_t)full_blocks_left);
+		if (full_blocks > 0) {
+			if (!_read_blocks_direct(p_dst + read, full_blocks)) {
+				break;
 			}
+			read += full_blocks * block_size;
+		}
+
+		if (!_read_next_block()) {
+			break;
 		}
 	}
 
-	return p_length;
+	if (read < p_length) {
+		read_eof = true;
+	}
+	return read;
 }
 
 Error FileAccessCompressed::get_error() const {
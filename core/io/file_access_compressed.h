@@ -33,6 +33,7 @@
 
 #include "core/io/compression.h"
 #include "core/io/file_access.h"
+#include "core/templates/safe_refcount.h"
 
 class FileAccessCompressed : public FileAccess {
 	Compression::Mode cmode = Compression::MODE_ZSTD;
@@ -63,10 +64,34 @@ class FileAccessCompressed : public FileAccess {
 	mutable Vector<uint8_t> buffer;
 	Ref<FileAccess> f;
 
+	Vector<uint8_t> dictionary;
+
+	// Reads spanning at least this much data decompress their blocks in parallel.
+	static const uint64_t PARALLEL_DECOMPRESSION_MIN_SIZE = 256 * 1024;
+
+	struct DecompressBlocksData {
+		const FileAccessCompressed *file = nullptr;
+		const uint8_t *src = nullptr;
+		uint64_t src_offset = 0;
+		uint8_t *dst = nullptr;
+		uint32_t first_block = 0;
+		SafeFlag failed;
+	};
+
+	static void _decompress_blocks_task(void *p_userdata, uint32_t p_index);
+	int _decompress_block(uint8_t *p_dst, const uint8_t *p_src, uint32_t p_block) const;
+	bool _read_next_block() const;
+	bool _read_blocks_direct(uint8_t *p_dst, uint32_t p_count) const;
+
 	void _close();
 
 public:
 	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096);
+	// Compresses (or decompresses) Zstandard blocks using a raw content dictionary, must be set before opening.
+	void set_dictionary(const Vector<uint8_t> &p_dictionary) { dictionary = p_dictionary; }
+
+	// Returns p_data laid out as a compressed file (magic included), so it can be read back with open_after_magic().
+	static Vector<uint8_t> compress_buffer(const uint8_t *p_data, uint64_t p_length, const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size, const Vector<uint8_t> &p_dictionary = Vector<uint8_t>());
 
 	Error open_after_magic(Ref<FileAccess> p_base);
 
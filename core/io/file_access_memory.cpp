@@ -136,7 +136,7 @@ uint64_t FileAccessMemory::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
 	ERR_FAIL_COND_V(!data, -1);
 
-	uint64_t left = length - pos;
+	uint64_t left = pos < length ? length - pos : 0;
 	uint64_t read = MIN(p_length, left);
 
 	if (read < p_length) {
@@ -30,7 +30,9 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/marshalls.h"
 #include "core/object/script_language.h"
 #include "core/os/os.h"
 #include "core/version.h"
@@ -47,13 +49,33 @@ Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t
 	return ERR_FILE_UNRECOGNIZED;
 }
 
-void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted) {
+const uint8_t *PackedData::get_mapped_pack(const String &p_pack_path, uint64_t *r_size) {
+	MutexLock lock(mapped_packs_mutex);
+
+	Ref<FileAccess> *fp = mapped_packs.getptr(p_pack_path);
+	if (!fp) {
+		// Remember failures too, so they are not retried on every file.
+		fp = &mapped_packs.insert(p_pack_path, FileAccess::open(p_pack_path, FileAccess::READ))->value;
+	}
+	if (fp->is_null()) {
+		return nullptr;
+	}
+
+	const uint8_t *mapped = (*fp)->get_mapped_buffer();
+	if (mapped && r_size) {
+		*r_size = (*fp)->get_length();
+	}
+	return mapped;
+}
+
+void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, bool p_compressed) {
 	PathMD5 pmd5(p_path.md5_buffer());
 
 	bool exists = files.has(pmd5);
 
 	PackedFile pf;
 	pf.encrypted = p_encrypted;
+	pf.compressed = p_compressed;
 	pf.pack = p_pkg_path;
 	pf.offset = p_ofs;
 	pf.size = p_size;
@@ -63,6 +85,7 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 	pf.src = p_src;
 
 	if (!exists || p_replace_files) {
+		pf.priority = p_replace_files ? ++priority_top : --priority_bottom;
 		files[pmd5] = pf;
 	}
 
@@ -95,6 +118,138 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 	}
 }
 
+void PackedData::add_index(PackIndex *p_index, bool p_replace_files) {
+	ERR_FAIL_NULL(p_index);
+
+	// Files found in several packs come from the one with the highest priority.
+	// Packs replacing files rank above everything added before, the others below.
+	if (p_replace_files) {
+		p_index->priority = ++priority_top;
+		indexes.insert(0, p_index);
+	} else {
+		p_index->priority = --priority_bottom;
+		indexes.push_back(p_index);
+	}
+}
+
+bool PackedData::_find_file(const String &p_path, PackedFile &r_file) {
+	const PackedFile *added = nullptr;
+	if (!files.is_empty()) {
+		HashMap<PathMD5, PackedFile, PathMD5>::Iterator E = files.find(PathMD5(p_path.md5_buffer()));
+		if (E) {
+			added = &E->value;
+		}
+	}
+
+	for (const PackIndex *index : indexes) {
+		if (added && index->priority < added->priority) {
+			break;
+		}
+		int64_t file = index->find_file(p_path);
+		if (file != -1) {
+			index->get_file(file, r_file);
+			return true;
+		}
+	}
+
+	if (!added || added->offset == 0) {
+		return false; //not found or erased
+	}
+	r_file = *added;
+	return true;
+}
+
+PackedData::PackedDir *PackedData::_find_packed_dir(const String &p_dir) const {
+	PackedDir *pd = root;
+	if (p_dir.is_empty()) {
+		return pd;
+	}
+
+	Vector<String> ds = p_dir.split("/");
+	for (int i = 0; i < ds.size(); i++) {
+		PackedDir *const *sd = pd->subdirs.getptr(ds[i]);
+		if (!sd) {
+			return nullptr;
+		}
+		pd = *sd;
+	}
+	return pd;
+}
+
+bool PackedData::_dir_exists(const String &p_dir) const {
+	if (_find_packed_dir(p_dir)) {
+		return true;
+	}
+	for (const PackIndex *index : indexes) {
+		if (index->find_dir(p_dir) != -1) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool PackedData::_dir_has_file(const String &p_dir, const String &p_file) const {
+	PackedDir *pd = _find_packed_dir(p_dir);
+	if (pd && pd->files.has(p_file)) {
+		return true;
+	}
+	for (const PackIndex *index : indexes) {
+		int64_t dir = index->find_dir(p_dir);
+		if (dir != -1 && index->dir_has_file(dir, p_file)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void PackedData::_get_dir_contents(const String &p_dir, List<String> *r_dirs, List<String> *r_files) const {
+	PackedDir *pd = _find_packed_dir(p_dir);
+	if (pd) {
+		for (const KeyValue<String, PackedDir *> &E : pd->subdirs) {
+			r_dirs->push_back(E.key);
+		}
+		for (const String &E : pd->files) {
+			r_files->push_back(E);
+		}
+	}
+
+	bool merge = pd != nullptr;
+	for (const PackIndex *index : indexes) {
+		int64_t dir = index->find_dir(p_dir);
+		if (dir == -1) {
+			continue;
+		}
+		if (!merge) {
+			index->get_dir_contents(dir, r_dirs, r_files);
+			merge = true;
+			continue;
+		}
+
+		// Several packs have this directory, skip what the others already listed.
+		HashSet<String> dirs_listed;
+		for (const String &E : *r_dirs) {
+			dirs_listed.insert(E);
+		}
+		HashSet<String> files_listed;
+		for (const String &E : *r_files) {
+			files_listed.insert(E);
+		}
+		List<String> index_dirs;
+		List<String> index_files;
+		index->get_dir_contents(dir, &index_dirs, &index_files);
+		for (const String &E : index_dirs) {
+			if (!dirs_listed.has(E)) {
+				r_dirs->push_back(E);
+			}
+		}
+		for (const String &E : index_files) {
+			if (!files_listed.has(E)) {
+				r_files->push_back(E);
+			}
+		}
+	}
+}
+
 void PackedData::add_pack_source(PackSource *p_source) {
 	if (p_source != nullptr) {
 		sources.push_back(p_source);
@@ -121,11 +276,420 @@ PackedData::~PackedData() {
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
+	for (PackIndex *index : indexes) {
+		memdelete(index);
+	}
 	_free_packed_dirs(root);
 }
 
 //////////////////////////////////////////////////////////////////
 
+// Compares a string to UTF-8 bytes in byte order, which is how the index is sorted.
+static int _compare_utf8(const char32_t *p_chars, int p_length, const uint8_t *p_utf8, uint32_t p_utf8_length) {
+	for (int i = 0; i < p_length; i++) {
+		if (p_chars[i] >= 0x80) {
+			CharString cs = String(p_chars, p_length).utf8();
+			int cmp = memcmp(cs.get_data(), p_utf8, MIN((uint32_t)cs.length(), p_utf8_length));
+			if (cmp != 0) {
+				return cmp;
+			}
+			return (uint32_t)cs.length() < p_utf8_length ? -1 : ((uint32_t)cs.length() > p_utf8_length ? 1 : 0);
+		}
+		if ((uint32_t)i >= p_utf8_length) {
+			return 1;
+		}
+		if (p_chars[i] != p_utf8[i]) {
+			return p_chars[i] < p_utf8[i] ? -1 : 1;
+		}
+	}
+	return (uint32_t)p_length < p_utf8_length ? -1 : 0;
+}
+
+static bool _is_utf8_less(const CharString &p_a, const CharString &p_b) {
+	int cmp = memcmp(p_a.get_data(), p_b.get_data(), MIN(p_a.length(), p_b.length()));
+	return cmp != 0 ? cmp < 0 : p_a.length() < p_b.length();
+}
+
+// Name of a file in its directory.
+static void _get_utf8_file_name(const uint8_t *&r_path, uint32_t &r_length) {
+	for (uint32_t i = r_length; i > 0; i--) {
+		if (r_path[i - 1] == '/') {
+			r_path += i;
+			r_length -= i;
+			return;
+		}
+	}
+}
+
+uint64_t PackIndex::get_size(const uint8_t *p_header) {
+	uint64_t file_count = decode_uint32(&p_header[0]);
+	uint64_t dir_count = decode_uint32(&p_header[4]);
+	uint64_t dir_file_count = decode_uint32(&p_header[8]);
+	uint64_t strings_size = decode_uint32(&p_header[12]);
+	return HEADER_SIZE + file_count * FILE_ENTRY_SIZE + dir_count * DIR_ENTRY_SIZE + dir_file_count * 4 + strings_size;
+}
+
+Vector<uint8_t> PackIndex::build(const Vector<FileInfo> &p_files) {
+	struct Entry {
+		uint64_t hash = 0;
+		CharString path;
+		const FileInfo *info = nullptr;
+	};
+
+	struct EntrySort {
+		bool operator()(const Entry &p_a, const Entry &p_b) const {
+			return p_a.hash != p_b.hash ? p_a.hash < p_b.hash : _is_utf8_less(p_a.path, p_b.path);
+		}
+	};
+
+	// Files added again replace the previous ones, like packs added with replace_files.
+	LocalVector<Entry> entries;
+	HashMap<String, uint32_t> entry_indices;
+	for (const FileInfo &fi : p_files) {
+		uint32_t *index = entry_indices.getptr(fi.path);
+		if (index) {
+			entries[*index].info = &fi;
+			continue;
+		}
+		entry_indices.insert(fi.path, entries.size());
+		Entry e;
+		e.hash = hash_path(fi.path);
+		e.path = fi.path.utf8();
+		e.info = &fi;
+		entries.push_back(e);
+	}
+	entries.sort_custom<EntrySort>();
+
+	struct NameIndex {
+		CharString name;
+		uint32_t index = 0;
+	};
+
+	struct NameIndexSort {
+		bool operator()(const NameIndex &p_a, const NameIndex &p_b) const {
+			return _is_utf8_less(p_a.name, p_b.name);
+		}
+	};
+
+	struct Dir {
+		CharString name;
+		HashMap<String, uint32_t> subdirs;
+		LocalVector<uint32_t> files;
+	};
+
+	LocalVector<Dir> tree;
+	tree.resize(1);
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		String path = entries[i].info->path.replace_first("res://", "");
+		uint32_t dir = 0;
+		if (path.contains("/")) { //in a subdir
+			Vector<String> ds = path.get_base_dir().split("/");
+			for (int j = 0; j < ds.size(); j++) {
+				uint32_t *sd = tree[dir].subdirs.getptr(ds[j]);
+				if (sd) {
+					dir = *sd;
+				} else {
+					Dir nd;
+					nd.name = ds[j].utf8();
+					tree[dir].subdirs.insert(ds[j], tree.size());
+					dir = tree.size();
+					tree.push_back(nd);
+				}
+			}
+		}
+		// Don't add as a file if the path points to a directory
+		if (!path.get_file().is_empty()) {
+			tree[dir].files.push_back(i);
+		}
+	}
+
+	// Breadth first, so the subdirectories of each directory are next to each other.
+	LocalVector<uint32_t> dir_order;
+	LocalVector<uint32_t> first_subdir;
+	dir_order.push_back(0);
+	for (uint32_t i = 0; i < dir_order.size(); i++) {
+		const Dir &d = tree[dir_order[i]];
+		LocalVector<NameIndex> subdirs;
+		subdirs.reserve(d.subdirs.size());
+		for (const KeyValue<String, uint32_t> &E : d.subdirs) {
+			NameIndex sd;
+			sd.name = tree[E.value].name;
+			sd.index = E.value;
+			subdirs.push_back(sd);
+		}
+		subdirs.sort_custom<NameIndexSort>();
+		first_subdir.push_back(dir_order.size());
+		for (const NameIndex &sd : subdirs) {
+			dir_order.push_back(sd.index);
+		}
+	}
+
+	uint32_t dir_file_count = 0;
+	uint64_t strings_size = 0;
+	for (const Entry &e : entries) {
+		strings_size += e.path.length();
+	}
+	for (const Dir &d : tree) {
+		dir_file_count += d.files.size();
+		strings_size += d.name.length();
+	}
+	ERR_FAIL_COND_V_MSG(strings_size > UINT32_MAX, Vector<uint8_t>(), "Too many files for a pack index.");
+
+	Vector<uint8_t> index;
+	index.resize(HEADER_SIZE + entries.size() * FILE_ENTRY_SIZE + tree.size() * DIR_ENTRY_SIZE + dir_file_count * 4 + strings_size);
+	memset(index.ptrw(), 0, index.size());
+	uint8_t *w = index.ptrw();
+	uint8_t *w_files = w + HEADER_SIZE;
+	uint8_t *w_dirs = w_files + entries.size() * FILE_ENTRY_SIZE;
+	uint8_t *w_dir_files = w_dirs + tree.size() * DIR_ENTRY_SIZE;
+	uint8_t *w_strings = w_dir_files + dir_file_count * 4;
+
+	encode_uint32(entries.size(), &w[0]);
+	encode_uint32(tree.size(), &w[4]);
+	encode_uint32(dir_file_count, &w[8]);
+	encode_uint32(strings_size, &w[12]);
+
+	uint32_t string_ofs = 0;
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		const Entry &e = entries[i];
+		uint8_t *we = w_files + i * FILE_ENTRY_SIZE;
+		encode_uint64(e.hash, &we[0]);
+		encode_uint64(e.info->offset, &we[8]);
+		encode_uint64(e.info->size, &we[16]);
+		memcpy(&we[24], e.info->md5, 16);
+		encode_uint32(string_ofs, &we[40]);
+		encode_uint32(e.path.length(), &we[44]);
+		encode_uint32(e.info->flags, &we[48]);
+
+		memcpy(w_strings + string_ofs, e.path.get_data(), e.path.length());
+		string_ofs += e.path.length();
+	}
+
+	uint32_t dir_file_ofs = 0;
+	for (uint32_t i = 0; i < dir_order.size(); i++) {
+		const Dir &d = tree[dir_order[i]];
+		uint8_t *wd = w_dirs + i * DIR_ENTRY_SIZE;
+		encode_uint32(string_ofs, &wd[0]);
+		encode_uint32(d.name.length(), &wd[4]);
+		encode_uint32(first_subdir[i], &wd[8]);
+		encode_uint32(d.subdirs.size(), &wd[12]);
+		encode_uint32(dir_file_ofs, &wd[16]);
+		encode_uint32(d.files.size(), &wd[20]);
+
+		memcpy(w_strings + string_ofs, d.name.get_data(), d.name.length());
+		string_ofs += d.name.length();
+
+		LocalVector<NameIndex> dir_files_sorted;
+		dir_files_sorted.reserve(d.files.size());
+		for (uint32_t f : d.files) {
+			const uint8_t *name = (const uint8_t *)entries[f].path.get_data();
+			uint32_t name_length = entries[f].path.length();
+			_get_utf8_file_name(name, name_length);
+			NameIndex df;
+			df.name.resize(name_length + 1);
+			memcpy(df.name.ptrw(), name, name_length);
+			df.name[name_length] = 0;
+			df.index = f;
+			dir_files_sorted.push_back(df);
+		}
+		dir_files_sorted.sort_custom<NameIndexSort>();
+		for (const NameIndex &df : dir_files_sorted) {
+			encode_uint32(df.index, &w_dir_files[dir_file_ofs * 4]);
+			dir_file_ofs++;
+		}
+	}
+
+	return index;
+}
+
+Error PackIndex::init(const uint8_t *p_data, uint64_t p_size) {
+	ERR_FAIL_COND_V(p_size < HEADER_SIZE || get_size(p_data) > p_size, ERR_FILE_CORRUPT);
+
+	data = p_data;
+	file_count = decode_uint32(&data[0]);
+	dir_count = decode_uint32(&data[4]);
+	dir_file_count = decode_uint32(&data[8]);
+	strings_size = decode_uint32(&data[12]);
+	files = data + HEADER_SIZE;
+	dirs = files + (uint64_t)file_count * FILE_ENTRY_SIZE;
+	dir_files = dirs + (uint64_t)dir_count * DIR_ENTRY_SIZE;
+	strings = dir_files + (uint64_t)dir_file_count * 4;
+	return OK;
+}
+
+Error PackIndex::init_owned(const Vector<uint8_t> &p_data) {
+	owned_data = p_data;
+	return init(owned_data.ptr(), owned_data.size());
+}
+
+const uint8_t *PackIndex::_get_string(uint32_t p_offset, uint32_t p_length) const {
+	ERR_FAIL_COND_V_MSG((uint64_t)p_offset + p_length > strings_size, nullptr, "Pack index of '" + pack_path + "' is corrupt.");
+	return strings + p_offset;
+}
+
+int64_t PackIndex::find_file(const String &p_path) const {
+	uint64_t hash = hash_path(p_path);
+
+	uint32_t lo = 0;
+	uint32_t hi = file_count;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (decode_uint64(files + (uint64_t)mid * FILE_ENTRY_SIZE) < hash) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	for (uint32_t i = lo; i < file_count; i++) {
+		const uint8_t *e = files + (uint64_t)i * FILE_ENTRY_SIZE;
+		if (decode_uint64(&e[0]) != hash) {
+			break;
+		}
+		uint32_t path_length = decode_uint32(&e[44]);
+		const uint8_t *path = _get_string(decode_uint32(&e[40]), path_length);
+		if (path && _compare_utf8(p_path.ptr(), p_path.length(), path, path_length) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void PackIndex::get_file(uint32_t p_index, PackedData::PackedFile &r_file) const {
+	ERR_FAIL_UNSIGNED_INDEX(p_index, file_count);
+
+	const uint8_t *e = files + (uint64_t)p_index * FILE_ENTRY_SIZE;
+	uint32_t flags = decode_uint32(&e[48]);
+	r_file.pack = pack_path;
+	r_file.offset = files_base + decode_uint64(&e[8]);
+	r_file.size = decode_uint64(&e[16]);
+	memcpy(r_file.md5, &e[24], 16);
+	r_file.src = src;
+	r_file.encrypted = flags & PACK_FILE_ENCRYPTED;
+	r_file.compressed = flags & PACK_FILE_COMPRESSED;
+	r_file.priority = priority;
+}
+
+int64_t PackIndex::_find_subdir(uint32_t p_dir, const char32_t *p_name, int p_name_length) const {
+	const uint8_t *d = dirs + (uint64_t)p_dir * DIR_ENTRY_SIZE;
+	uint32_t first = decode_uint32(&d[8]);
+	uint32_t count = decode_uint32(&d[12]);
+	ERR_FAIL_COND_V_MSG((uint64_t)first + count > dir_count, -1, "Pack index of '" + pack_path + "' is corrupt.");
+
+	uint32_t lo = first;
+	uint32_t hi = first + count;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		const uint8_t *sd = dirs + (uint64_t)mid * DIR_ENTRY_SIZE;
+		uint32_t name_length = decode_uint32(&sd[4]);
+		const uint8_t *name = _get_string(decode_uint32(&sd[0]), name_length);
+		if (!name) {
+			return -1;
+		}
+		int cmp = _compare_utf8(p_name, p_name_length, name, name_length);
+		if (cmp == 0) {
+			return mid;
+		} else if (cmp < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+	return -1;
+}
+
+int64_t PackIndex::find_dir(const String &p_dir) const {
+	if (dir_count == 0) {
+		return -1;
+	}
+
+	const char32_t *chars = p_dir.ptr();
+	int length = p_dir.length();
+	int64_t dir = 0;
+	int start = 0;
+	while (start < length) {
+		int end = start;
+		while (end < length && chars[end] != '/') {
+			end++;
+		}
+		if (end > start) {
+			dir = _find_subdir(dir, &chars[start], end - start);
+			if (dir == -1) {
+				return -1;
+			}
+		}
+		start = end + 1;
+	}
+	return dir;
+}
+
+bool PackIndex::dir_has_file(uint32_t p_dir, const String &p_file) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_dir, dir_count, false);
+
+	const uint8_t *d = dirs + (uint64_t)p_dir * DIR_ENTRY_SIZE;
+	uint32_t first = decode_uint32(&d[16]);
+	uint32_t count = decode_uint32(&d[20]);
+	ERR_FAIL_COND_V_MSG((uint64_t)first + count > dir_file_count, false, "Pack index of '" + pack_path + "' is corrupt.");
+
+	uint32_t lo = first;
+	uint32_t hi = first + count;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		uint32_t file = decode_uint32(&dir_files[(uint64_t)mid * 4]);
+		ERR_FAIL_UNSIGNED_INDEX_V(file, file_count, false);
+		const uint8_t *e = files + (uint64_t)file * FILE_ENTRY_SIZE;
+		uint32_t name_length = decode_uint32(&e[44]);
+		const uint8_t *name = _get_string(decode_uint32(&e[40]), name_length);
+		if (!name) {
+			return false;
+		}
+		_get_utf8_file_name(name, name_length);
+		int cmp = _compare_utf8(p_file.ptr(), p_file.length(), name, name_length);
+		if (cmp == 0) {
+			return true;
+		} else if (cmp < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+	return false;
+}
+
+void PackIndex::get_dir_contents(uint32_t p_dir, List<String> *r_dirs, List<String> *r_files) const {
+	ERR_FAIL_UNSIGNED_INDEX(p_dir, dir_count);
+
+	const uint8_t *d = dirs + (uint64_t)p_dir * DIR_ENTRY_SIZE;
+	uint32_t first_subdir = decode_uint32(&d[8]);
+	uint32_t subdir_count = decode_uint32(&d[12]);
+	uint32_t first_file = decode_uint32(&d[16]);
+	uint32_t file_count_in_dir = decode_uint32(&d[20]);
+	ERR_FAIL_COND_MSG((uint64_t)first_subdir + subdir_count > dir_count || (uint64_t)first_file + file_count_in_dir > dir_file_count, "Pack index of '" + pack_path + "' is corrupt.");
+
+	for (uint32_t i = first_subdir; i < first_subdir + subdir_count; i++) {
+		const uint8_t *sd = dirs + (uint64_t)i * DIR_ENTRY_SIZE;
+		uint32_t name_length = decode_uint32(&sd[4]);
+		const uint8_t *name = _get_string(decode_uint32(&sd[0]), name_length);
+		if (name) {
+			r_dirs->push_back(String::utf8((const char *)name, name_length));
+		}
+	}
+
+	for (uint32_t i = first_file; i < first_file + file_count_in_dir; i++) {
+		uint32_t file = decode_uint32(&dir_files[(uint64_t)i * 4]);
+		ERR_CONTINUE(file >= file_count);
+		const uint8_t *e = files + (uint64_t)file * FILE_ENTRY_SIZE;
+		uint32_t name_length = decode_uint32(&e[44]);
+		const uint8_t *name = _get_string(decode_uint32(&e[40]), name_length);
+		if (name) {
+			_get_utf8_file_name(name, name_length);
+			r_files->push_back(String::utf8((const char *)name, name_length));
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////
+
 bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
 	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
 	if (f.is_null()) {
@@ -200,7 +764,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // patch number, not used for validation.
 
-	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
+	ERR_FAIL_COND_V_MSG(version < PACK_FORMAT_VERSION_MIN || version > PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
 	ERR_FAIL_COND_V_MSG(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false, "Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + ".");
 
 	uint32_t pack_flags = f->get_32();
@@ -208,13 +772,25 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 
 	bool enc_directory = (pack_flags & PACK_DIR_ENCRYPTED);
 
-	for (int i = 0; i < 16; i++) {
+	uint64_t dictionary_ofs = f->get_64();
+	uint32_t dictionary_size = f->get_32();
+	for (int i = 0; i < 13; i++) {
 		//reserved
 		f->get_32();
 	}
 
 	int file_count = f->get_32();
 
+	if (pack_flags & PACK_COMPRESSION_DICTIONARY) {
+		uint64_t dir_pos = f->get_position();
+		Vector<uint8_t> dictionary;
+		dictionary.resize(dictionary_size);
+		f->seek(file_base + dictionary_ofs + p_offset);
+		ERR_FAIL_COND_V_MSG(f->get_buffer(dictionary.ptrw(), dictionary_size) != dictionary_size, false, "Can't read pack compression dictionary.");
+		dictionaries[p_path] = dictionary;
+		f->seek(dir_pos);
+	}
+
 	if (enc_directory) {
 		Ref<FileAccessEncrypted> fae;
 		fae.instantiate();
@@ -231,6 +807,45 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f = fae;
 	}
 
+	if (version >= PACK_FORMAT_VERSION_INDEX) {
+		PackIndex *index = memnew(PackIndex);
+		index->pack_path = p_path;
+		index->files_base = file_base + p_offset;
+		index->src = this;
+
+		Error err = FAILED;
+		if (!enc_directory) {
+			// Use the index in place, it's only paged in as it's searched.
+			uint64_t pack_size = 0;
+			const uint8_t *pack = PackedData::get_singleton()->get_mapped_pack(p_path, &pack_size);
+			uint64_t index_pos = f->get_position();
+			if (pack && index_pos + PackIndex::HEADER_SIZE <= pack_size) {
+				err = index->init(pack + index_pos, pack_size - index_pos);
+			}
+		}
+		if (err != OK) {
+			Vector<uint8_t> data;
+			data.resize(PackIndex::HEADER_SIZE);
+			if (f->get_buffer(data.ptrw(), PackIndex::HEADER_SIZE) == PackIndex::HEADER_SIZE) {
+				uint64_t index_size = PackIndex::get_size(data.ptr());
+				if (index_size <= (uint64_t)INT32_MAX) {
+					data.resize(index_size);
+					uint64_t rest = index_size - PackIndex::HEADER_SIZE;
+					if (f->get_buffer(data.ptrw() + PackIndex::HEADER_SIZE, rest) == rest) {
+						err = index->init_owned(data);
+					}
+				}
+			}
+		}
+		if (err != OK) {
+			memdelete(index);
+			ERR_FAIL_V_MSG(false, "Can't read pack index.");
+		}
+
+		PackedData::get_singleton()->add_index(index, p_replace_files);
+		return true;
+	}
+
 	for (int i = 0; i < file_count; i++) {
 		uint32_t sl = f->get_32();
 		CharString cs;
@@ -247,14 +862,31 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f->get_buffer(md5, 16);
 		uint32_t flags = f->get_32();
 
-		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED));
+		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED), (flags & PACK_FILE_COMPRESSED));
 	}
 
 	return true;
 }
 
 Ref<FileAccess> PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
-	return memnew(FileAccessPack(p_path, *p_file));
+	Ref<FileAccess> f = memnew(FileAccessPack(p_path, *p_file));
+	if (!p_file->compressed) {
+		return f;
+	}
+
+	char magic[5] = {};
+	f->get_buffer((uint8_t *)magic, 4);
+	ERR_FAIL_COND_V_MSG(String(magic) != PACK_FILE_COMPRESSED_MAGIC, Ref<FileAccess>(), "Compressed pack-referenced file '" + p_path + "' is corrupt.");
+
+	Ref<FileAccessCompressed> fac;
+	fac.instantiate();
+	const Vector<uint8_t> *dictionary = dictionaries.getptr(p_file->pack);
+	if (dictionary) {
+		fac->set_dictionary(*dictionary);
+	}
+	Error err = fac->open_after_magic(f);
+	ERR_FAIL_COND_V_MSG(err != OK, Ref<FileAccess>(), "Can't open compressed pack-referenced file '" + p_path + "'.");
+	return fac;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -336,6 +968,23 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_mapped_buffer() const {
+	ERR_FAIL_COND_V_MSG(f.is_null(), nullptr, "File must be opened before use.");
+
+	if (!map_checked) {
+		map_checked = true;
+		// Encrypted files have to go through FileAccessEncrypted.
+		if (!pf.encrypted) {
+			uint64_t pack_size = 0;
+			const uint8_t *pack = PackedData::get_singleton()->get_mapped_pack(pf.pack, &pack_size);
+			if (pack && pf.offset + pf.size <= pack_size) {
+				mapped = pack + pf.offset;
+			}
+		}
+	}
+	return mapped;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
 	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
 
@@ -402,13 +1051,7 @@ Error DirAccessPack::list_dir_begin() {
 	list_dirs.clear();
 	list_files.clear();
 
-	for (const KeyValue<String, PackedData::PackedDir *> &E : current->subdirs) {
-		list_dirs.push_back(E.key);
-	}
-
-	for (const String &E : current->files) {
-		list_files.push_back(E);
-	}
+	PackedData::get_singleton()->_get_dir_contents(current, &list_dirs, &list_files);
 
 	return OK;
 }
@@ -450,12 +1093,21 @@ String DirAccessPack::get_drive(int p_drive) {
 	return "";
 }
 
-PackedData::PackedDir *DirAccessPack::_find_dir(String p_dir) {
+static String _get_parent_dir(const String &p_dir) {
+	int sep = p_dir.rfind("/");
+	return sep == -1 ? String() : p_dir.substr(0, sep);
+}
+
+bool DirAccessPack::_find_dir(String p_dir, String &r_dir) const {
 	String nd = p_dir.replace("\\", "/");
 
 	// Special handling since simplify_path() will forbid it
 	if (p_dir == "..") {
-		return current->parent;
+		if (current.is_empty()) {
+			return false;
+		}
+		r_dir = _get_parent_dir(current);
+		return true;
 	}
 
 	bool absolute = false;
@@ -477,37 +1129,30 @@ PackedData::PackedDir *DirAccessPack::_find_dir(String p_dir) {
 
 	Vector<String> paths = nd.split("/");
 
-	PackedData::PackedDir *pd;
-
-	if (absolute) {
-		pd = PackedData::get_singleton()->root;
-	} else {
-		pd = current;
-	}
+	String dir = absolute ? String() : current;
 
 	for (int i = 0; i < paths.size(); i++) {
 		String p = paths[i];
 		if (p == ".") {
 			continue;
 		} else if (p == "..") {
-			if (pd->parent) {
-				pd = pd->parent;
-			}
-		} else if (pd->subdirs.has(p)) {
-			pd = pd->subdirs[p];
-
+			dir = _get_parent_dir(dir);
 		} else {
-			return nullptr;
+			dir = dir.path_join(p);
+			if (!PackedData::get_singleton()->_dir_exists(dir)) {
+				return false;
+			}
 		}
 	}
 
-	return pd;
+	r_dir = dir;
+	return true;
 }
 
 Error DirAccessPack::change_dir(String p_dir) {
-	PackedData::PackedDir *pd = _find_dir(p_dir);
-	if (pd) {
-		current = pd;
+	String dir;
+	if (_find_dir(p_dir, dir)) {
+		current = dir;
 		return OK;
 	} else {
 		return ERR_INVALID_PARAMETER;
@@ -515,31 +1160,24 @@ Error DirAccessPack::change_dir(String p_dir) {
 }
 
 String DirAccessPack::get_current_dir(bool p_include_drive) const {
-	PackedData::PackedDir *pd = current;
-	String p = current->name;
-
-	while (pd->parent) {
-		pd = pd->parent;
-		p = pd->name.path_join(p);
-	}
-
-	return "res://" + p;
+	return "res://" + current;
 }
 
 bool DirAccessPack::file_exists(String p_file) {
 	p_file = fix_path(p_file);
 
-	PackedData::PackedDir *pd = _find_dir(p_file.get_base_dir());
-	if (!pd) {
+	String dir;
+	if (!_find_dir(p_file.get_base_dir(), dir)) {
 		return false;
 	}
-	return pd->files.has(p_file.get_file());
+	return PackedData::get_singleton()->_dir_has_file(dir, p_file.get_file());
 }
 
 bool DirAccessPack::dir_exists(String p_dir) {
 	p_dir = fix_path(p_dir);
 
-	return _find_dir(p_dir) != nullptr;
+	String dir;
+	return _find_dir(p_dir, dir);
 }
 
 Error DirAccessPack::make_dir(String p_dir) {
@@ -563,5 +1201,4 @@ String DirAccessPack::get_filesystem_type() const {
 }
 
 DirAccessPack::DirAccessPack() {
-	current = PackedData::get_singleton()->root;
 }
@@ -33,25 +33,39 @@
 
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_map.h"
 
 // Godot's packed file magic header ("GDPC" in ASCII).
 #define PACK_HEADER_MAGIC 0x43504447
 // The current packed file format version number.
-#define PACK_FORMAT_VERSION 2
+#define PACK_FORMAT_VERSION 3
+// The first packed file format version storing its directory as a PackIndex, and compressed files.
+#define PACK_FORMAT_VERSION_INDEX 3
+// The oldest packed file format version that can still be read.
+#define PACK_FORMAT_VERSION_MIN 2
+// Magic header of compressed files stored inside packs ("GDPZ" in ASCII).
+#define PACK_FILE_COMPRESSED_MAGIC "GDPZ"
 
 enum PackFlags {
-	PACK_DIR_ENCRYPTED = 1 << 0
+	PACK_DIR_ENCRYPTED = 1 << 0,
+	// The first reserved header fields hold the offset (relative to the files base, 64 bits) and size (32 bits)
+	// of a Zstandard raw content dictionary shared by all compressed files.
+	PACK_COMPRESSION_DICTIONARY = 1 << 1,
 };
 
 enum PackFileFlags {
-	PACK_FILE_ENCRYPTED = 1 << 0
+	PACK_FILE_ENCRYPTED = 1 << 0,
+	// Stored as a FileAccessCompressed stream, compressed before encryption.
+	PACK_FILE_COMPRESSED = 1 << 1,
 };
 
 class PackSource;
+class PackIndex;
 
 class PackedData {
 	friend class FileAccessPack;
@@ -66,6 +80,8 @@ public:
 		uint8_t md5[16];
 		PackSource *src = nullptr;
 		bool encrypted;
+		bool compressed = false;
+		int64_t priority = 0; // Against files of other packs, see add_index().
 	};
 
 private:
@@ -102,14 +118,31 @@ private:
 
 	PackedDir *root = nullptr;
 
+	// Packs looked up through their own index, by descending priority.
+	LocalVector<PackIndex *> indexes;
+	int64_t priority_top = 0;
+	int64_t priority_bottom = 0;
+
 	static PackedData *singleton;
 	bool disabled = false;
 
+	// Packs opened once for the whole run to share a single memory mapping.
+	Mutex mapped_packs_mutex;
+	HashMap<String, Ref<FileAccess>> mapped_packs;
+
 	void _free_packed_dirs(PackedDir *p_dir);
 
+	bool _find_file(const String &p_path, PackedFile &r_file);
+	PackedDir *_find_packed_dir(const String &p_dir) const;
+	bool _dir_exists(const String &p_dir) const;
+	bool _dir_has_file(const String &p_dir, const String &p_file) const;
+	void _get_dir_contents(const String &p_dir, List<String> *r_dirs, List<String> *r_files) const;
+
 public:
 	void add_pack_source(PackSource *p_source);
-	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false, bool p_compressed = false); // for PackSource
+	// Takes ownership of the index. Its files don't replace those already added unless p_replace_files is set.
+	void add_index(PackIndex *p_index, bool p_replace_files); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -117,6 +150,10 @@ public:
 	static PackedData *get_singleton() { return singleton; }
 	Error add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
 
+	// Read-only view of a whole pack file, or nullptr if it can't be memory mapped.
+	// Unlike FileAccess::get_mapped_buffer(), it stays valid until PackedData is freed.
+	const uint8_t *get_mapped_pack(const String &p_pack_path, uint64_t *r_size = nullptr);
+
 	_FORCE_INLINE_ Ref<FileAccess> try_open_path(const String &p_path);
 	_FORCE_INLINE_ bool has_path(const String &p_path);
 
@@ -127,6 +164,72 @@ public:
 	~PackedData();
 };
 
+// Directory of packs since PACK_FORMAT_VERSION_INDEX. It is sorted when the pack is written, so it's
+// searched in place (memory mapped when possible) instead of being expanded into PackedData's tables.
+// All integers are little endian. Layout:
+// - Header: file count, directory count, directory file list size, string pool size (4 x u32).
+// - Files sorted by path hash then path: path hash (u64), offset from the files base (u64), size (u64),
+//   MD5 (16 bytes), path offset and length in the string pool (2 x u32), PackFileFlags (u32), reserved (u32).
+// - Directories, the root first, then the subdirectories of each directory one after the other, sorted
+//   by name: name offset and length in the string pool, first subdirectory, subdirectory count, first file
+//   in the directory file list, file count (6 x u32).
+// - Directory file list, sorted by name for each directory: file index (u32).
+// - String pool: UTF-8 file paths (as stored, "res://" included) and directory names.
+class PackIndex {
+public:
+	enum {
+		HEADER_SIZE = 16,
+		FILE_ENTRY_SIZE = 56,
+		DIR_ENTRY_SIZE = 24,
+	};
+
+	struct FileInfo {
+		String path;
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		uint8_t md5[16] = {};
+		uint32_t flags = 0;
+	};
+
+private:
+	const uint8_t *data = nullptr;
+	Vector<uint8_t> owned_data; // Used when the pack can't be memory mapped.
+	uint32_t file_count = 0;
+	uint32_t dir_count = 0;
+	uint32_t dir_file_count = 0;
+	uint32_t strings_size = 0;
+
+	const uint8_t *files = nullptr;
+	const uint8_t *dirs = nullptr;
+	const uint8_t *dir_files = nullptr;
+	const uint8_t *strings = nullptr;
+
+	const uint8_t *_get_string(uint32_t p_offset, uint32_t p_length) const;
+	int64_t _find_subdir(uint32_t p_dir, const char32_t *p_name, int p_name_length) const;
+
+public:
+	String pack_path;
+	uint64_t files_base = 0;
+	PackSource *src = nullptr;
+	int64_t priority = 0;
+
+	static uint64_t hash_path(const String &p_path) { return p_path.hash64(); }
+	static uint64_t get_size(const uint8_t *p_header);
+	static Vector<uint8_t> build(const Vector<FileInfo> &p_files);
+
+	// p_data must stay valid as long as the index, unless it's owned.
+	Error init(const uint8_t *p_data, uint64_t p_size);
+	Error init_owned(const Vector<uint8_t> &p_data);
+
+	int64_t find_file(const String &p_path) const;
+	void get_file(uint32_t p_index, PackedData::PackedFile &r_file) const;
+
+	// Directories are relative to "res://", without trailing slash.
+	int64_t find_dir(const String &p_dir) const;
+	bool dir_has_file(uint32_t p_dir, const String &p_file) const;
+	void get_dir_contents(uint32_t p_dir, List<String> *r_dirs, List<String> *r_files) const;
+};
+
 class PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) = 0;
@@ -135,6 +238,9 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	// Compression dictionaries of the packs that have one, by pack path.
+	HashMap<String, Vector<uint8_t>> dictionaries;
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
@@ -147,6 +253,9 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 	uint64_t off;
 
+	mutable const uint8_t *mapped = nullptr;
+	mutable bool map_checked = false;
+
 	Ref<FileAccess> f;
 	virtual Error open_internal(const String &p_path, int p_mode_flags) override;
 	virtual uint64_t _get_modified_time(const String &p_file) override { return 0; }
@@ -166,6 +275,7 @@ public:
 	virtual uint8_t get_8() const override;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_mapped_buffer() const override;
 
 	virtual void set_big_endian(bool p_big_endian) override;
 
@@ -182,20 +292,24 @@ public:
 };
 
 Ref<FileAccess> PackedData::try_open_path(const String &p_path) {
-	PathMD5 pmd5(p_path.md5_buffer());
-	HashMap<PathMD5, PackedFile, PathMD5>::Iterator E = files.find(pmd5);
-	if (!E) {
-		return nullptr; //not found
-	}
-	if (E->value.offset == 0) {
-		return nullptr; //was erased
+	PackedFile pf;
+	if (!_find_file(p_path, pf)) {
+		return nullptr; //not found or erased
 	}
 
-	return E->value.src->get_file(p_path, &E->value);
+	return pf.src->get_file(p_path, &pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
-	return files.has(PathMD5(p_path.md5_buffer()));
+	if (!files.is_empty() && files.has(PathMD5(p_path.md5_buffer()))) {
+		return true;
+	}
+	for (const PackIndex *index : indexes) {
+		if (index->find_file(p_path) != -1) {
+			return true;
+		}
+	}
+	return false;
 }
 
 bool PackedData::has_directory(const String &p_path) {
@@ -208,13 +322,13 @@ bool PackedData::has_directory(const String &p_path) {
 }
 
 class DirAccessPack : public DirAccess {
-	PackedData::PackedDir *current;
+	String current; // Relative to "res://".
 
 	List<String> list_dirs;
 	List<String> list_files;
 	bool cdir = false;
 
-	PackedData::PackedDir *_find_dir(String p_dir);
+	bool _find_dir(String p_dir, String &r_dir) const;
 
 public:
 	virtual Error list_dir_begin() override;
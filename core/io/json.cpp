@@ -31,6 +31,7 @@
 #include "json.h"
 
 #include "core/config/engine.h"
+#include "core/io/json_stream.h"
 #include "core/string/print_string.h"
 
 const char *JSON::tk_name[TK_MAX] = {
@@ -602,20 +603,41 @@ Ref<Resource> ResourceFormatLoaderJSON::load(const String &p_path, const String
 	Ref<JSON> json;
 	json.instantiate();
 
-	Error err = json->parse(FileAccess::get_file_as_string(p_path), Engine::get_singleton()->is_editor_hint());
-	if (err != OK) {
-		String err_text = "Error parsing JSON file at '" + p_path + "', on line " + itos(json->get_error_line()) + ": " + json->get_error_message();
+	if (!Engine::get_singleton()->is_editor_hint()) {
+		// The text isn't kept outside of the editor, so parse the UTF-8 bytes
+		// as they are read instead of decoding the whole file to a String.
+		Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+		if (f.is_null()) {
+			return Ref<Resource>();
+		}
 
-		if (Engine::get_singleton()->is_editor_hint()) {
-			// If running on editor, still allow opening the JSON so the code editor can edit it.
-			WARN_PRINT(err_text);
-		} else {
+		Ref<JSONReader> reader;
+		reader.instantiate();
+		reader->open_file(f);
+		JSONReader::Token token = reader->read_value();
+		Variant data = reader->get_value();
+		if (token == JSONReader::TOKEN_VALUE) {
+			token = reader->read();
+		}
+		if (token != JSONReader::TOKEN_END) {
 			if (r_error) {
-				*r_error = err;
+				*r_error = ERR_PARSE_ERROR;
 			}
-			ERR_PRINT(err_text);
+			ERR_PRINT("Error parsing JSON file at '" + p_path + "', on line " + itos(reader->get_error_line()) + ": " + reader->get_error_message());
 			return Ref<Resource>();
 		}
+
+		json->set_data(data);
+		if (r_error) {
+			*r_error = OK;
+		}
+		return json;
+	}
+
+	Error err = json->parse(FileAccess::get_file_as_string(p_path), true);
+	if (err != OK) {
+		// If running on editor, still allow opening the JSON so the code editor can edit it.
+		WARN_PRINT("Error parsing JSON file at '" + p_path + "', on line " + itos(json->get_error_line()) + ": " + json->get_error_message());
 	}
 
 	if (r_error) {
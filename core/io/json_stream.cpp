@@ -0,0 +1,1031 @@
+/**************************************************************************/
+/*  json_stream.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "json_stream.h"
+
+#include "core/string/string_simd.h"
+
+const char *JSONReader::lexeme_name[] = {
+	"'{'",
+	"'}'",
+	"'['",
+	"']'",
+	"':'",
+	"','",
+	"string",
+	"number",
+	"identifier",
+	"EOF",
+};
+
+// Returns the number of bytes written to `r_bytes`, up to 4.
+static _FORCE_INLINE_ int _encode_utf8(char32_t p_char, char *r_bytes) {
+	if (p_char < 0x80) {
+		r_bytes[0] = char(p_char);
+		return 1;
+	} else if (p_char < 0x800) {
+		r_bytes[0] = char(0xc0 | (p_char >> 6));
+		r_bytes[1] = char(0x80 | (p_char & 0x3f));
+		return 2;
+	} else if (p_char < 0x10000) {
+		r_bytes[0] = char(0xe0 | (p_char >> 12));
+		r_bytes[1] = char(0x80 | ((p_char >> 6) & 0x3f));
+		r_bytes[2] = char(0x80 | (p_char & 0x3f));
+		return 3;
+	} else {
+		r_bytes[0] = char(0xf0 | ((p_char >> 18) & 0x07));
+		r_bytes[1] = char(0x80 | ((p_char >> 12) & 0x3f));
+		r_bytes[2] = char(0x80 | ((p_char >> 6) & 0x3f));
+		r_bytes[3] = char(0x80 | (p_char & 0x3f));
+		return 4;
+	}
+}
+
+// Four hex digits as a UTF-16 code unit, or -1.
+static _FORCE_INLINE_ int32_t _parse_hex4(const uint8_t *p_hex) {
+	int32_t res = 0;
+	for (int i = 0; i < 4; i++) {
+		const uint8_t c = p_hex[i];
+		int32_t v;
+		if (is_digit(c)) {
+			v = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			v = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			v = c - 'A' + 10;
+		} else {
+			return -1;
+		}
+		res = (res << 4) | v;
+	}
+	return res;
+}
+
+void JSONReader::_reset() {
+	file.unref();
+	stream.unref();
+	source_data.clear();
+	chunk.clear();
+	source_done = true;
+	bom_checked = false;
+	data = nullptr;
+	data_size = 0;
+	pos = 0;
+	lexeme_start = 0;
+	line = 0;
+	state = STATE_VALUE;
+	containers.clear();
+	build_stack.clear();
+	value = Variant();
+	error_message = String();
+	error_line = 0;
+}
+
+void JSONReader::open_buffer(const Vector<uint8_t> &p_data) {
+	_reset();
+	source_data = p_data;
+	data = source_data.ptr();
+	data_size = source_data.size();
+}
+
+void JSONReader::open_file(const Ref<FileAccess> &p_file) {
+	ERR_FAIL_COND(p_file.is_null());
+	_reset();
+	file = p_file;
+	source_done = false;
+}
+
+void JSONReader::open_stream(const Ref<StreamPeer> &p_stream) {
+	ERR_FAIL_COND(p_stream.is_null());
+	_reset();
+	stream = p_stream;
+	source_done = false;
+}
+
+bool JSONReader::_read_more() {
+	if (source_done) {
+		return false;
+	}
+
+	// Drop the bytes before the current lexeme, which was not completed.
+	if (lexeme_start > 0) {
+		const uint32_t keep = chunk.size() - lexeme_start;
+		memmove(chunk.ptr(), chunk.ptr() + lexeme_start, keep);
+		chunk.resize(keep);
+		pos -= lexeme_start;
+		lexeme_start = 0;
+	}
+
+	const uint32_t old_size = chunk.size();
+	chunk.resize(old_size + READ_CHUNK_SIZE);
+	uint32_t received = 0;
+	if (file.is_valid()) {
+		received = file->get_buffer(chunk.ptr() + old_size, READ_CHUNK_SIZE);
+		if (received < READ_CHUNK_SIZE) {
+			source_done = true;
+		}
+	} else {
+		int partial = 0;
+		if (stream->get_partial_data(chunk.ptr() + old_size, READ_CHUNK_SIZE, partial) != OK) {
+			// Disconnected, the document ends here.
+			source_done = true;
+			partial = 0;
+		}
+		received = partial;
+	}
+	chunk.resize(old_size + received);
+
+	data = chunk.ptr();
+	data_size = chunk.size();
+	return received > 0;
+}
+
+bool JSONReader::_ensure(uint32_t p_size) {
+	while (lexeme_start + p_size > data_size) {
+		if (!_read_more()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+JSONReader::Lexeme JSONReader::_lex_fail(const String &p_message) {
+	error_message = p_message;
+	error_line = line;
+	return LEXEME_ERROR;
+}
+
+JSONReader::Lexeme JSONReader::_lex() {
+	if (!bom_checked) {
+		// Skip the byte order mark, like String::parse_utf8().
+		lexeme_start = pos;
+		if (!_ensure(3) && !source_done) {
+			return LEXEME_NEED_DATA;
+		}
+		if (data_size - pos >= 3 && data[pos] == 0xef && data[pos + 1] == 0xbb && data[pos + 2] == 0xbf) {
+			pos += 3;
+		}
+		bom_checked = true;
+	}
+
+	while (true) {
+		lexeme_start = pos;
+		if (pos == data_size) {
+			if (_read_more()) {
+				continue;
+			}
+			return source_done ? LEXEME_EOF : LEXEME_NEED_DATA;
+		}
+
+		const uint8_t c = data[pos];
+		switch (c) {
+			case '\n': {
+				line++;
+				pos++;
+			} break;
+			case 0: {
+				return LEXEME_EOF;
+			}
+			case '{': {
+				pos++;
+				return LEXEME_OBJECT_BEGIN;
+			}
+			case '}': {
+				pos++;
+				return LEXEME_OBJECT_END;
+			}
+			case '[': {
+				pos++;
+				return LEXEME_ARRAY_BEGIN;
+			}
+			case ']': {
+				pos++;
+				return LEXEME_ARRAY_END;
+			}
+			case ':': {
+				pos++;
+				return LEXEME_COLON;
+			}
+			case ',': {
+				pos++;
+				return LEXEME_COMMA;
+			}
+			case '"': {
+				return _lex_string();
+			}
+			default: {
+				if (c <= 32) {
+					pos++;
+				} else if (c == '-' || is_digit(c)) {
+					return _lex_number();
+				} else if (is_ascii_char(c)) {
+					return _lex_identifier();
+				} else {
+					return _lex_fail("Unexpected character.");
+				}
+			}
+		}
+	}
+}
+
+JSONReader::Lexeme JSONReader::_lex_string() {
+	// Offsets are relative to the start of the lexeme, which stays valid when
+	// more data is read. Only strings with escapes are copied to `string_bytes`.
+	const int start_line = line;
+	uint32_t i = 1;
+	uint32_t run_start = 1;
+	bool escaped = false;
+	string_bytes.clear();
+
+	while (true) {
+		const uint8_t *str = data + lexeme_start;
+		const uint32_t len = data_size - lexeme_start;
+		i += StringSIMD::find_json_string_special((const char *)str + i, len - i);
+		if (i == len) {
+			if (_read_more()) {
+				continue;
+			}
+			if (source_done) {
+				return _lex_fail("Unterminated String");
+			}
+			line = start_line;
+			return LEXEME_NEED_DATA;
+		}
+
+		const uint8_t c = str[i];
+		if (c == '"') {
+			if (escaped) {
+				string_bytes.resize(string_bytes.size() + (i - run_start));
+				memcpy(string_bytes.ptr() + string_bytes.size() - (i - run_start), str + run_start, i - run_start);
+				value = String::utf8(string_bytes.ptr(), string_bytes.size());
+			} else {
+				value = String::utf8((const char *)str + 1, i - 1);
+			}
+			pos = lexeme_start + i + 1;
+			return LEXEME_STRING;
+		} else if (c == '\\') {
+			const uint32_t run_length = i - run_start;
+			if (!_ensure(i + 2)) {
+				if (source_done) {
+					return _lex_fail("Unterminated String");
+				}
+				line = start_line;
+				return LEXEME_NEED_DATA;
+			}
+			str = data + lexeme_start;
+			string_bytes.resize(string_bytes.size() + run_length);
+			memcpy(string_bytes.ptr() + string_bytes.size() - run_length, str + run_start, run_length);
+			escaped = true;
+
+			const uint8_t next = str[i + 1];
+			if (next == 0) {
+				return _lex_fail("Unterminated String");
+			}
+			i += 2;
+			switch (next) {
+				case 'b':
+					string_bytes.push_back(8);
+					break;
+				case 't':
+					string_bytes.push_back(9);
+					break;
+				case 'n':
+					string_bytes.push_back(10);
+					break;
+				case 'f':
+					string_bytes.push_back(12);
+					break;
+				case 'r':
+					string_bytes.push_back(13);
+					break;
+				case 'u': {
+					if (!_ensure(i + 4)) {
+						if (source_done) {
+							return _lex_fail("Unterminated String");
+						}
+						line = start_line;
+						return LEXEME_NEED_DATA;
+					}
+					str = data + lexeme_start;
+					int32_t res = _parse_hex4(str + i);
+					if (res < 0) {
+						return _lex_fail("Malformed hex constant in string");
+					}
+					i += 4;
+
+					if ((res & 0xfffffc00) == 0xd800) {
+						if (!_ensure(i + 6)) {
+							if (source_done) {
+								return _lex_fail("Invalid UTF-16 sequence in string, unpaired lead surrogate");
+							}
+							line = start_line;
+							return LEXEME_NEED_DATA;
+						}
+						str = data + lexeme_start;
+						if (str[i] != '\\' || str[i + 1] != 'u') {
+							return _lex_fail("Invalid UTF-16 sequence in string, unpaired lead surrogate");
+						}
+						const int32_t trail = _parse_hex4(str + i + 2);
+						if (trail < 0) {
+							return _lex_fail("Malformed hex constant in string");
+						}
+						if ((trail & 0xfffffc00) != 0xdc00) {
+							return _lex_fail("Invalid UTF-16 sequence in string, unpaired lead surrogate");
+						}
+						res = (res << 10) + trail - ((0xd800 << 10) + 0xdc00 - 0x10000);
+						i += 6;
+					} else if ((res & 0xfffffc00) == 0xdc00) {
+						return _lex_fail("Invalid UTF-16 sequence in string, unpaired trail surrogate");
+					}
+					char bytes[4];
+					const int count = _encode_utf8(res, bytes);
+					for (int j = 0; j < count; j++) {
+						string_bytes.push_back(bytes[j]);
+					}
+				} break;
+				default: {
+					// Same as JSON::parse(), other escaped characters are kept as is.
+					string_bytes.push_back(char(next));
+				} break;
+			}
+			run_start = i;
+		} else if (c == '\n') {
+			line++;
+			i++;
+		} else if (c == 0) {
+			return _lex_fail("Unterminated String");
+		} else {
+			// Other control characters are accepted in strings.
+			i++;
+		}
+	}
+}
+
+JSONReader::Lexeme JSONReader::_lex_number() {
+	uint32_t i = 0;
+	while (true) {
+		const uint8_t *str = data + lexeme_start;
+		const uint32_t len = data_size - lexeme_start;
+		while (i < len && (is_digit(str[i]) || str[i] == '.' || str[i] == '-' || str[i] == '+' || str[i] == 'e' || str[i] == 'E')) {
+			i++;
+		}
+		if (i < len || !_read_more()) {
+			break;
+		}
+	}
+	if (lexeme_start + i == data_size && !source_done) {
+		// The number may continue in data not received yet.
+		return LEXEME_NEED_DATA;
+	}
+
+	// The source isn't null-terminated, so copy the characters that can be
+	// part of the number and let the conversion stop where the number does.
+	number_chars.resize(i + 1);
+	memcpy(number_chars.ptr(), data + lexeme_start, i);
+	number_chars[i] = 0;
+	const char *end = nullptr;
+	const double number = String::to_float(number_chars.ptr(), &end);
+	if (end == number_chars.ptr()) {
+		return _lex_fail("Unexpected character.");
+	}
+	value = number;
+	pos = lexeme_start + (end - number_chars.ptr());
+	return LEXEME_NUMBER;
+}
+
+JSONReader::Lexeme JSONReader::_lex_identifier() {
+	uint32_t i = 0;
+	while (true) {
+		const uint8_t *str = data + lexeme_start;
+		const uint32_t len = data_size - lexeme_start;
+		while (i < len && is_ascii_char(str[i])) {
+			i++;
+		}
+		if (i < len || !_read_more()) {
+			break;
+		}
+	}
+	if (lexeme_start + i == data_size && !source_done) {
+		return LEXEME_NEED_DATA;
+	}
+
+	// Only kept for the error message when it isn't a valid literal.
+	const char *id = (const char *)data + lexeme_start;
+	identifier = String();
+	if (i == 4 && memcmp(id, "true", 4) == 0) {
+		value = true;
+	} else if (i == 5 && memcmp(id, "false", 5) == 0) {
+		value = false;
+	} else if (i == 4 && memcmp(id, "null", 4) == 0) {
+		value = Variant();
+	} else {
+		identifier = String::utf8(id, i);
+	}
+	pos = lexeme_start + i;
+	return LEXEME_IDENTIFIER;
+}
+
+JSONReader::Token JSONReader::_fail(const String &p_message) {
+	error_message = p_message;
+	error_line = line;
+	state = STATE_ERROR;
+	containers.clear();
+	return TOKEN_ERROR;
+}
+
+void JSONReader::_end_value() {
+	if (containers.is_empty()) {
+		state = STATE_DONE;
+	} else {
+		state = containers[containers.size() - 1] ? STATE_OBJECT_COMMA : STATE_ARRAY_COMMA;
+	}
+}
+
+JSONReader::Token JSONReader::_begin_value(Lexeme p_lexeme) {
+	switch (p_lexeme) {
+		case LEXEME_OBJECT_BEGIN:
+		case LEXEME_ARRAY_BEGIN: {
+			if (containers.size() > Variant::MAX_RECURSION_DEPTH) {
+				return _fail("JSON structure is too deep. Bailing.");
+			}
+			const bool is_object = p_lexeme == LEXEME_OBJECT_BEGIN;
+			containers.push_back(is_object);
+			state = is_object ? STATE_OBJECT_KEY : STATE_ARRAY_VALUE;
+			return is_object ? TOKEN_OBJECT_BEGIN : TOKEN_ARRAY_BEGIN;
+		}
+		case LEXEME_STRING:
+		case LEXEME_NUMBER: {
+			_end_value();
+			return TOKEN_VALUE;
+		}
+		case LEXEME_IDENTIFIER: {
+			if (!identifier.is_empty()) {
+				return _fail("Expected 'true','false' or 'null', got '" + identifier + "'.");
+			}
+			_end_value();
+			return TOKEN_VALUE;
+		}
+		default: {
+			return _fail("Expected value, got " + String(lexeme_name[p_lexeme]) + ".");
+		}
+	}
+}
+
+JSONReader::Token JSONReader::_end_container() {
+	const bool is_object = containers[containers.size() - 1];
+	containers.resize(containers.size() - 1);
+	_end_value();
+	return is_object ? TOKEN_OBJECT_END : TOKEN_ARRAY_END;
+}
+
+JSONReader::Token JSONReader::read() {
+	while (true) {
+		if (state == STATE_ERROR) {
+			return TOKEN_ERROR;
+		}
+		if (state == STATE_END) {
+			return TOKEN_END;
+		}
+		if (state == STATE_DONE && stream.is_valid()) {
+			// Streams may carry several documents, the next read starts the next one.
+			state = STATE_VALUE;
+			return TOKEN_END;
+		}
+
+		const Lexeme lexeme = _lex();
+		if (lexeme == LEXEME_NEED_DATA) {
+			return TOKEN_NEED_DATA;
+		} else if (lexeme == LEXEME_ERROR) {
+			state = STATE_ERROR;
+			containers.clear();
+			return TOKEN_ERROR;
+		} else if (lexeme == LEXEME_EOF) {
+			if (!containers.is_empty()) {
+				return _fail(containers[containers.size() - 1] ? "Expected '}'" : "Expected ']'");
+			}
+			if (state == STATE_DONE || (state == STATE_VALUE && stream.is_valid())) {
+				state = STATE_END;
+				return TOKEN_END;
+			}
+		}
+
+		switch (state) {
+			case STATE_DONE: {
+				return _fail("Expected 'EOF'");
+			}
+			case STATE_ARRAY_COMMA: {
+				if (lexeme == LEXEME_ARRAY_END) {
+					return _end_container();
+				} else if (lexeme != LEXEME_COMMA) {
+					return _fail("Expected ','");
+				}
+				state = STATE_ARRAY_VALUE;
+			} break;
+			case STATE_ARRAY_VALUE: {
+				if (lexeme == LEXEME_ARRAY_END) {
+					return _end_container();
+				}
+				return _begin_value(lexeme);
+			}
+			case STATE_OBJECT_COMMA: {
+				if (lexeme == LEXEME_OBJECT_END) {
+					return _end_container();
+				} else if (lexeme != LEXEME_COMMA) {
+					return _fail("Expected '}' or ','");
+				}
+				state = STATE_OBJECT_KEY;
+			} break;
+			case STATE_OBJECT_KEY: {
+				if (lexeme == LEXEME_OBJECT_END) {
+					return _end_container();
+				} else if (lexeme != LEXEME_STRING) {
+					return _fail("Expected key");
+				}
+				state = STATE_OBJECT_COLON;
+				return TOKEN_KEY;
+			}
+			case STATE_OBJECT_COLON: {
+				if (lexeme != LEXEME_COLON) {
+					return _fail("Expected ':'");
+				}
+				state = STATE_OBJECT_VALUE;
+			} break;
+			default: {
+				return _begin_value(lexeme);
+			}
+		}
+	}
+}
+
+JSONReader::Token JSONReader::read_value() {
+	// Builds containers without recursion. The partially built containers are
+	// kept when more data is needed, so the call can be repeated.
+	while (true) {
+		const Token token = read();
+		switch (token) {
+			case TOKEN_OBJECT_BEGIN:
+			case TOKEN_ARRAY_BEGIN: {
+				BuildFrame frame;
+				frame.is_object = token == TOKEN_OBJECT_BEGIN;
+				if (frame.is_object) {
+					frame.container = Dictionary();
+				} else {
+					frame.container = Array();
+				}
+				build_stack.push_back(frame);
+			} break;
+			case TOKEN_KEY: {
+				if (build_stack.is_empty()) {
+					return token;
+				}
+				build_stack[build_stack.size() - 1].key = value;
+			} break;
+			case TOKEN_OBJECT_END:
+			case TOKEN_ARRAY_END: {
+				if (build_stack.is_empty()) {
+					return token;
+				}
+				value = build_stack[build_stack.size() - 1].container;
+				build_stack.resize(build_stack.size() - 1);
+				if (build_stack.is_empty()) {
+					return TOKEN_VALUE;
+				}
+				[[fallthrough]];
+			}
+			case TOKEN_VALUE: {
+				if (build_stack.is_empty()) {
+					return token;
+				}
+				BuildFrame &parent = build_stack[build_stack.size() - 1];
+				if (parent.is_object) {
+					Dictionary d = parent.container;
+					d[parent.key] = value;
+				} else {
+					Array a = parent.container;
+					a.push_back(value);
+				}
+			} break;
+			case TOKEN_ERROR: {
+				build_stack.clear();
+				return token;
+			}
+			default: {
+				return token;
+			}
+		}
+	}
+}
+
+void JSONReader::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("open_buffer", "data"), &JSONReader::open_buffer);
+	ClassDB::bind_method(D_METHOD("open_file", "file"), &JSONReader::open_file);
+	ClassDB::bind_method(D_METHOD("open_stream", "stream"), &JSONReader::open_stream);
+
+	ClassDB::bind_method(D_METHOD("read"), &JSONReader::read);
+	ClassDB::bind_method(D_METHOD("read_value"), &JSONReader::read_value);
+	ClassDB::bind_method(D_METHOD("get_value"), &JSONReader::get_value);
+	ClassDB::bind_method(D_METHOD("get_depth"), &JSONReader::get_depth);
+	ClassDB::bind_method(D_METHOD("get_error_message"), &JSONReader::get_error_message);
+	ClassDB::bind_method(D_METHOD("get_error_line"), &JSONReader::get_error_line);
+
+	BIND_ENUM_CONSTANT(TOKEN_NEED_DATA);
+	BIND_ENUM_CONSTANT(TOKEN_OBJECT_BEGIN);
+	BIND_ENUM_CONSTANT(TOKEN_OBJECT_END);
+	BIND_ENUM_CONSTANT(TOKEN_ARRAY_BEGIN);
+	BIND_ENUM_CONSTANT(TOKEN_ARRAY_END);
+	BIND_ENUM_CONSTANT(TOKEN_KEY);
+	BIND_ENUM_CONSTANT(TOKEN_VALUE);
+	BIND_ENUM_CONSTANT(TOKEN_END);
+	BIND_ENUM_CONSTANT(TOKEN_ERROR);
+}
+
+////
+
+void JSONWriter::_reset() {
+	flush();
+	file.unref();
+	stream.unref();
+	buffer.clear();
+	error = OK;
+	levels.clear();
+	after_key = false;
+	wrote_value = false;
+}
+
+void JSONWriter::open_buffer() {
+	_reset();
+}
+
+void JSONWriter::open_file(const Ref<FileAccess> &p_file) {
+	ERR_FAIL_COND(p_file.is_null());
+	_reset();
+	file = p_file;
+}
+
+void JSONWriter::open_stream(const Ref<StreamPeer> &p_stream) {
+	ERR_FAIL_COND(p_stream.is_null());
+	_reset();
+	stream = p_stream;
+}
+
+void JSONWriter::set_indent(const String &p_indent) {
+	indent = p_indent;
+	indent_utf8 = p_indent.utf8();
+}
+
+void JSONWriter::_put_indent(int p_depth) {
+	if (indent_utf8.length() == 0) {
+		return;
+	}
+	for (int i = 0; i < p_depth; i++) {
+		_put(indent_utf8.get_data(), indent_utf8.length());
+	}
+}
+
+void JSONWriter::_put_string(const String &p_string) {
+	const char32_t *str = p_string.ptr();
+	const int len = p_string.length();
+
+	_put('"');
+	int i = 0;
+	while (i < len) {
+		const int plain = StringSIMD::json_plain_prefix_length(str + i, len - i);
+		if (plain > 0) {
+			const uint32_t size = buffer.size();
+			buffer.resize(size + plain);
+			StringSIMD::narrow_ascii((char *)buffer.ptr() + size, str + i, plain);
+			i += plain;
+			if (i == len) {
+				break;
+			}
+		}
+
+		const char32_t c = str[i++];
+		switch (c) {
+			case '"':
+				_put("\\\"", 2);
+				break;
+			case '\\':
+				_put("\\\\", 2);
+				break;
+			case '\b':
+				_put("\\b", 2);
+				break;
+			case '\f':
+				_put("\\f", 2);
+				break;
+			case '\n':
+				_put("\\n", 2);
+				break;
+			case '\r':
+				_put("\\r", 2);
+				break;
+			case '\t':
+				_put("\\t", 2);
+				break;
+			default: {
+				if (c < 0x20) {
+					static const char hex[] = "0123456789abcdef";
+					const char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+					_put(escape, 6);
+				} else {
+					char bytes[4];
+					_put(bytes, _encode_utf8(c, bytes));
+				}
+			} break;
+		}
+	}
+	_put('"');
+}
+
+bool JSONWriter::_begin_item() {
+	if (after_key) {
+		after_key = false;
+		return true;
+	}
+	if (levels.is_empty()) {
+		// Documents written one after another are separated by new lines.
+		if (wrote_value) {
+			_put('\n');
+		}
+		return true;
+	}
+
+	Level &level = levels[levels.size() - 1];
+	ERR_FAIL_COND_V_MSG(level.is_object, false, "Expected a key before a value in a JSON object.");
+	if (!level.empty) {
+		_put(',');
+		if (!indent.is_empty()) {
+			_put('\n');
+		}
+	}
+	level.empty = false;
+	_put_indent(levels.size());
+	return true;
+}
+
+void JSONWriter::_end_item() {
+	if (levels.is_empty()) {
+		wrote_value = true;
+	}
+	if (buffer.size() >= FLUSH_SIZE) {
+		flush();
+	}
+}
+
+void JSONWriter::_put_variant(const Variant &p_var, HashSet<const void *> &p_markers) {
+	switch (p_var.get_type()) {
+		case Variant::NIL: {
+			_put("null", 4);
+		} break;
+		case Variant::BOOL: {
+			if (p_var.operator bool()) {
+				_put("true", 4);
+			} else {
+				_put("false", 5);
+			}
+		} break;
+		case Variant::INT: {
+			const int64_t num = p_var;
+			uint64_t magnitude = num < 0 ? uint64_t(0) - uint64_t(num) : uint64_t(num);
+			char digits[20];
+			int count = 0;
+			do {
+				digits[count++] = '0' + magnitude % 10;
+				magnitude /= 10;
+			} while (magnitude);
+			if (num < 0) {
+				_put('-');
+			}
+			while (count > 0) {
+				_put(digits[--count]);
+			}
+		} break;
+		case Variant::FLOAT: {
+			// Same digits as JSON::stringify().
+			const double num = p_var;
+			const CharString text = String::num(num, (full_precision ? 17 : 14) - (int)floor(log10(num))).utf8();
+			_put(text.get_data(), text.length());
+		} break;
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY:
+		case Variant::PACKED_STRING_ARRAY:
+		case Variant::ARRAY: {
+			Array a = p_var;
+			if (p_markers.has(a.id())) {
+				_put("\"[...]\"", 7);
+				ERR_FAIL_MSG("Converting circular structure to JSON.");
+			}
+			if (levels.size() > Variant::MAX_RECURSION_DEPTH) {
+				_put("null", 4);
+				ERR_FAIL_MSG("JSON structure is too deep. Bailing.");
+			}
+			p_markers.insert(a.id());
+
+			_open(false);
+			for (int i = 0; i < a.size(); i++) {
+				_begin_item();
+				_put_variant(a[i], p_markers);
+				_end_item();
+			}
+			_close();
+
+			p_markers.erase(a.id());
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary d = p_var;
+			if (p_markers.has(d.id())) {
+				_put("\"{...}\"", 7);
+				ERR_FAIL_MSG("Converting circular structure to JSON.");
+			}
+			if (levels.size() > Variant::MAX_RECURSION_DEPTH) {
+				_put("null", 4);
+				ERR_FAIL_MSG("JSON structure is too deep. Bailing.");
+			}
+			p_markers.insert(d.id());
+
+			List<Variant> keys;
+			d.get_key_list(&keys);
+			if (sort_keys) {
+				keys.sort();
+			}
+
+			_open(true);
+			for (const Variant &E : keys) {
+				_put_key(E);
+				_put_variant(d[E], p_markers);
+				_end_item();
+			}
+			_close();
+
+			p_markers.erase(d.id());
+		} break;
+		default: {
+			_put_string(p_var);
+		} break;
+	}
+}
+
+void JSONWriter::_open(bool p_object) {
+	_put(p_object ? '{' : '[');
+	if (!indent.is_empty()) {
+		_put('\n');
+	}
+	Level level;
+	level.is_object = p_object;
+	levels.push_back(level);
+}
+
+void JSONWriter::_close() {
+	const bool is_object = levels[levels.size() - 1].is_object;
+	levels.resize(levels.size() - 1);
+	if (!indent.is_empty()) {
+		_put('\n');
+	}
+	_put_indent(levels.size());
+	_put(is_object ? '}' : ']');
+}
+
+void JSONWriter::_put_key(const String &p_key) {
+	Level &level = levels[levels.size() - 1];
+	if (!level.empty) {
+		_put(',');
+		if (!indent.is_empty()) {
+			_put('\n');
+		}
+	}
+	level.empty = false;
+	_put_indent(levels.size());
+	_put_string(p_key);
+	_put(':');
+	if (!indent.is_empty()) {
+		_put(' ');
+	}
+}
+
+void JSONWriter::begin_object() {
+	if (_begin_item()) {
+		_open(true);
+	}
+}
+
+void JSONWriter::end_object() {
+	ERR_FAIL_COND_MSG(levels.is_empty() || !levels[levels.size() - 1].is_object, "No JSON object to end.");
+	ERR_FAIL_COND_MSG(after_key, "Expected a value after the key.");
+	_close();
+	_end_item();
+}
+
+void JSONWriter::begin_array() {
+	if (_begin_item()) {
+		_open(false);
+	}
+}
+
+void JSONWriter::end_array() {
+	ERR_FAIL_COND_MSG(levels.is_empty() || levels[levels.size() - 1].is_object, "No JSON array to end.");
+	_close();
+	_end_item();
+}
+
+void JSONWriter::write_key(const String &p_key) {
+	ERR_FAIL_COND_MSG(levels.is_empty() || !levels[levels.size() - 1].is_object, "Keys can only be written in JSON objects.");
+	ERR_FAIL_COND_MSG(after_key, "Expected a value after the previous key.");
+	_put_key(p_key);
+	after_key = true;
+}
+
+void JSONWriter::write_value(const Variant &p_value) {
+	if (!_begin_item()) {
+		return;
+	}
+	HashSet<const void *> markers;
+	_put_variant(p_value, markers);
+	_end_item();
+}
+
+Error JSONWriter::flush() {
+	if (buffer.is_empty() || (file.is_null() && stream.is_null())) {
+		return error;
+	}
+	if (file.is_valid()) {
+		file->store_buffer(buffer.ptr(), buffer.size());
+	} else {
+		Error err = stream->put_data(buffer.ptr(), buffer.size());
+		if (err != OK) {
+			error = err;
+		}
+	}
+	buffer.clear();
+	return error;
+}
+
+Vector<uint8_t> JSONWriter::get_data() const {
+	Vector<uint8_t> ret;
+	ret.resize(buffer.size());
+	if (buffer.size()) {
+		memcpy(ret.ptrw(), buffer.ptr(), buffer.size());
+	}
+	return ret;
+}
+
+void JSONWriter::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("open_buffer"), &JSONWriter::open_buffer);
+	ClassDB::bind_method(D_METHOD("open_file", "file"), &JSONWriter::open_file);
+	ClassDB::bind_method(D_METHOD("open_stream", "stream"), &JSONWriter::open_stream);
+
+	ClassDB::bind_method(D_METHOD("set_indent", "indent"), &JSONWriter::set_indent);
+	ClassDB::bind_method(D_METHOD("get_indent"), &JSONWriter::get_indent);
+	ClassDB::bind_method(D_METHOD("set_sort_keys", "enabled"), &JSONWriter::set_sort_keys);
+	ClassDB::bind_method(D_METHOD("is_sort_keys"), &JSONWriter::is_sort_keys);
+	ClassDB::bind_method(D_METHOD("set_full_precision", "enabled"), &JSONWriter::set_full_precision);
+	ClassDB::bind_method(D_METHOD("is_full_precision"), &JSONWriter::is_full_precision);
+
+	ClassDB::bind_method(D_METHOD("begin_object"), &JSONWriter::begin_object);
+	ClassDB::bind_method(D_METHOD("end_object"), &JSONWriter::end_object);
+	ClassDB::bind_method(D_METHOD("begin_array"), &JSONWriter::begin_array);
+	ClassDB::bind_method(D_METHOD("end_array"), &JSONWriter::end_array);
+	ClassDB::bind_method(D_METHOD("write_key", "key"), &JSONWriter::write_key);
+	ClassDB::bind_method(D_METHOD("write_value", "value"), &JSONWriter::write_value);
+
+	ClassDB::bind_method(D_METHOD("flush"), &JSONWriter::flush);
+	ClassDB::bind_method(D_METHOD("get_data"), &JSONWriter::get_data);
+	ClassDB::bind_method(D_METHOD("get_depth"), &JSONWriter::get_depth);
+
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "indent"), "set_indent", "get_indent");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "sort_keys"), "set_sort_keys", "is_sort_keys");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "full_precision"), "set_full_precision", "is_full_precision");
+}
+
+JSONWriter::~JSONWriter() {
+	flush();
+}
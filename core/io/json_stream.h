@@ -0,0 +1,235 @@
+/**************************************************************************/
+/*  json_stream.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include "core/io/file_access.h"
+#include "core/io/stream_peer.h"
+#include "core/object/ref_counted.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+
+// Pull parser for UTF-8 JSON, reading from a byte buffer, a file or a stream
+// peer without decoding the whole document to a String first. Accepts the
+// same documents as JSON::parse() and produces the same values.
+class JSONReader : public RefCounted {
+	GDCLASS(JSONReader, RefCounted);
+
+public:
+	enum Token {
+		TOKEN_NEED_DATA,
+		TOKEN_OBJECT_BEGIN,
+		TOKEN_OBJECT_END,
+		TOKEN_ARRAY_BEGIN,
+		TOKEN_ARRAY_END,
+		TOKEN_KEY,
+		TOKEN_VALUE,
+		TOKEN_END,
+		TOKEN_ERROR,
+	};
+
+private:
+	enum {
+		READ_CHUNK_SIZE = 64 * 1024,
+	};
+
+	enum Lexeme {
+		LEXEME_OBJECT_BEGIN,
+		LEXEME_OBJECT_END,
+		LEXEME_ARRAY_BEGIN,
+		LEXEME_ARRAY_END,
+		LEXEME_COLON,
+		LEXEME_COMMA,
+		LEXEME_STRING,
+		LEXEME_NUMBER,
+		LEXEME_IDENTIFIER,
+		LEXEME_EOF,
+		LEXEME_NEED_DATA,
+		LEXEME_ERROR,
+	};
+
+	enum State {
+		STATE_VALUE,
+		STATE_ARRAY_VALUE,
+		STATE_ARRAY_COMMA,
+		STATE_OBJECT_KEY,
+		STATE_OBJECT_COLON,
+		STATE_OBJECT_VALUE,
+		STATE_OBJECT_COMMA,
+		STATE_DONE,
+		STATE_END,
+		STATE_ERROR,
+	};
+
+	// Containers being built by read_value().
+	struct BuildFrame {
+		bool is_object = false;
+		Variant container;
+		String key;
+	};
+
+	static const char *lexeme_name[];
+
+	Ref<FileAccess> file;
+	Ref<StreamPeer> stream;
+	Vector<uint8_t> source_data;
+	// Bytes read from the file or stream. Only the current lexeme and what
+	// follows it are kept.
+	LocalVector<uint8_t> chunk;
+	bool source_done = true;
+	bool bom_checked = false;
+
+	const uint8_t *data = nullptr;
+	uint32_t data_size = 0;
+	uint32_t pos = 0;
+	uint32_t lexeme_start = 0;
+	int line = 0;
+
+	State state = STATE_VALUE;
+	LocalVector<bool> containers; // True for objects.
+	LocalVector<BuildFrame> build_stack;
+	LocalVector<char> string_bytes;
+	LocalVector<char> number_chars;
+	String identifier;
+	Variant value;
+
+	String error_message;
+	int error_line = 0;
+
+	void _reset();
+	bool _read_more();
+	bool _ensure(uint32_t p_size);
+	Lexeme _lex();
+	Lexeme _lex_string();
+	Lexeme _lex_number();
+	Lexeme _lex_identifier();
+	Lexeme _lex_fail(const String &p_message);
+	Token _fail(const String &p_message);
+	Token _begin_value(Lexeme p_lexeme);
+	Token _end_container();
+	void _end_value();
+
+protected:
+	static void _bind_methods();
+
+public:
+	void open_buffer(const Vector<uint8_t> &p_data);
+	void open_file(const Ref<FileAccess> &p_file);
+	void open_stream(const Ref<StreamPeer> &p_stream);
+
+	Token read();
+	Token read_value();
+
+	Variant get_value() const { return value; }
+	int get_depth() const { return containers.size(); }
+	String get_error_message() const { return error_message; }
+	int get_error_line() const { return error_line; }
+};
+
+// Writes JSON as UTF-8 to a byte buffer, a file or a stream peer, formatted
+// like JSON::stringify(). Output is flushed in chunks, so large documents can
+// be written piece by piece without building them as a single String.
+class JSONWriter : public RefCounted {
+	GDCLASS(JSONWriter, RefCounted);
+
+	enum {
+		FLUSH_SIZE = 64 * 1024,
+	};
+
+	struct Level {
+		bool is_object = false;
+		bool empty = true;
+	};
+
+	Ref<FileAccess> file;
+	Ref<StreamPeer> stream;
+	LocalVector<uint8_t> buffer;
+	Error error = OK;
+
+	String indent;
+	CharString indent_utf8;
+	bool sort_keys = true;
+	bool full_precision = false;
+
+	LocalVector<Level> levels;
+	bool after_key = false;
+	bool wrote_value = false;
+
+	void _reset();
+	_FORCE_INLINE_ void _put(const char *p_data, uint32_t p_len) {
+		const uint32_t size = buffer.size();
+		buffer.resize(size + p_len);
+		memcpy(buffer.ptr() + size, p_data, p_len);
+	}
+	_FORCE_INLINE_ void _put(char p_char) {
+		buffer.push_back(p_char);
+	}
+	void _put_indent(int p_depth);
+	void _put_string(const String &p_string);
+	void _put_key(const String &p_key);
+	void _put_variant(const Variant &p_var, HashSet<const void *> &p_markers);
+	bool _begin_item();
+	void _end_item();
+	void _open(bool p_object);
+	void _close();
+
+protected:
+	static void _bind_methods();
+
+public:
+	void open_buffer();
+	void open_file(const Ref<FileAccess> &p_file);
+	void open_stream(const Ref<StreamPeer> &p_stream);
+
+	void set_indent(const String &p_indent);
+	String get_indent() const { return indent; }
+	void set_sort_keys(bool p_sort_keys) { sort_keys = p_sort_keys; }
+	bool is_sort_keys() const { return sort_keys; }
+	void set_full_precision(bool p_full_precision) { full_precision = p_full_precision; }
+	bool is_full_precision() const { return full_precision; }
+
+	void begin_object();
+	void end_object();
+	void begin_array();
+	void end_array();
+	void write_key(const String &p_key);
+	void write_value(const Variant &p_value);
+
+	Error flush();
+	Vector<uint8_t> get_data() const;
+	int get_depth() const { return levels.size(); }
+
+	~JSONWriter();
+};
+
+VARIANT_ENUM_CAST(JSONReader::Token);
+
+#endif // JSON_STREAM_H
@@ -59,6 +59,9 @@ ObjectID EncodedObjectAsID::get_object_id() const {
 #define ENCODE_FLAG_64 1 << 16
 #define ENCODE_FLAG_OBJECT_AS_ID 1 << 16
 
+// First byte of the compact encoding, see encode_variant_compact().
+#define COMPACT_MARKER 0xFE
+
 static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r_string) {
 	ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
 
@@ -99,6 +102,10 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 	const uint8_t *buf = p_buffer;
 	int len = p_len;
 
+	if (p_depth == 0 && len >= 1 && buf[0] == COMPACT_MARKER) {
+		return decode_variant_compact(r_variant, buf, len, r_len, p_allow_objects);
+	}
+
 	ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
 
 	uint32_t type = decode_uint32(buf);
@@ -1814,6 +1821,900 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 	return OK;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Compact encoding.
+//
+// Starts with COMPACT_MARKER, which can't be the first byte of the encoding
+// above since it's larger than any type, followed by the format version.
+// Each value is then a tag byte holding the type in the low 6 bits and a
+// mode in the high 2 bits, followed by its payload:
+// - Integers and the components of integer vectors are zigzag varints.
+// - Floats use the smallest of varint (integral values), 32 or 64 bits that
+//   is exact.
+// - Strings and string names are string table items, see `put_string()`.
+// - Typed arrays store the element type once, and most elements without tag.
+// - Packed float, vector and color arrays can be quantized with flags.
+// - Other types (node paths, objects, RIDs, callables and signals) embed the
+//   regular encoding.
+
+#define COMPACT_VERSION 1
+#define COMPACT_TYPE_MASK 0x3F
+#define COMPACT_MODE_SHIFT 6
+
+// Modes for floats.
+#define COMPACT_FLOAT_64 0
+#define COMPACT_FLOAT_32 1
+#define COMPACT_FLOAT_INTEGRAL 2
+
+// Modes for the components of math types and packed arrays.
+#define COMPACT_COMPONENTS_32 0
+#define COMPACT_COMPONENTS_64 1
+#define COMPACT_COMPONENTS_HALF 2
+
+// Modes for arrays.
+#define COMPACT_ARRAY_TYPED 1
+
+// Longer strings are not added to the string table, they rarely repeat.
+#define COMPACT_MAX_INTERNED_LENGTH 128
+
+static int _compact_real_count(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::VECTOR2:
+			return 2;
+		case Variant::VECTOR3:
+			return 3;
+		case Variant::RECT2:
+		case Variant::VECTOR4:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+			return 4;
+		case Variant::TRANSFORM2D:
+		case Variant::AABB:
+			return 6;
+		case Variant::BASIS:
+			return 9;
+		case Variant::TRANSFORM3D:
+			return 12;
+		case Variant::PROJECTION:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+static int _compact_int_count(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::VECTOR2I:
+			return 2;
+		case Variant::VECTOR3I:
+			return 3;
+		case Variant::RECT2I:
+		case Variant::VECTOR4I:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+// Math types are stored as their components, in memory order.
+template <typename T, typename C>
+static _FORCE_INLINE_ void _get_components(const Variant &p_variant, C *r_components) {
+	static_assert(sizeof(T) % sizeof(C) == 0, "Type must only contain components.");
+	const T value = p_variant;
+	memcpy(r_components, (const void *)&value, sizeof(T));
+}
+
+template <typename T, typename C>
+static _FORCE_INLINE_ Variant _from_components(const C *p_components) {
+	T value;
+	memcpy((void *)&value, p_components, sizeof(T));
+	return value;
+}
+
+static void _get_compact_components(const Variant &p_variant, real_t *r_reals, int32_t *r_ints) {
+	switch (p_variant.get_type()) {
+		case Variant::VECTOR2:
+			_get_components<Vector2>(p_variant, r_reals);
+			break;
+		case Variant::VECTOR3:
+			_get_components<Vector3>(p_variant, r_reals);
+			break;
+		case Variant::RECT2:
+			_get_components<Rect2>(p_variant, r_reals);
+			break;
+		case Variant::VECTOR4:
+			_get_components<Vector4>(p_variant, r_reals);
+			break;
+		case Variant::PLANE:
+			_get_components<Plane>(p_variant, r_reals);
+			break;
+		case Variant::QUATERNION:
+			_get_components<Quaternion>(p_variant, r_reals);
+			break;
+		case Variant::TRANSFORM2D:
+			_get_components<Transform2D>(p_variant, r_reals);
+			break;
+		case Variant::AABB:
+			_get_components<AABB>(p_variant, r_reals);
+			break;
+		case Variant::BASIS:
+			_get_components<Basis>(p_variant, r_reals);
+			break;
+		case Variant::TRANSFORM3D:
+			_get_components<Transform3D>(p_variant, r_reals);
+			break;
+		case Variant::PROJECTION:
+			_get_components<Projection>(p_variant, r_reals);
+			break;
+		case Variant::VECTOR2I:
+			_get_components<Vector2i>(p_variant, r_ints);
+			break;
+		case Variant::VECTOR3I:
+			_get_components<Vector3i>(p_variant, r_ints);
+			break;
+		case Variant::RECT2I:
+			_get_components<Rect2i>(p_variant, r_ints);
+			break;
+		case Variant::VECTOR4I:
+			_get_components<Vector4i>(p_variant, r_ints);
+			break;
+		default:
+			break;
+	}
+}
+
+static Variant _make_from_compact_components(Variant::Type p_type, const real_t *p_reals, const int32_t *p_ints) {
+	switch (p_type) {
+		case Variant::VECTOR2:
+			return _from_components<Vector2>(p_reals);
+		case Variant::VECTOR3:
+			return _from_components<Vector3>(p_reals);
+		case Variant::RECT2:
+			return _from_components<Rect2>(p_reals);
+		case Variant::VECTOR4:
+			return _from_components<Vector4>(p_reals);
+		case Variant::PLANE:
+			return _from_components<Plane>(p_reals);
+		case Variant::QUATERNION:
+			return _from_components<Quaternion>(p_reals);
+		case Variant::TRANSFORM2D:
+			return _from_components<Transform2D>(p_reals);
+		case Variant::AABB:
+			return _from_components<AABB>(p_reals);
+		case Variant::BASIS:
+			return _from_components<Basis>(p_reals);
+		case Variant::TRANSFORM3D:
+			return _from_components<Transform3D>(p_reals);
+		case Variant::PROJECTION:
+			return _from_components<Projection>(p_reals);
+		case Variant::VECTOR2I:
+			return _from_components<Vector2i>(p_ints);
+		case Variant::VECTOR3I:
+			return _from_components<Vector3i>(p_ints);
+		case Variant::RECT2I:
+			return _from_components<Rect2i>(p_ints);
+		case Variant::VECTOR4I:
+			return _from_components<Vector4i>(p_ints);
+		default:
+			return Variant();
+	}
+}
+
+// Elements of typed arrays of these types are stored without tag.
+static bool _is_compact_untagged(Variant::Type p_type) {
+	return p_type == Variant::INT || p_type == Variant::FLOAT || p_type == Variant::STRING || p_type == Variant::STRING_NAME || p_type == Variant::COLOR || _compact_real_count(p_type) || _compact_int_count(p_type);
+}
+
+// Integral values below 2^53 are stored exactly as varints, except -0.0.
+static _FORCE_INLINE_ bool _is_compact_integral(double p_value) {
+	return p_value == Math::floor(p_value) && Math::abs(p_value) < 9007199254740992.0 && !(p_value == 0.0 && std::signbit(p_value));
+}
+
+static uint8_t _get_compact_float_mode(double p_value) {
+	if (_is_compact_integral(p_value)) {
+		return COMPACT_FLOAT_INTEGRAL;
+	}
+	if (double(float(p_value)) == p_value) {
+		return COMPACT_FLOAT_32;
+	}
+	return COMPACT_FLOAT_64;
+}
+
+// Mode of packed arrays of 32-bit and 64-bit floats.
+static uint8_t _get_compact_components_mode(bool p_64_bits, uint32_t p_flags) {
+	if (p_flags & ENCODE_COMPACT_HALF_FLOATS) {
+		return COMPACT_COMPONENTS_HALF;
+	}
+	return (p_64_bits && !(p_flags & ENCODE_COMPACT_FLOAT32)) ? COMPACT_COMPONENTS_64 : COMPACT_COMPONENTS_32;
+}
+
+struct CompactVariantEncoder {
+	uint8_t *buf = nullptr; // Only measures the length when null.
+	int len = 0;
+	bool full_objects = false;
+	uint32_t flags = 0;
+	HashMap<String, uint32_t> strings;
+
+	_FORCE_INLINE_ void put_byte(uint8_t p_byte) {
+		if (buf) {
+			buf[len] = p_byte;
+		}
+		len++;
+	}
+
+	_FORCE_INLINE_ void put_bytes(const uint8_t *p_bytes, int p_count) {
+		if (buf && p_count) {
+			memcpy(buf + len, p_bytes, p_count);
+		}
+		len += p_count;
+	}
+
+	_FORCE_INLINE_ void put_varint(uint64_t p_value) {
+		while (p_value >= 0x80) {
+			put_byte(uint8_t(p_value) | 0x80);
+			p_value >>= 7;
+		}
+		put_byte(uint8_t(p_value));
+	}
+
+	_FORCE_INLINE_ void put_zigzag(int64_t p_value) {
+		put_varint((uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63));
+	}
+
+	_FORCE_INLINE_ void put_component(double p_value, uint8_t p_mode) {
+		if (p_mode == COMPACT_COMPONENTS_HALF) {
+			if (buf) {
+				encode_uint16(Math::make_half_float(p_value), buf + len);
+			}
+			len += 2;
+		} else if (p_mode == COMPACT_COMPONENTS_64) {
+			if (buf) {
+				encode_double(p_value, buf + len);
+			}
+			len += 8;
+		} else {
+			if (buf) {
+				encode_float(p_value, buf + len);
+			}
+			len += 4;
+		}
+	}
+
+	void put_float(double p_value, uint8_t p_mode) {
+		if (p_mode == COMPACT_FLOAT_INTEGRAL) {
+			put_zigzag(int64_t(p_value));
+		} else {
+			put_component(p_value, p_mode == COMPACT_FLOAT_64 ? COMPACT_COMPONENTS_64 : COMPACT_COMPONENTS_32);
+		}
+	}
+
+	// Strings are written once, and referenced by their index in the table
+	// afterwards. The item is `length << 1` followed by the UTF-8 bytes for
+	// new strings, or `index << 1 | 1` for strings already in the table.
+	void put_string(const String &p_string) {
+		const uint32_t *index = strings.getptr(p_string);
+		if (index) {
+			put_varint((uint64_t(*index) << 1) | 1);
+			return;
+		}
+		const CharString utf8 = p_string.utf8();
+		put_varint(uint64_t(utf8.length()) << 1);
+		put_bytes((const uint8_t *)utf8.get_data(), utf8.length());
+		if (utf8.length() <= COMPACT_MAX_INTERNED_LENGTH) {
+			strings.insert(p_string, strings.size());
+		}
+	}
+
+	uint8_t get_mode(const Variant &p_variant) const {
+		switch (p_variant.get_type()) {
+			case Variant::BOOL:
+				return p_variant.operator bool() ? 1 : 0;
+			case Variant::FLOAT:
+				return _get_compact_float_mode(p_variant);
+			case Variant::ARRAY: {
+				const Array array = p_variant;
+				const uint32_t type = array.get_typed_builtin();
+				return (type != Variant::NIL && type != Variant::OBJECT) ? COMPACT_ARRAY_TYPED : 0;
+			}
+			case Variant::PACKED_FLOAT32_ARRAY:
+			case Variant::PACKED_COLOR_ARRAY:
+				return _get_compact_components_mode(false, flags);
+			case Variant::PACKED_FLOAT64_ARRAY:
+				return _get_compact_components_mode(true, flags);
+			case Variant::PACKED_VECTOR2_ARRAY:
+			case Variant::PACKED_VECTOR3_ARRAY:
+				return _get_compact_components_mode(sizeof(real_t) == 8, flags);
+			default:
+				return _compact_real_count(p_variant.get_type()) && sizeof(real_t) == 8 ? COMPACT_COMPONENTS_64 : 0;
+		}
+	}
+
+	Error put_variant(const Variant &p_variant, int p_depth) {
+		const uint8_t mode = get_mode(p_variant);
+		put_byte(p_variant.get_type() | (mode << COMPACT_MODE_SHIFT));
+		return put_payload(p_variant, mode, p_depth);
+	}
+
+	Error put_payload(const Variant &p_variant, uint8_t p_mode, int p_depth) {
+		ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Potential infinite recursion detected. Bailing.");
+
+		const Variant::Type type = p_variant.get_type();
+		switch (type) {
+			case Variant::NIL:
+			case Variant::BOOL: {
+				// Stored in the mode.
+			} break;
+			case Variant::INT: {
+				put_zigzag(p_variant);
+			} break;
+			case Variant::FLOAT: {
+				put_float(p_variant, p_mode);
+			} break;
+			case Variant::STRING: {
+				put_string(p_variant);
+			} break;
+			case Variant::STRING_NAME: {
+				put_string(String(p_variant.operator StringName()));
+			} break;
+			case Variant::COLOR: {
+				const Color color = p_variant;
+				for (int i = 0; i < 4; i++) {
+					put_component(color.components[i], COMPACT_COMPONENTS_32);
+				}
+			} break;
+			case Variant::DICTIONARY: {
+				const Dictionary d = p_variant;
+				List<Variant> keys;
+				d.get_key_list(&keys);
+				put_varint(keys.size());
+				for (const Variant &E : keys) {
+					Error err = put_variant(E, p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+					err = put_variant(d[E], p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+				}
+			} break;
+			case Variant::ARRAY: {
+				const Array array = p_variant;
+				if (p_mode != COMPACT_ARRAY_TYPED) {
+					put_varint(array.size());
+					for (int i = 0; i < array.size(); i++) {
+						Error err = put_variant(array[i], p_depth + 1);
+						ERR_FAIL_COND_V(err != OK, err);
+					}
+					break;
+				}
+
+				const Variant::Type element_type = Variant::Type(array.get_typed_builtin());
+				const bool untagged = _is_compact_untagged(element_type);
+				uint8_t element_mode = 0;
+				if (element_type == Variant::FLOAT) {
+					// The smallest mode that is exact for all elements.
+					bool integral = true;
+					bool float32 = true;
+					for (int i = 0; i < array.size() && (integral || float32); i++) {
+						const double value = array[i];
+						integral = integral && _is_compact_integral(value);
+						float32 = float32 && double(float(value)) == value;
+					}
+					element_mode = integral ? COMPACT_FLOAT_INTEGRAL : (float32 ? COMPACT_FLOAT_32 : COMPACT_FLOAT_64);
+				} else if (_compact_real_count(element_type) && sizeof(real_t) == 8) {
+					element_mode = COMPACT_COMPONENTS_64;
+				}
+				put_varint(element_type);
+				put_byte(element_mode);
+				put_varint(array.size());
+				for (int i = 0; i < array.size(); i++) {
+					Error err = untagged ? put_payload(array[i], element_mode, p_depth + 1) : put_variant(array[i], p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+				}
+			} break;
+			case Variant::PACKED_BYTE_ARRAY: {
+				const Vector<uint8_t> data = p_variant;
+				put_varint(data.size());
+				put_bytes(data.ptr(), data.size());
+			} break;
+			case Variant::PACKED_INT32_ARRAY: {
+				const Vector<int32_t> data = p_variant;
+				put_varint(data.size());
+				for (int i = 0; i < data.size(); i++) {
+					put_zigzag(data[i]);
+				}
+			} break;
+			case Variant::PACKED_INT64_ARRAY: {
+				const Vector<int64_t> data = p_variant;
+				put_varint(data.size());
+				for (int i = 0; i < data.size(); i++) {
+					put_zigzag(data[i]);
+				}
+			} break;
+			case Variant::PACKED_FLOAT32_ARRAY: {
+				const Vector<float> data = p_variant;
+				put_varint(data.size());
+				for (int i = 0; i < data.size(); i++) {
+					put_component(data[i], p_mode);
+				}
+			} break;
+			case Variant::PACKED_FLOAT64_ARRAY: {
+				const Vector<double> data = p_variant;
+				put_varint(data.size());
+				for (int i = 0; i < data.size(); i++) {
+					put_component(data[i], p_mode);
+				}
+			} break;
+			case Variant::PACKED_STRING_ARRAY: {
+				const Vector<String> data = p_variant;
+				put_varint(data.size());
+				for (int i = 0; i < data.size(); i++) {
+					put_string(data[i]);
+				}
+			} break;
+			case Variant::PACKED_VECTOR2_ARRAY: {
+				const Vector<Vector2> data = p_variant;
+				put_varint(data.size());
+				for (int i = 0; i < data.size(); i++) {
+					put_component(data[i].x, p_mode);
+					put_component(data[i].y, p_mode);
+				}
+			} break;
+			case Variant::PACKED_VECTOR3_ARRAY: {
+				const Vector<Vector3> data = p_variant;
+				put_varint(data.size());
+				for (int i = 0; i < data.size(); i++) {
+					put_component(data[i].x, p_mode);
+					put_component(data[i].y, p_mode);
+					put_component(data[i].z, p_mode);
+				}
+			} break;
+			case Variant::PACKED_COLOR_ARRAY: {
+				const Vector<Color> data = p_variant;
+				put_varint(data.size());
+				for (int i = 0; i < data.size(); i++) {
+					for (int j = 0; j < 4; j++) {
+						put_component(data[i].components[j], p_mode);
+					}
+				}
+			} break;
+			default: {
+				const int real_count = _compact_real_count(type);
+				const int int_count = _compact_int_count(type);
+				if (real_count || int_count) {
+					real_t reals[16];
+					int32_t ints[4];
+					_get_compact_components(p_variant, reals, ints);
+					for (int i = 0; i < real_count; i++) {
+						put_component(reals[i], p_mode);
+					}
+					for (int i = 0; i < int_count; i++) {
+						put_zigzag(ints[i]);
+					}
+					break;
+				}
+
+				// Node paths, objects, RIDs, callables and signals.
+				int legacy_len;
+				Error err = encode_variant(p_variant, nullptr, legacy_len, full_objects, p_depth + 1);
+				ERR_FAIL_COND_V(err != OK, err);
+				put_varint(legacy_len);
+				if (buf) {
+					err = encode_variant(p_variant, buf + len, legacy_len, full_objects, p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+				}
+				len += legacy_len;
+			} break;
+		}
+
+		return OK;
+	}
+};
+
+struct CompactVariantDecoder {
+	const uint8_t *buf = nullptr;
+	int len = 0;
+	int pos = 0;
+	bool allow_objects = false;
+	LocalVector<String> strings;
+
+	Error get_byte(uint8_t &r_byte) {
+		ERR_FAIL_COND_V(pos >= len, ERR_INVALID_DATA);
+		r_byte = buf[pos++];
+		return OK;
+	}
+
+	Error get_varint(uint64_t &r_value) {
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			ERR_FAIL_COND_V(pos >= len, ERR_INVALID_DATA);
+			const uint8_t byte = buf[pos++];
+			ERR_FAIL_COND_V(shift == 63 && byte > 1, ERR_INVALID_DATA); // Overflow.
+			value |= uint64_t(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) {
+				r_value = value;
+				return OK;
+			}
+		}
+		ERR_FAIL_V(ERR_INVALID_DATA);
+	}
+
+	Error get_zigzag(int64_t &r_value) {
+		uint64_t value;
+		Error err = get_varint(value);
+		if (err != OK) {
+			return err;
+		}
+		r_value = int64_t(value >> 1) ^ -int64_t(value & 1);
+		return OK;
+	}
+
+	// Element counts are checked against the remaining data, so invalid
+	// input can't make the decoder allocate much more than its size.
+	Error get_count(int &r_count, int p_min_element_size) {
+		uint64_t count;
+		Error err = get_varint(count);
+		if (err != OK) {
+			return err;
+		}
+		ERR_FAIL_COND_V(count > uint64_t(len - pos) / p_min_element_size, ERR_INVALID_DATA);
+		r_count = count;
+		return OK;
+	}
+
+	static int get_component_size(uint8_t p_mode) {
+		return p_mode == COMPACT_COMPONENTS_HALF ? 2 : (p_mode == COMPACT_COMPONENTS_64 ? 8 : 4);
+	}
+
+	// The caller checks that enough data is left.
+	_FORCE_INLINE_ double get_component(uint8_t p_mode) {
+		double value;
+		if (p_mode == COMPACT_COMPONENTS_HALF) {
+			value = Math::half_to_float(decode_uint16(buf + pos));
+		} else if (p_mode == COMPACT_COMPONENTS_64) {
+			value = decode_double(buf + pos);
+		} else {
+			value = decode_float(buf + pos);
+		}
+		pos += get_component_size(p_mode);
+		return value;
+	}
+
+	Error get_string(String &r_string) {
+		uint64_t item;
+		Error err = get_varint(item);
+		if (err != OK) {
+			return err;
+		}
+		if (item & 1) {
+			ERR_FAIL_COND_V((item >> 1) >= strings.size(), ERR_INVALID_DATA);
+			r_string = strings[item >> 1];
+			return OK;
+		}
+
+		const uint64_t length = item >> 1;
+		ERR_FAIL_COND_V(length > uint64_t(len - pos), ERR_INVALID_DATA);
+		String str;
+		ERR_FAIL_COND_V(str.parse_utf8((const char *)buf + pos, length) != OK, ERR_INVALID_DATA);
+		pos += length;
+		if (length <= COMPACT_MAX_INTERNED_LENGTH) {
+			strings.push_back(str);
+		}
+		r_string = str;
+		return OK;
+	}
+
+	Error get_variant(Variant &r_variant, int p_depth) {
+		uint8_t tag;
+		Error err = get_byte(tag);
+		if (err != OK) {
+			return err;
+		}
+		const uint8_t type = tag & COMPACT_TYPE_MASK;
+		ERR_FAIL_COND_V(type >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+		return get_payload(Variant::Type(type), tag >> COMPACT_MODE_SHIFT, r_variant, p_depth);
+	}
+
+	Error get_payload(Variant::Type p_type, uint8_t p_mode, Variant &r_variant, int p_depth) {
+		ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Variant is too deep. Bailing.");
+
+		switch (p_type) {
+			case Variant::NIL: {
+				r_variant = Variant();
+			} break;
+			case Variant::BOOL: {
+				r_variant = p_mode != 0;
+			} break;
+			case Variant::INT: {
+				int64_t value;
+				Error err = get_zigzag(value);
+				ERR_FAIL_COND_V(err != OK, err);
+				r_variant = value;
+			} break;
+			case Variant::FLOAT: {
+				if (p_mode == COMPACT_FLOAT_INTEGRAL) {
+					int64_t value;
+					Error err = get_zigzag(value);
+					ERR_FAIL_COND_V(err != OK, err);
+					r_variant = double(value);
+				} else {
+					const uint8_t components_mode = p_mode == COMPACT_FLOAT_64 ? COMPACT_COMPONENTS_64 : COMPACT_COMPONENTS_32;
+					ERR_FAIL_COND_V(len - pos < get_component_size(components_mode), ERR_INVALID_DATA);
+					r_variant = get_component(components_mode);
+				}
+			} break;
+			case Variant::STRING: {
+				String str;
+				Error err = get_string(str);
+				ERR_FAIL_COND_V(err != OK, err);
+				r_variant = str;
+			} break;
+			case Variant::STRING_NAME: {
+				String str;
+				Error err = get_string(str);
+				ERR_FAIL_COND_V(err != OK, err);
+				r_variant = StringName(str);
+			} break;
+			case Variant::COLOR: {
+				ERR_FAIL_COND_V(len - pos < 4 * 4, ERR_INVALID_DATA);
+				Color color;
+				for (int i = 0; i < 4; i++) {
+					color.components[i] = get_component(COMPACT_COMPONENTS_32);
+				}
+				r_variant = color;
+			} break;
+			case Variant::DICTIONARY: {
+				int count;
+				Error err = get_count(count, 2);
+				ERR_FAIL_COND_V(err != OK, err);
+				Dictionary d;
+				for (int i = 0; i < count; i++) {
+					Variant key;
+					Variant value;
+					err = get_variant(key, p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+					err = get_variant(value, p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+					d[key] = value;
+				}
+				r_variant = d;
+			} break;
+			case Variant::ARRAY: {
+				Array array;
+				Variant::Type element_type = Variant::NIL;
+				uint8_t element_mode = 0;
+				bool untagged = false;
+				if (p_mode == COMPACT_ARRAY_TYPED) {
+					uint64_t type;
+					Error err = get_varint(type);
+					ERR_FAIL_COND_V(err != OK, err);
+					ERR_FAIL_COND_V(type == Variant::NIL || type == Variant::OBJECT || type >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+					err = get_byte(element_mode);
+					ERR_FAIL_COND_V(err != OK, err);
+					element_type = Variant::Type(type);
+					untagged = _is_compact_untagged(element_type);
+					array.set_typed(element_type, StringName(), Variant());
+				}
+
+				int count;
+				Error err = get_count(count, 1);
+				ERR_FAIL_COND_V(err != OK, err);
+				array.resize(count);
+				for (int i = 0; i < count; i++) {
+					Variant element;
+					err = untagged ? get_payload(element_type, element_mode, element, p_depth + 1) : get_variant(element, p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+					ERR_FAIL_COND_V(element_type != Variant::NIL && element.get_type() != element_type, ERR_INVALID_DATA);
+					array[i] = element;
+				}
+				r_variant = array;
+			} break;
+			case Variant::PACKED_BYTE_ARRAY: {
+				int count;
+				Error err = get_count(count, 1);
+				ERR_FAIL_COND_V(err != OK, err);
+				Vector<uint8_t> data;
+				data.resize(count);
+				if (count) {
+					memcpy(data.ptrw(), buf + pos, count);
+				}
+				pos += count;
+				r_variant = data;
+			} break;
+			case Variant::PACKED_INT32_ARRAY:
+			case Variant::PACKED_INT64_ARRAY: {
+				int count;
+				Error err = get_count(count, 1);
+				ERR_FAIL_COND_V(err != OK, err);
+				if (p_type == Variant::PACKED_INT32_ARRAY) {
+					Vector<int32_t> data;
+					data.resize(count);
+					int32_t *w = data.ptrw();
+					for (int i = 0; i < count; i++) {
+						int64_t value;
+						err = get_zigzag(value);
+						ERR_FAIL_COND_V(err != OK, err);
+						w[i] = value;
+					}
+					r_variant = data;
+				} else {
+					Vector<int64_t> data;
+					data.resize(count);
+					int64_t *w = data.ptrw();
+					for (int i = 0; i < count; i++) {
+						err = get_zigzag(w[i]);
+						ERR_FAIL_COND_V(err != OK, err);
+					}
+					r_variant = data;
+				}
+			} break;
+			case Variant::PACKED_FLOAT32_ARRAY:
+			case Variant::PACKED_FLOAT64_ARRAY:
+			case Variant::PACKED_VECTOR2_ARRAY:
+			case Variant::PACKED_VECTOR3_ARRAY:
+			case Variant::PACKED_COLOR_ARRAY: {
+				ERR_FAIL_COND_V(p_mode > COMPACT_COMPONENTS_HALF, ERR_INVALID_DATA);
+				int components = 1;
+				if (p_type == Variant::PACKED_VECTOR2_ARRAY) {
+					components = 2;
+				} else if (p_type == Variant::PACKED_VECTOR3_ARRAY) {
+					components = 3;
+				} else if (p_type == Variant::PACKED_COLOR_ARRAY) {
+					components = 4;
+				}
+				int count;
+				Error err = get_count(count, components * get_component_size(p_mode));
+				ERR_FAIL_COND_V(err != OK, err);
+
+				switch (p_type) {
+					case Variant::PACKED_FLOAT32_ARRAY: {
+						Vector<float> data;
+						data.resize(count);
+						float *w = data.ptrw();
+						for (int i = 0; i < count; i++) {
+							w[i] = get_component(p_mode);
+						}
+						r_variant = data;
+					} break;
+					case Variant::PACKED_FLOAT64_ARRAY: {
+						Vector<double> data;
+						data.resize(count);
+						double *w = data.ptrw();
+						for (int i = 0; i < count; i++) {
+							w[i] = get_component(p_mode);
+						}
+						r_variant = data;
+					} break;
+					case Variant::PACKED_VECTOR2_ARRAY: {
+						Vector<Vector2> data;
+						data.resize(count);
+						Vector2 *w = data.ptrw();
+						for (int i = 0; i < count; i++) {
+							w[i].x = get_component(p_mode);
+							w[i].y = get_component(p_mode);
+						}
+						r_variant = data;
+					} break;
+					case Variant::PACKED_VECTOR3_ARRAY: {
+						Vector<Vector3> data;
+						data.resize(count);
+						Vector3 *w = data.ptrw();
+						for (int i = 0; i < count; i++) {
+							w[i].x = get_component(p_mode);
+							w[i].y = get_component(p_mode);
+							w[i].z = get_component(p_mode);
+						}
+						r_variant = data;
+					} break;
+					default: {
+						Vector<Color> data;
+						data.resize(count);
+						Color *w = data.ptrw();
+						for (int i = 0; i < count; i++) {
+							for (int j = 0; j < 4; j++) {
+								w[i].components[j] = get_component(p_mode);
+							}
+						}
+						r_variant = data;
+					} break;
+				}
+			} break;
+			case Variant::PACKED_STRING_ARRAY: {
+				int count;
+				Error err = get_count(count, 1);
+				ERR_FAIL_COND_V(err != OK, err);
+				Vector<String> data;
+				data.resize(count);
+				String *w = data.ptrw();
+				for (int i = 0; i < count; i++) {
+					err = get_string(w[i]);
+					ERR_FAIL_COND_V(err != OK, err);
+				}
+				r_variant = data;
+			} break;
+			default: {
+				const int real_count = _compact_real_count(p_type);
+				const int int_count = _compact_int_count(p_type);
+				if (real_count || int_count) {
+					ERR_FAIL_COND_V(p_mode > COMPACT_COMPONENTS_HALF, ERR_INVALID_DATA);
+					ERR_FAIL_COND_V(len - pos < real_count * get_component_size(p_mode), ERR_INVALID_DATA);
+					real_t reals[16];
+					int32_t ints[4];
+					for (int i = 0; i < real_count; i++) {
+						reals[i] = get_component(p_mode);
+					}
+					for (int i = 0; i < int_count; i++) {
+						int64_t value;
+						Error err = get_zigzag(value);
+						ERR_FAIL_COND_V(err != OK, err);
+						ints[i] = value;
+					}
+					r_variant = _make_from_compact_components(p_type, reals, ints);
+					break;
+				}
+
+				int legacy_len;
+				Error err = get_count(legacy_len, 1);
+				ERR_FAIL_COND_V(err != OK, err);
+				int used = 0;
+				err = decode_variant(r_variant, buf + pos, legacy_len, &used, allow_objects, p_depth + 1);
+				ERR_FAIL_COND_V(err != OK, err);
+				ERR_FAIL_COND_V(r_variant.get_type() != p_type, ERR_INVALID_DATA);
+				pos += legacy_len;
+			} break;
+		}
+
+		return OK;
+	}
+};
+
+Error encode_variant_compact(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects, uint32_t p_flags) {
+	if (r_buffer) {
+		r_buffer[0] = COMPACT_MARKER;
+		r_buffer[1] = COMPACT_VERSION;
+	}
+	Error err = encode_variant_compact_body(p_variant, r_buffer ? r_buffer + 2 : nullptr, r_len, p_full_objects, p_flags);
+	r_len += 2;
+	return err;
+}
+
+Error decode_variant_compact(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
+	ERR_FAIL_COND_V(p_len < 2 || p_buffer[0] != COMPACT_MARKER, ERR_INVALID_DATA);
+	ERR_FAIL_COND_V_MSG(p_buffer[1] != COMPACT_VERSION, ERR_INVALID_DATA, vformat("Unsupported compact Variant encoding version %d.", p_buffer[1]));
+
+	Error err = decode_variant_compact_body(r_variant, p_buffer + 2, p_len - 2, r_len, p_allow_objects);
+	if (err == OK && r_len) {
+		*r_len += 2;
+	}
+	return err;
+}
+
+Error encode_variant_compact_body(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects, uint32_t p_flags) {
+	CompactVariantEncoder encoder;
+	encoder.buf = r_buffer;
+	encoder.full_objects = p_full_objects;
+	encoder.flags = p_flags;
+
+	Error err = encoder.put_variant(p_variant, 0);
+	r_len = encoder.len;
+	return err;
+}
+
+Error decode_variant_compact_body(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
+	CompactVariantDecoder decoder;
+	decoder.buf = p_buffer;
+	decoder.len = p_len;
+	decoder.allow_objects = p_allow_objects;
+
+	Variant value;
+	Error err = decoder.get_variant(value, 0);
+	if (err != OK) {
+		return err;
+	}
+	r_variant = value;
+	if (r_len) {
+		*r_len = decoder.pos;
+	}
+	return OK;
+}
+
 Vector<float> vector3_to_float32_array(const Vector3 *vecs, size_t count) {
 	// We always allocate a new array, and we don't memcpy.
 	// We also don't consider returning a pointer to the passed vectors when sizeof(real_t) == 4.
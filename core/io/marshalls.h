@@ -215,6 +215,24 @@ public:
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = nullptr, bool p_allow_objects = false, int p_depth = 0);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false, int p_depth = 0);
 
+// Flags for encode_variant_compact(). Both are lossy, and only affect packed
+// float, vector and color arrays.
+enum VariantCompactFlags {
+	ENCODE_COMPACT_HALF_FLOATS = 1 << 0,
+	ENCODE_COMPACT_FLOAT32 = 1 << 1, // Store packed 64-bit floats and double precision vectors as 32-bit floats.
+};
+
+// Smaller encoding for save files and network messages, with varints, a
+// string table and typed arrays. decode_variant() detects it automatically.
+Error encode_variant_compact(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false, uint32_t p_flags = 0);
+Error decode_variant_compact(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = nullptr, bool p_allow_objects = false);
+
+// The compact encoding without its marker and version header, for callers
+// which frame each value themselves and agree on the format beforehand.
+// decode_variant() can't detect it.
+Error encode_variant_compact_body(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false, uint32_t p_flags = 0);
+Error decode_variant_compact_body(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = nullptr, bool p_allow_objects = false);
+
 Vector<float> vector3_to_float32_array(const Vector3 *vecs, size_t count);
 
 #endif // MARSHALLS_H
@@ -46,6 +46,15 @@ int PacketPeer::get_encode_buffer_max_size() const {
 	return encode_buffer_max_size;
 }
 
+void PacketPeer::set_var_encoding(VarEncoding p_encoding) {
+	ERR_FAIL_INDEX(p_encoding, VAR_ENCODING_COMPACT_HALF_FLOATS + 1);
+	var_encoding = p_encoding;
+}
+
+PacketPeer::VarEncoding PacketPeer::get_var_encoding() const {
+	return var_encoding;
+}
+
 Error PacketPeer::get_packet_buffer(Vector<uint8_t> &r_buffer) {
 	const uint8_t *buffer;
 	int buffer_size;
@@ -88,9 +97,20 @@ Error PacketPeer::get_var(Variant &r_variant, bool p_allow_objects) {
 	return decode_variant(r_variant, buffer, buffer_size, nullptr, p_allow_objects);
 }
 
+Error PacketPeer::_encode_var(const Variant &p_packet, uint8_t *r_buffer, int &r_len, bool p_full_objects) const {
+	switch (var_encoding) {
+		case VAR_ENCODING_COMPACT:
+			return encode_variant_compact(p_packet, r_buffer, r_len, p_full_objects);
+		case VAR_ENCODING_COMPACT_HALF_FLOATS:
+			return encode_variant_compact(p_packet, r_buffer, r_len, p_full_objects, ENCODE_COMPACT_HALF_FLOATS);
+		default:
+			return encode_variant(p_packet, r_buffer, r_len, p_full_objects);
+	}
+}
+
 Error PacketPeer::put_var(const Variant &p_packet, bool p_full_objects) {
 	int len;
-	Error err = encode_variant(p_packet, nullptr, len, p_full_objects); // compute len first
+	Error err = _encode_var(p_packet, nullptr, len, p_full_objects); // compute len first
 	if (err) {
 		return err;
 	}
@@ -107,7 +127,7 @@ Error PacketPeer::put_var(const Variant &p_packet, bool p_full_objects) {
 	}
 
 	uint8_t *w = encode_buffer.ptrw();
-	err = encode_variant(p_packet, w, len, p_full_objects);
+	err = _encode_var(p_packet, w, len, p_full_objects);
 	ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to encode Variant.");
 
 	return put_packet(w, len);
@@ -147,7 +167,15 @@ void PacketPeer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_encode_buffer_max_size"), &PacketPeer::get_encode_buffer_max_size);
 	ClassDB::bind_method(D_METHOD("set_encode_buffer_max_size", "max_size"), &PacketPeer::set_encode_buffer_max_size);
 
+	ClassDB::bind_method(D_METHOD("get_var_encoding"), &PacketPeer::get_var_encoding);
+	ClassDB::bind_method(D_METHOD("set_var_encoding", "encoding"), &PacketPeer::set_var_encoding);
+
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "encode_buffer_max_size"), "set_encode_buffer_max_size", "get_encode_buffer_max_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "var_encoding", PROPERTY_HINT_ENUM, "Default,Compact,Compact Half Floats"), "set_var_encoding", "get_var_encoding");
+
+	BIND_ENUM_CONSTANT(VAR_ENCODING_DEFAULT);
+	BIND_ENUM_CONSTANT(VAR_ENCODING_COMPACT);
+	BIND_ENUM_CONSTANT(VAR_ENCODING_COMPACT_HALF_FLOATS);
 }
 
 /***************/
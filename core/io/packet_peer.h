@@ -43,6 +43,14 @@
 class PacketPeer : public RefCounted {
 	GDCLASS(PacketPeer, RefCounted);
 
+public:
+	enum VarEncoding {
+		VAR_ENCODING_DEFAULT,
+		VAR_ENCODING_COMPACT,
+		VAR_ENCODING_COMPACT_HALF_FLOATS,
+	};
+
+private:
 	Variant _bnd_get_var(bool p_allow_objects = false);
 
 	static void _bind_methods();
@@ -50,11 +58,13 @@ class PacketPeer : public RefCounted {
 	Error _put_packet(const Vector<uint8_t> &p_buffer);
 	Vector<uint8_t> _get_packet();
 	Error _get_packet_error() const;
+	Error _encode_var(const Variant &p_packet, uint8_t *r_buffer, int &r_len, bool p_full_objects) const;
 
 	mutable Error last_get_error = OK;
 
 	int encode_buffer_max_size = 8 * 1024 * 1024;
 	Vector<uint8_t> encode_buffer;
+	VarEncoding var_encoding = VAR_ENCODING_DEFAULT;
 
 public:
 	virtual int get_available_packet_count() const = 0;
@@ -74,10 +84,15 @@ public:
 	void set_encode_buffer_max_size(int p_max_size);
 	int get_encode_buffer_max_size() const;
 
+	void set_var_encoding(VarEncoding p_encoding);
+	VarEncoding get_var_encoding() const;
+
 	PacketPeer() {}
 	~PacketPeer() {}
 };
 
+VARIANT_ENUM_CAST(PacketPeer::VarEncoding);
+
 class PacketPeerExtension : public PacketPeer {
 	GDCLASS(PacketPeerExtension, PacketPeer);
 
@@ -32,10 +32,19 @@
 
 #include "core/crypto/crypto_core.h"
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_encrypted.h"
-#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION, PackIndex
+#include "core/templates/local_vector.h"
 #include "core/version.h"
 
+// Compressed files use larger blocks than the FileAccessCompressed default, for a better ratio
+// and so big reads are split in few enough blocks to be decompressed in parallel.
+static const uint32_t COMPRESSION_BLOCK_SIZE = 64 * 1024;
+// Same as the default size of dictionaries trained by Zstandard.
+static const int COMPRESSION_DICTIONARY_MAX_SIZE = 112 * 1024;
+static const int COMPRESSION_DICTIONARY_SAMPLE_SIZE = 1024;
+
 static int _get_pad(int p_alignment, int p_n) {
 	int rest = p_n % p_alignment;
 	int pad = 0;
@@ -48,8 +57,13 @@ static int _get_pad(int p_alignment, int p_n) {
 
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
-	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt", "compress"), &PCKPacker::add_file, DEFVAL(false), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
+
+	ClassDB::bind_method(D_METHOD("set_use_compression_dictionary", "enable"), &PCKPacker::set_use_compression_dictionary);
+	ClassDB::bind_method(D_METHOD("is_using_compression_dictionary"), &PCKPacker::is_using_compression_dictionary);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_compression_dictionary"), "set_use_compression_dictionary", "is_using_compression_dictionary");
 }
 
 Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &p_key, bool p_encrypt_directory) {
@@ -101,12 +115,11 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	file->store_32(pack_flags); // flags
 
 	files.clear();
-	ofs = 0;
 
 	return OK;
 }
 
-Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt) {
+Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt, bool p_compress) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
 	Ref<FileAccess> f = FileAccess::open(p_src, FileAccess::READ);
@@ -117,7 +130,6 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 	File pf;
 	pf.path = p_file;
 	pf.src_path = p_src;
-	pf.ofs = ofs;
 	pf.size = f->get_length();
 
 	Vector<uint8_t> data = FileAccess::get_file_as_bytes(p_src);
@@ -130,38 +142,47 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 		}
 	}
 	pf.encrypted = p_encrypt;
-
-	uint64_t _size = pf.size;
-	if (p_encrypt) { // Add encryption overhead.
-		if (_size % 16) { // Pad to encryption block size.
-			_size += 16 - (_size % 16);
-		}
-		_size += 16; // hash
-		_size += 8; // data size
-		_size += 16; // iv
-	}
-
-	int pad = _get_pad(alignment, ofs + _size);
-	ofs = ofs + _size + pad;
+	pf.compressed = p_compress;
 
 	files.push_back(pf);
 
 	return OK;
 }
 
-Error PCKPacker::flush(bool p_verbose) {
-	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
-
-	int64_t file_base_ofs = file->get_position();
-	file->store_64(0); // files base
+// Zstandard can use any data as a raw content dictionary. The start of files is where files of the
+// same type have the most in common (headers, class and property names), so it's sampled from there.
+Vector<uint8_t> PCKPacker::_build_compression_dictionary() const {
+	Vector<uint8_t> dictionary;
+	int sampled = 0;
+	for (const File &pf : files) {
+		// The dictionary is stored in plain, it must not leak the contents of encrypted files.
+		if (!pf.compressed || pf.encrypted || pf.size == 0) {
+			continue;
+		}
 
-	for (int i = 0; i < 16; i++) {
-		file->store_32(0); // reserved
+		Ref<FileAccess> f = FileAccess::open(pf.src_path, FileAccess::READ);
+		if (f.is_null()) {
+			continue;
+		}
+		int sample_size = MIN((uint64_t)MIN(COMPRESSION_DICTIONARY_SAMPLE_SIZE, COMPRESSION_DICTIONARY_MAX_SIZE - dictionary.size()), pf.size);
+		int dict_ofs = dictionary.size();
+		dictionary.resize(dict_ofs + sample_size);
+		dictionary.resize(dict_ofs + f->get_buffer(dictionary.ptrw() + dict_ofs, sample_size));
+		sampled++;
+
+		if (dictionary.size() >= COMPRESSION_DICTIONARY_MAX_SIZE) {
+			break;
+		}
 	}
 
-	// write the index
-	file->store_32(files.size());
+	// Not worth it when there is nothing to share the dictionary with.
+	if (sampled < 2) {
+		dictionary.clear();
+	}
+	return dictionary;
+}
 
+Error PCKPacker::_store_index() {
 	Ref<FileAccessEncrypted> fae;
 	Ref<FileAccess> fhead = file;
 
@@ -175,32 +196,62 @@ Error PCKPacker::flush(bool p_verbose) {
 		fhead = fae;
 	}
 
+	Vector<PackIndex::FileInfo> index_files;
+	index_files.resize(files.size());
 	for (int i = 0; i < files.size(); i++) {
-		int string_len = files[i].path.utf8().length();
-		int pad = _get_pad(4, string_len);
+		PackIndex::FileInfo &fi = index_files.write[i];
+		fi.path = files[i].path;
+		fi.offset = files[i].ofs;
+		fi.size = files[i].size; // pay attention here, this is where file is
+		memcpy(fi.md5, files[i].md5.ptr(), 16); //also save md5 for file
 
-		fhead->store_32(string_len + pad);
-		fhead->store_buffer((const uint8_t *)files[i].path.utf8().get_data(), string_len);
-		for (int j = 0; j < pad; j++) {
-			fhead->store_8(0);
+		if (files[i].encrypted) {
+			fi.flags |= PACK_FILE_ENCRYPTED;
+		}
+		if (files[i].compressed) {
+			fi.flags |= PACK_FILE_COMPRESSED;
 		}
+	}
+	Vector<uint8_t> index = PackIndex::build(index_files);
+	ERR_FAIL_COND_V(index.is_empty(), ERR_CANT_CREATE);
+	fhead->store_buffer(index.ptr(), index.size());
 
-		fhead->store_64(files[i].ofs);
-		fhead->store_64(files[i].size); // pay attention here, this is where file is
-		fhead->store_buffer(files[i].md5.ptr(), 16); //also save md5 for file
+	return OK;
+}
 
-		uint32_t flags = 0;
-		if (files[i].encrypted) {
-			flags |= PACK_FILE_ENCRYPTED;
-		}
-		fhead->store_32(flags);
+Error PCKPacker::flush(bool p_verbose) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+
+	Vector<uint8_t> dictionary;
+	if (use_compression_dictionary) {
+		dictionary = _build_compression_dictionary();
 	}
 
-	if (fae.is_valid()) {
-		fhead.unref();
-		fae.unref();
+	if (!dictionary.is_empty()) {
+		// The flags were stored by pck_start(), right before the files base.
+		file->seek(file->get_position() - 4);
+		file->store_32((enc_dir ? PACK_DIR_ENCRYPTED : 0) | PACK_COMPRESSION_DICTIONARY);
+	}
+
+	int64_t file_base_ofs = file->get_position();
+	file->store_64(0); // files base
+
+	file->store_64(0); // compression dictionary offset, relative to the files base
+	file->store_32(dictionary.size()); // compression dictionary size
+	for (int i = 0; i < 13; i++) {
+		file->store_32(0); // reserved
 	}
 
+	// write the index
+	file->store_32(files.size());
+
+	// The offsets and the size of compressed files are only known once the files are written.
+	// The index doesn't change size with them, so it's written again at the same place at the end.
+	uint64_t index_ofs = file->get_position();
+	Error err = _store_index();
+	ERR_FAIL_COND_V(err != OK, err);
+	uint64_t index_end = file->get_position();
+
 	int header_padding = _get_pad(alignment, file->get_position());
 	for (int i = 0; i < header_padding; i++) {
 		file->store_8(Math::rand() % 256);
@@ -211,28 +262,59 @@ Error PCKPacker::flush(bool p_verbose) {
 	file->store_64(file_base); // update files base
 	file->seek(file_base);
 
+	if (!dictionary.is_empty()) {
+		file->store_buffer(dictionary.ptr(), dictionary.size());
+		int pad = _get_pad(alignment, file->get_position());
+		for (int i = 0; i < pad; i++) {
+			file->store_8(Math::rand() % 256);
+		}
+	}
+
 	const uint32_t buf_max = 65536;
-	uint8_t *buf = memnew_arr(uint8_t, buf_max);
+	LocalVector<uint8_t> buf;
+	buf.resize(buf_max);
 
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
-		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
+		File &pf = files.write[i];
+		pf.ofs = file->get_position() - file_base;
+
+		// Compressed one file at a time, so only that file is held in memory.
+		Vector<uint8_t> compressed_data;
+		if (pf.compressed) {
+			Vector<uint8_t> data = FileAccess::get_file_as_bytes(pf.src_path);
+			compressed_data = FileAccessCompressed::compress_buffer(data.ptr(), data.size(), PACK_FILE_COMPRESSED_MAGIC, Compression::MODE_ZSTD, COMPRESSION_BLOCK_SIZE, dictionary);
+			ERR_FAIL_COND_V_MSG(compressed_data.is_empty(), ERR_CANT_CREATE, "Can't compress file: " + pf.src_path + ".");
+			if ((uint64_t)compressed_data.size() < pf.size) {
+				pf.size = compressed_data.size();
+			} else {
+				// Store it as is if compression doesn't save anything.
+				pf.compressed = false;
+				compressed_data.clear();
+			}
+		}
 
+		Ref<FileAccessEncrypted> fae;
 		Ref<FileAccess> ftmp = file;
-		if (files[i].encrypted) {
+		if (pf.encrypted) {
 			fae.instantiate();
 			ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
 
-			Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
+			err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
 			ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
 			ftmp = fae;
 		}
 
-		while (to_write > 0) {
-			uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
-			ftmp->store_buffer(buf, read);
-			to_write -= read;
+		if (pf.compressed) {
+			ftmp->store_buffer(compressed_data.ptr(), compressed_data.size());
+		} else {
+			Ref<FileAccess> src = FileAccess::open(pf.src_path, FileAccess::READ);
+			uint64_t to_write = pf.size;
+			while (to_write > 0) {
+				uint64_t read = src->get_buffer(buf.ptr(), MIN(to_write, buf_max));
+				ftmp->store_buffer(buf.ptr(), read);
+				to_write -= read;
+			}
 		}
 
 		if (fae.is_valid()) {
@@ -248,16 +330,28 @@ Error PCKPacker::flush(bool p_verbose) {
 		count += 1;
 		const int file_num = files.size();
 		if (p_verbose && (file_num > 0)) {
-			print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s", count, file_num, float(count) / file_num * 100, files[i].src_path, files[i].path));
+			print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s", count, file_num, float(count) / file_num * 100, pf.src_path, pf.path));
 		}
 	}
 
+	file->seek(index_ofs);
+	err = _store_index();
+	ERR_FAIL_COND_V(err != OK, err);
+	ERR_FAIL_COND_V_MSG(file->get_position() != index_end, ERR_BUG, "The pack index changed size when its offsets were updated.");
+
 	if (p_verbose) {
 		printf("\n");
 	}
 
 	file.unref();
-	memdelete_arr(buf);
 
 	return OK;
 }
+
+void PCKPacker::set_use_compression_dictionary(bool p_enable) {
+	use_compression_dictionary = p_enable;
+}
+
+bool PCKPacker::is_using_compression_dictionary() const {
+	return use_compression_dictionary;
+}
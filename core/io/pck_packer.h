@@ -40,10 +40,10 @@ class PCKPacker : public RefCounted {
 
 	Ref<FileAccess> file;
 	int alignment = 0;
-	uint64_t ofs = 0;
 
 	Vector<uint8_t> key;
 	bool enc_dir = false;
+	bool use_compression_dictionary = false;
 
 	static void _bind_methods();
 
@@ -53,15 +53,22 @@ class PCKPacker : public RefCounted {
 		uint64_t ofs = 0;
 		uint64_t size = 0;
 		bool encrypted = false;
+		bool compressed = false;
 		Vector<uint8_t> md5;
 	};
 	Vector<File> files;
 
+	Vector<uint8_t> _build_compression_dictionary() const;
+	Error _store_index();
+
 public:
 	Error pck_start(const String &p_file, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
-	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false);
+	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false, bool p_compress = false);
 	Error flush(bool p_verbose = false);
 
+	void set_use_compression_dictionary(bool p_enable);
+	bool is_using_compression_dictionary() const;
+
 	PCKPacker() {}
 };
 
@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access_compressed.h"
+#include "core/io/file_access_memory.h"
 #include "core/io/image.h"
 #include "core/io/marshalls.h"
 #include "core/io/missing_resource.h"
@@ -113,16 +114,27 @@ static Error read_reals(real_t *dst, Ref<FileAccess> &f, size_t count) {
 			f->get_buffer((uint8_t *)dst, count * sizeof(double));
 #ifdef BIG_ENDIAN_ENABLED
 			{
-				uint64_t *dst = (uint64_t *)dst;
+				uint64_t *ptr = (uint64_t *)dst;
 				for (size_t i = 0; i < count; i++) {
-					dst[i] = BSWAP64(dst[i]);
+					ptr[i] = BSWAP64(ptr[i]);
 				}
 			}
 #endif
 		} else if constexpr (sizeof(real_t) == 4) {
 			// May be slower, but this is for compatibility. Eventually the data should be converted.
+			// Read everything at once and narrow afterwards, rather than going through get_double() for each value.
+			LocalVector<uint64_t> src;
+			src.resize(count);
+			f->get_buffer((uint8_t *)src.ptr(), count * sizeof(double));
+#ifdef BIG_ENDIAN_ENABLED
+			const bool swap = !f->is_big_endian();
+#else
+			const bool swap = f->is_big_endian();
+#endif
 			for (size_t i = 0; i < count; ++i) {
-				dst[i] = f->get_double();
+				MarshallDouble md;
+				md.l = swap ? BSWAP64(src[i]) : src[i];
+				dst[i] = md.d;
 			}
 		} else {
 			ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "real_t size is neither 4 nor 8!");
@@ -133,15 +145,25 @@ static Error read_reals(real_t *dst, Ref<FileAccess> &f, size_t count) {
 			f->get_buffer((uint8_t *)dst, count * sizeof(float));
 #ifdef BIG_ENDIAN_ENABLED
 			{
-				uint32_t *dst = (uint32_t *)dst;
+				uint32_t *ptr = (uint32_t *)dst;
 				for (size_t i = 0; i < count; i++) {
-					dst[i] = BSWAP32(dst[i]);
+					ptr[i] = BSWAP32(ptr[i]);
 				}
 			}
 #endif
 		} else if constexpr (sizeof(real_t) == 8) {
+			LocalVector<uint32_t> src;
+			src.resize(count);
+			f->get_buffer((uint8_t *)src.ptr(), count * sizeof(float));
+#ifdef BIG_ENDIAN_ENABLED
+			const bool swap = !f->is_big_endian();
+#else
+			const bool swap = f->is_big_endian();
+#endif
 			for (size_t i = 0; i < count; ++i) {
-				dst[i] = f->get_float();
+				MarshallFloat mf;
+				mf.i = swap ? BSWAP32(src[i]) : src[i];
+				dst[i] = mf.f;
 			}
 		} else {
 			ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "real_t size is neither 4 nor 8!");
@@ -407,11 +429,12 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					}
 
 					//always use internal cache for loading internal resources
-					if (!internal_index_cache.has(path)) {
+					const Ref<Resource> *cached = (shared_index_cache ? shared_index_cache : &internal_index_cache)->getptr(path);
+					if (!cached) {
 						WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
 						r_v = Variant();
 					} else {
-						r_v = internal_index_cache[path];
+						r_v = *cached;
 					}
 				} break;
 				case OBJECT_EXTERNAL_RESOURCE: {
@@ -528,8 +551,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			f->get_buffer((uint8_t *)w, len * sizeof(int32_t));
 #ifdef BIG_ENDIAN_ENABLED
 			{
-				uint32_t *ptr = (uint32_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
+				uint32_t *ptr = (uint32_t *)w;
+				for (uint32_t i = 0; i < len; i++) {
 					ptr[i] = BSWAP32(ptr[i]);
 				}
 			}
@@ -547,8 +570,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			f->get_buffer((uint8_t *)w, len * sizeof(int64_t));
 #ifdef BIG_ENDIAN_ENABLED
 			{
-				uint64_t *ptr = (uint64_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
+				uint64_t *ptr = (uint64_t *)w;
+				for (uint32_t i = 0; i < len; i++) {
 					ptr[i] = BSWAP64(ptr[i]);
 				}
 			}
@@ -566,8 +589,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			f->get_buffer((uint8_t *)w, len * sizeof(float));
 #ifdef BIG_ENDIAN_ENABLED
 			{
-				uint32_t *ptr = (uint32_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
+				uint32_t *ptr = (uint32_t *)w;
+				for (uint32_t i = 0; i < len; i++) {
 					ptr[i] = BSWAP32(ptr[i]);
 				}
 			}
@@ -585,8 +608,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			f->get_buffer((uint8_t *)w, len * sizeof(double));
 #ifdef BIG_ENDIAN_ENABLED
 			{
-				uint64_t *ptr = (uint64_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
+				uint64_t *ptr = (uint64_t *)w;
+				for (uint32_t i = 0; i < len; i++) {
 					ptr[i] = BSWAP64(ptr[i]);
 				}
 			}
@@ -644,8 +667,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			f->get_buffer((uint8_t *)w, len * sizeof(float) * 4);
 #ifdef BIG_ENDIAN_ENABLED
 			{
-				uint32_t *ptr = (uint32_t *)w.ptr();
-				for (int i = 0; i < len * 4; i++) {
+				uint32_t *ptr = (uint32_t *)w;
+				for (uint32_t i = 0; i < len * 4; i++) {
 					ptr[i] = BSWAP32(ptr[i]);
 				}
 			}
@@ -666,6 +689,105 @@ Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
 
+Error ResourceLoaderBinary::_parse_properties(LocalVector<Pair<StringName, Variant>> &r_properties) {
+	int pc = f->get_32();
+	r_properties.reserve(pc);
+
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
+
+		if (name == StringName()) {
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
+
+		Variant value;
+
+		Error err = parse_variant(value);
+		if (err) {
+			return err;
+		}
+
+		r_properties.push_back(Pair<StringName, Variant>(name, value));
+	}
+
+	return OK;
+}
+
+void ResourceLoaderBinary::_set_properties(Resource *p_res, MissingResource *p_missing_resource, LocalVector<Pair<StringName, Variant>> &p_properties) {
+	Dictionary missing_resource_properties;
+
+	for (Pair<StringName, Variant> &E : p_properties) {
+		const StringName &name = E.first;
+		Variant &value = E.second;
+
+		bool set_valid = true;
+		if (value.get_type() == Variant::OBJECT && p_missing_resource != nullptr) {
+			// If the property being set is a missing resource (and the parent is not),
+			// then setting it will most likely not work.
+			// Instead, save it as metadata.
+
+			Ref<MissingResource> mr = value;
+			if (mr.is_valid()) {
+				missing_resource_properties[name] = mr;
+				set_valid = false;
+			}
+		}
+
+		if (value.get_type() == Variant::ARRAY) {
+			Array set_array = value;
+			bool is_get_valid = false;
+			Variant get_value = p_res->get(name, &is_get_valid);
+			if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
+				Array get_array = get_value;
+				if (!set_array.is_same_typed(get_array)) {
+					value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
+				}
+			}
+		}
+
+		if (set_valid) {
+			p_res->set(name, value);
+		}
+	}
+
+	if (p_missing_resource) {
+		p_missing_resource->set_recording_properties(false);
+	}
+
+	if (!missing_resource_properties.is_empty()) {
+		p_res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+	}
+}
+
+ResourceLoaderBinary *ResourceLoaderBinary::_create_decode_loader(uint64_t p_offset) const {
+	ResourceLoaderBinary *loader = memnew(ResourceLoaderBinary);
+	loader->local_path = local_path;
+	loader->res_path = res_path;
+	loader->ver_format = ver_format;
+	loader->using_named_scene_ids = using_named_scene_ids;
+	loader->string_map = string_map;
+	loader->external_resources = external_resources;
+	loader->internal_resources = internal_resources;
+	loader->remaps = remaps;
+	loader->cache_mode = cache_mode;
+	loader->shared_index_cache = &internal_index_cache;
+
+	Ref<FileAccessMemory> fam;
+	fam.instantiate();
+	fam->open_custom(f->get_mapped_buffer(), f->get_length());
+	fam->set_big_endian(f->is_big_endian());
+	fam->real_is_double = f->real_is_double;
+	fam->seek(p_offset);
+	loader->f = fam;
+
+	return loader;
+}
+
+void ResourceLoaderBinary::_decode_properties_task(void *p_userdata) {
+	PropertyDecodeTask *task = static_cast<PropertyDecodeTask *>(p_userdata);
+	task->error = task->loader->_parse_properties(task->properties);
+}
+
 Error ResourceLoaderBinary::load() {
 	if (error != OK) {
 		return error;
@@ -698,7 +820,7 @@ Error ResourceLoaderBinary::load() {
 			}
 
 		} else {
-			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, local_path);
+			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, true, local_path);
 			if (err != OK) {
 				if (!ResourceLoader::get_abort_on_missing_resources()) {
 					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
@@ -710,6 +832,18 @@ Error ResourceLoaderBinary::load() {
 		}
 	}
 
+	struct LoadEntry {
+		Ref<Resource> res;
+		MissingResource *missing_resource = nullptr;
+		uint64_t properties_offset = 0;
+		PropertyDecodeTask *task = nullptr;
+	};
+
+	LocalVector<LoadEntry> entries;
+	entries.resize(internal_resources.size());
+
+	// Create all resources first, so every internal reference can be resolved
+	// no matter which thread decodes the properties pointing to it.
 	for (int i = 0; i < internal_resources.size(); i++) {
 		bool main = i == (internal_resources.size() - 1);
 
@@ -798,84 +932,125 @@ Error ResourceLoaderBinary::load() {
 			internal_index_cache[path] = res;
 		}
 
-		int pc = f->get_32();
-
-		//set properties
-
-		Dictionary missing_resource_properties;
-
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
-
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
-
-			Variant value;
+		entries[i].res = res;
+		entries[i].missing_resource = missing_resource;
+		entries[i].properties_offset = f->get_position();
+	}
+
+	// Decode the properties of large sub-resources (meshes, images, animations...)
+	// on the WorkerThreadPool. Each task reads from its own view of the file, so
+	// this is only done when the whole file is in memory.
+	LocalVector<PropertyDecodeTask *> tasks;
+	if (f->get_mapped_buffer() && using_named_scene_ids && WorkerThreadPool::get_singleton()->get_thread_count() > 1) {
+		// Resources are stored one after the other, so the size of each is the gap to the next one.
+		LocalVector<Pair<uint64_t, uint32_t>> offsets;
+		offsets.resize(internal_resources.size());
+		for (int i = 0; i < internal_resources.size(); i++) {
+			offsets[i] = Pair<uint64_t, uint32_t>(internal_resources[i].offset, i);
+		}
+		offsets.sort_custom<PairSort<uint64_t, uint32_t>>();
 
-			error = parse_variant(value);
-			if (error) {
-				return error;
+		LocalVector<uint32_t> large;
+		for (uint32_t i = 0; i < offsets.size(); i++) {
+			uint32_t index = offsets[i].second;
+			if (entries[index].res.is_null()) {
+				continue; // Taken from the cache.
 			}
-
-			bool set_valid = true;
-			if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
-				// If the property being set is a missing resource (and the parent is not),
-				// then setting it will most likely not work.
-				// Instead, save it as metadata.
-
-				Ref<MissingResource> mr = value;
-				if (mr.is_valid()) {
-					missing_resource_properties[name] = mr;
-					set_valid = false;
-				}
+			uint64_t next = i + 1 < offsets.size() ? offsets[i + 1].first : f->get_length();
+			if (next - offsets[i].first >= PARALLEL_DECODE_MIN_SIZE) {
+				large.push_back(index);
 			}
+		}
 
-			if (value.get_type() == Variant::ARRAY) {
-				Array set_array = value;
-				bool is_get_valid = false;
-				Variant get_value = res->get(name, &is_get_valid);
-				if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
-					Array get_array = get_value;
-					if (!set_array.is_same_typed(get_array)) {
-						value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
+		if (large.size() >= 2) {
+			if (use_sub_threads) {
+				// Tasks can't wait for threaded loads, so get the dependencies here.
+				for (int i = 0; i < external_resources.size(); i++) {
+					if (external_resources[i].cache.is_valid()) {
+						continue;
+					}
+					Error err;
+					external_resources.write[i].cache = ResourceLoader::load_threaded_get(external_resources[i].path, &err);
+					if (err != OK || external_resources[i].cache.is_null()) {
+						if (!ResourceLoader::get_abort_on_missing_resources()) {
+							ResourceLoader::notify_dependency_error(local_path, external_resources[i].path, external_resources[i].type);
+						} else {
+							error = ERR_FILE_MISSING_DEPENDENCIES;
+							ERR_FAIL_V_MSG(error, "Can't load dependency: " + external_resources[i].path + ".");
+						}
 					}
 				}
 			}
 
-			if (set_valid) {
-				res->set(name, value);
+			for (uint32_t i : large) {
+				PropertyDecodeTask *task = memnew(PropertyDecodeTask);
+				task->loader = _create_decode_loader(entries[i].properties_offset);
+				task->task_id = WorkerThreadPool::get_singleton()->add_native_task(&ResourceLoaderBinary::_decode_properties_task, task, true, "Decode resource properties");
+				entries[i].task = task;
+				tasks.push_back(task);
 			}
 		}
+	}
 
-		if (missing_resource) {
-			missing_resource->set_recording_properties(false);
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		LoadEntry &entry = entries[i];
+		if (entry.res.is_null()) {
+			continue;
+		}
+		bool main = i == entries.size() - 1;
+
+		LocalVector<Pair<StringName, Variant>> parsed_properties;
+		LocalVector<Pair<StringName, Variant>> &properties = entry.task ? entry.task->properties : parsed_properties;
+		if (entry.task) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(entry.task->task_id);
+			entry.task->task_id = WorkerThreadPool::INVALID_TASK_ID;
+			error = entry.task->error;
+		} else {
+			f->seek(entry.properties_offset);
+			error = _parse_properties(properties);
 		}
 
-		if (!missing_resource_properties.is_empty()) {
-			res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+		if (error != OK) {
+			for (PropertyDecodeTask *task : tasks) {
+				if (task->task_id != WorkerThreadPool::INVALID_TASK_ID) {
+					WorkerThreadPool::get_singleton()->wait_for_task_completion(task->task_id);
+				}
+				memdelete(task->loader);
+				memdelete(task);
+			}
+			return error;
 		}
 
+		_set_properties(entry.res.ptr(), entry.missing_resource, properties);
+
 #ifdef TOOLS_ENABLED
-		res->set_edited(false);
+		entry.res->set_edited(false);
 #endif
 
 		if (progress) {
 			*progress = (i + 1) / float(internal_resources.size());
 		}
 
-		resource_cache.push_back(res);
+		resource_cache.push_back(entry.res);
 
 		if (main) {
+			for (PropertyDecodeTask *task : tasks) {
+				memdelete(task->loader);
+				memdelete(task);
+			}
 			f.unref();
-			resource = res;
+			resource = entry.res;
 			resource->set_as_translation_remapped(translation_remapped);
 			error = OK;
 			return OK;
 		}
 	}
 
+	for (PropertyDecodeTask *task : tasks) {
+		memdelete(task->loader);
+		memdelete(task);
+	}
+
 	return ERR_FILE_EOF;
 }
 
@@ -973,6 +1148,15 @@ void ResourceLoaderBinary::open(Ref<FileAccess> p_f, bool p_no_resources, bool p
 		error = ERR_FILE_UNRECOGNIZED;
 		f.unref();
 		ERR_FAIL_MSG("Unrecognized binary resource file: " + local_path + ".");
+
+	} else if (const uint8_t *mapped = f->get_mapped_buffer()) {
+		// Parse from the mapped file directly, rather than going through stdio for every field.
+		Ref<FileAccessMemory> fam;
+		fam.instantiate();
+		fam->open_custom(mapped, f->get_length());
+		fam->seek(f->get_position());
+		mapped_f = f;
+		f = fam;
 	}
 
 	bool big_endian = f->get_32();
@@ -34,6 +34,10 @@
 #include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/pair.h"
+
+class MissingResource;
 
 class ResourceLoaderBinary {
 	bool translation_remapped = false;
@@ -44,6 +48,7 @@ class ResourceLoaderBinary {
 	uint32_t ver_format = 0;
 
 	Ref<FileAccess> f;
+	Ref<FileAccess> mapped_f; // Owns the mapping when f reads from memory.
 
 	uint64_t importmd_ofs = 0;
 
@@ -77,6 +82,24 @@ class ResourceLoaderBinary {
 
 	Vector<IntResource> internal_resources;
 	HashMap<String, Ref<Resource>> internal_index_cache;
+	// Set on the loaders decoding sub-resources on other threads, to use the cache of the main one.
+	const HashMap<String, Ref<Resource>> *shared_index_cache = nullptr;
+
+	// Sub-resources with at least this much data are decoded on the WorkerThreadPool,
+	// if the file is in memory so they can be read from several threads at once.
+	static const uint64_t PARALLEL_DECODE_MIN_SIZE = 64 * 1024;
+
+	struct PropertyDecodeTask {
+		ResourceLoaderBinary *loader = nullptr;
+		LocalVector<Pair<StringName, Variant>> properties;
+		Error error = OK;
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID;
+	};
+
+	static void _decode_properties_task(void *p_userdata);
+	ResourceLoaderBinary *_create_decode_loader(uint64_t p_offset) const;
+	Error _parse_properties(LocalVector<Pair<StringName, Variant>> &r_properties);
+	void _set_properties(Resource *p_res, MissingResource *p_missing_resource, LocalVector<Pair<StringName, Variant>> &p_properties);
 
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
@@ -36,14 +36,9 @@
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant_parser.h"
 
-#ifdef DEBUG_LOAD_THREADED
-#define print_lt(m_text) print_line(m_text)
-#else
-#define print_lt(m_text)
-#endif
-
 Ref<ResourceFormatLoader> ResourceLoader::loader[ResourceLoader::MAX_LOADERS];
 
 int ResourceLoader::loader_count = 0;
@@ -231,12 +226,7 @@ Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_origin
 
 void ResourceLoader::_thread_load_function(void *p_userdata) {
 	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
-	load_task.loader_id = Thread::get_caller_id();
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok from semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
-	}
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
@@ -248,21 +238,10 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
 	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
-
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-
 		for (int i = 0; i < load_task.poll_requests; i++) {
 			load_task.semaphore->post();
 		}
-		memdelete(load_task.semaphore);
-		load_task.semaphore = nullptr;
+		load_task.poll_requests = 0;
 	}
 
 	if (load_task.resource.is_valid()) {
@@ -290,6 +269,55 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	thread_load_mutex->unlock();
 }
 
+void ResourceLoader::_thread_load_queued(void *p_queue) {
+	List<String> *queue = (List<String> *)p_queue;
+
+	thread_load_mutex->lock();
+	if (queue->is_empty()) {
+		// Loads are taken out of the queue by the threads waiting for them, see _thread_load_wait().
+		thread_load_mutex->unlock();
+		return;
+	}
+	ThreadLoadTask &load_task = thread_load_tasks[queue->front()->get()];
+	queue->pop_front();
+	load_task.queued = false;
+	load_task.loader_id = Thread::get_caller_id();
+	thread_load_mutex->unlock();
+
+	_thread_load_function(&load_task);
+}
+
+// Called with thread_load_mutex locked, which is unlocked while waiting.
+Error ResourceLoader::_thread_load_wait(ThreadLoadTask &p_load_task) {
+	if (p_load_task.queued) {
+		// No thread took it yet, so load it here instead of waiting for one. On a pool thread,
+		// waiting could keep it from ever starting, if every other pool thread waits too.
+		p_load_task.queued = false;
+		(p_load_task.high_priority ? thread_load_queue_high : thread_load_queue_low).erase(p_load_task.local_path);
+		p_load_task.loader_id = Thread::get_caller_id();
+
+		thread_load_mutex->unlock();
+		_thread_load_function(&p_load_task);
+		thread_load_mutex->lock();
+	} else if (p_load_task.status == THREAD_LOAD_IN_PROGRESS) {
+		// Already loading on another thread. Block even on a pool thread: processing other queued
+		// tasks meanwhile may start a load that waits for one suspended lower on this stack. Loads
+		// that did not start are run by their waiter, so that thread only waits for running loads
+		// in turn, and keeps making progress.
+		ERR_FAIL_COND_V_MSG(p_load_task.loader_id == Thread::get_caller_id(), ERR_BUSY, "Attempted to wait for a resource being loaded lower on this thread's stack, cyclic reference?");
+		if (!p_load_task.semaphore) {
+			p_load_task.semaphore = memnew(Semaphore);
+		}
+		Semaphore *semaphore = p_load_task.semaphore;
+		p_load_task.poll_requests++;
+
+		thread_load_mutex->unlock();
+		semaphore->wait();
+		thread_load_mutex->lock();
+	}
+	return OK;
+}
+
 static String _validate_local_path(const String &p_path) {
 	ResourceUID::ID uid = ResourceUID::get_singleton()->text_to_id(p_path);
 	if (uid != ResourceUID::INVALID_ID) {
@@ -300,7 +328,7 @@ static String _validate_local_path(const String &p_path) {
 		return ProjectSettings::get_singleton()->localize_path(p_path);
 	}
 }
-Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource) {
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, bool p_high_priority, const String &p_source_resource) {
 	String local_path = _validate_local_path(p_path);
 
 	thread_load_mutex->lock();
@@ -372,20 +400,15 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	ThreadLoadTask &load_task = thread_load_tasks[local_path];
 
 	if (load_task.resource.is_null()) { //needs to be loaded in thread
-
-		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
-		} else {
-			thread_waiting_count++;
-		}
-
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-
-		load_task.thread = memnew(Thread);
-		load_task.thread->start(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+		// Dependencies are scheduled as high priority regardless of the request, as a load
+		// already running on the pool is waiting for them. Keeping them in the low priority
+		// queue could starve the parent task, which holds one of the low priority slots.
+		load_task.high_priority = p_high_priority || !p_source_resource.is_empty();
+		load_task.queued = true;
+		List<String> *queue = load_task.high_priority ? &thread_load_queue_high : &thread_load_queue_low;
+		queue->push_back(local_path);
+		// The pool task takes whichever load is first in the queue by then, if any.
+		WorkerThreadPool::get_singleton()->add_native_pool_task(&ResourceLoader::_thread_load_queued, queue, load_task.high_priority, "Load queued resource");
 	}
 
 	thread_load_mutex->unlock();
@@ -449,60 +472,26 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 
 	ThreadLoadTask &load_task = thread_load_tasks[local_path];
 
-	//semaphore still exists, meaning it's still loading, request poll
-	Semaphore *semaphore = load_task.semaphore;
-	if (semaphore) {
-		load_task.poll_requests++;
-
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "exchange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
-			}
-
-			thread_suspended_count++;
-
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-		}
+	Error wait_error = _thread_load_wait(load_task);
 
+	if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
 		thread_load_mutex->unlock();
-		semaphore->wait();
-		thread_load_mutex->lock();
-
-		thread_suspended_count--;
-
-		if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
-			thread_load_mutex->unlock();
-			if (r_error) {
-				*r_error = ERR_INVALID_PARAMETER;
-			}
-			return Ref<Resource>();
+		if (r_error) {
+			*r_error = ERR_INVALID_PARAMETER;
 		}
+		return Ref<Resource>();
 	}
 
 	Ref<Resource> resource = load_task.resource;
 	if (r_error) {
-		*r_error = load_task.error;
+		*r_error = wait_error != OK ? wait_error : load_task.error;
 	}
 
 	load_task.requests--;
 
 	if (load_task.requests == 0) {
-		if (load_task.thread) { //thread may not have been used
-			load_task.thread->wait_to_finish();
-			memdelete(load_task.thread);
+		if (load_task.semaphore) {
+			memdelete(load_task.semaphore);
 		}
 		thread_load_tasks.erase(local_path);
 	}
@@ -944,31 +933,35 @@ void ResourceLoader::clear_translation_remaps() {
 }
 
 void ResourceLoader::clear_thread_load_tasks() {
+	// Loads must be done before their data is freed. Loads still running may request new
+	// dependencies in the meantime, so repeat until none is left.
 	thread_load_mutex->lock();
+	while (true) {
+		ThreadLoadTask *load_task = nullptr;
+		for (KeyValue<String, ResourceLoader::ThreadLoadTask> &E : thread_load_tasks) {
+			if (E.value.status == THREAD_LOAD_IN_PROGRESS) {
+				load_task = &E.value;
+				break;
+			}
+		}
+		if (!load_task) {
+			break;
+		}
+		// Hold a request, so it's not erased by a getter while waiting.
+		load_task->requests++;
+		Error err = _thread_load_wait(*load_task);
+		load_task->requests--;
+		if (err != OK) {
+			break;
+		}
+	}
 
 	for (KeyValue<String, ResourceLoader::ThreadLoadTask> &E : thread_load_tasks) {
-		switch (E.value.status) {
-			case ResourceLoader::ThreadLoadStatus::THREAD_LOAD_LOADED: {
-				E.value.resource = Ref<Resource>();
-			} break;
-
-			case ResourceLoader::ThreadLoadStatus::THREAD_LOAD_IN_PROGRESS: {
-				if (E.value.thread != nullptr) {
-					E.value.thread->wait_to_finish();
-					memdelete(E.value.thread);
-					E.value.thread = nullptr;
-				}
-				E.value.resource = Ref<Resource>();
-			} break;
-
-			case ResourceLoader::ThreadLoadStatus::THREAD_LOAD_FAILED:
-			default: {
-				// do nothing
-			}
+		if (E.value.semaphore) {
+			memdelete(E.value.semaphore);
 		}
 	}
 	thread_load_tasks.clear();
-
 	thread_load_mutex->unlock();
 }
 
@@ -1068,16 +1061,10 @@ void ResourceLoader::remove_custom_loaders() {
 
 void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
-	thread_load_max = OS::get_singleton()->get_processor_count();
-	thread_loading_count = 0;
-	thread_waiting_count = 0;
-	thread_suspended_count = 0;
-	thread_load_semaphore = memnew(Semaphore);
 }
 
 void ResourceLoader::finalize() {
 	memdelete(thread_load_mutex);
-	memdelete(thread_load_semaphore);
 }
 
 ResourceLoadErrorNotify ResourceLoader::err_notify = nullptr;
@@ -1092,12 +1079,8 @@ bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
-Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
-
-int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
-int ResourceLoader::thread_suspended_count = 0;
-int ResourceLoader::thread_load_max = 0;
+List<String> ResourceLoader::thread_load_queue_high;
+List<String> ResourceLoader::thread_load_queue_low;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
@@ -35,6 +35,7 @@
 #include "core/object/class_db.h"
 #include "core/object/ref_counted.h"
 #include "core/os/os.h"
+#include "core/templates/small_vector.h"
 #include "core/variant/variant_parser.h"
 
 Error Expression::_get_token(Token &r_token) {
@@ -1372,8 +1373,8 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 		case Expression::ENode::TYPE_CONSTRUCTOR: {
 			const Expression::ConstructorNode *constructor = static_cast<const Expression::ConstructorNode *>(p_node);
 
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
+			SmallVector<Variant, 4> arr;
+			SmallVector<const Variant *, 4> argp;
 			arr.resize(constructor->arguments.size());
 			argp.resize(constructor->arguments.size());
 
@@ -1384,8 +1385,8 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 				if (ret) {
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
+				arr[i] = value;
+				argp[i] = &arr[i];
 			}
 
 			Callable::CallError ce;
@@ -1400,8 +1401,8 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 		case Expression::ENode::TYPE_BUILTIN_FUNC: {
 			const Expression::BuiltinFuncNode *bifunc = static_cast<const Expression::BuiltinFuncNode *>(p_node);
 
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
+			SmallVector<Variant, 4> arr;
+			SmallVector<const Variant *, 4> argp;
 			arr.resize(bifunc->arguments.size());
 			argp.resize(bifunc->arguments.size());
 
@@ -1411,8 +1412,8 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 				if (ret) {
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
+				arr[i] = value;
+				argp[i] = &arr[i];
 			}
 
 			r_ret = Variant(); //may not return anything
@@ -1434,8 +1435,8 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 				return true;
 			}
 
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
+			SmallVector<Variant, 4> arr;
+			SmallVector<const Variant *, 4> argp;
 			arr.resize(call->arguments.size());
 			argp.resize(call->arguments.size());
 
@@ -1446,8 +1447,8 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 				if (ret) {
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
+				arr[i] = value;
+				argp[i] = &arr[i];
 			}
 
 			Callable::CallError ce;
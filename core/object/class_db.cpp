@@ -340,6 +340,20 @@ Object *ClassDB::instantiate(const StringName &p_class) {
 	}
 }
 
+ClassDB::CreationFunc ClassDB::get_creation_func(const StringName &p_class) {
+	OBJTYPE_RLOCK;
+	ClassInfo *ti = classes.getptr(p_class);
+	if (!ti || ti->disabled || !ti->creation_func || ti->gdextension) {
+		return nullptr;
+	}
+#ifdef TOOLS_ENABLED
+	if (ti->api == API_EDITOR && !Engine::get_singleton()->is_editor_hint()) {
+		return nullptr;
+	}
+#endif
+	return ti->creation_func;
+}
+
 void ClassDB::set_object_extension_instance(Object *p_object, const StringName &p_class, GDExtensionClassInstancePtr p_instance) {
 	ERR_FAIL_COND(!p_object);
 	ClassInfo *ti;
@@ -1203,6 +1217,24 @@ StringName ClassDB::get_property_setter(const StringName &p_class, const StringN
 	return StringName();
 }
 
+MethodBind *ClassDB::get_property_setter_bind(const StringName &p_class, const StringName &p_property, int *r_index) {
+	ClassInfo *type = classes.getptr(p_class);
+	ClassInfo *check = type;
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			if (r_index) {
+				*r_index = psg->index;
+			}
+			return psg->_setptr;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
 StringName ClassDB::get_property_getter(const StringName &p_class, const StringName &p_property) {
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
@@ -38,6 +38,7 @@
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 
 #ifdef DEBUG_ENABLED
@@ -966,11 +967,6 @@ bool Object::_has_user_signal(const StringName &p_name) const {
 	return signal_map[p_name].user.name.length() > 0;
 }
 
-struct _ObjectSignalDisconnectData {
-	StringName signal;
-	Callable callable;
-};
-
 Error Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
 
@@ -1012,23 +1008,23 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
-	List<_ObjectSignalDisconnectData> disconnect_data;
-
-	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Callable, SignalData::Slot> slot_map = s->slot_map;
+	// Only takes a reference, the targets are copied on write if connections
+	// change or this object is freed during the emission.
+	const Vector<SignalData::Target> targets = s->targets;
+	const SignalData::Target *target_list = targets.ptr();
+	const int target_count = targets.size();
 
-	int ssize = slot_map.size();
+	LocalVector<Callable> one_shot_callables;
 
 	OBJ_DEBUG_LOCK
 
 	Error err = OK;
 
-	for (int i = 0; i < ssize; i++) {
-		const Connection &c = slot_map.getv(i).conn;
+	for (int i = 0; i < target_count; i++) {
+		const SignalData::Target &t = target_list[i];
 
-		Object *target = c.callable.get_object();
+		const bool custom = t.callable.is_custom();
+		Object *target = custom ? t.callable.get_object() : ObjectDB::get_instance(t.object_id);
 		if (!target) {
 			// Target might have been deleted during signal callback, this is expected and OK.
 			continue;
@@ -1037,55 +1033,65 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		const Variant **args = p_args;
 		int argc = p_argcount;
 
-		if (c.flags & CONNECT_DEFERRED) {
-			MessageQueue::get_singleton()->push_callablep(c.callable, args, argc, true);
+		if (t.flags & CONNECT_DEFERRED) {
+			MessageQueue::get_singleton()->push_callablep(t.callable, args, argc, true);
 		} else {
 			Callable::CallError ce;
 			_emitting = true;
 			Variant ret;
-			c.callable.callp(args, argc, ret, ce);
+			if (custom) {
+				t.callable.callp(args, argc, ret, ce);
+			} else {
+				// Same as Callable::callp(), without looking up the object again.
+				ret = target->callp(t.method, args, argc, ce);
+			}
 			_emitting = false;
 
 			if (ce.error != Callable::CallError::CALL_OK) {
 #ifdef DEBUG_ENABLED
-				if (c.flags & CONNECT_PERSIST && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
+				if (t.flags & CONNECT_PERSIST && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
 					continue;
 				}
 #endif
 				if (ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD && !ClassDB::class_exists(target->get_class_name())) {
 					//most likely object is not initialized yet, do not throw error.
 				} else {
-					ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(c.callable, args, argc, ce) + ".");
+					ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(t.callable, args, argc, ce) + ".");
 					err = ERR_METHOD_NOT_FOUND;
 				}
 			}
 		}
 
-		bool disconnect = c.flags & CONNECT_ONE_SHOT;
+		bool disconnect = t.flags & CONNECT_ONE_SHOT;
 #ifdef TOOLS_ENABLED
-		if (disconnect && (c.flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
+		if (disconnect && (t.flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
 			//this signal was connected from the editor, and is being edited. just don't disconnect for now
 			disconnect = false;
 		}
 #endif
 		if (disconnect) {
-			_ObjectSignalDisconnectData dd;
-			dd.signal = p_name;
-			dd.callable = c.callable;
-			disconnect_data.push_back(dd);
+			one_shot_callables.push_back(t.callable);
 		}
 	}
 
-	while (!disconnect_data.is_empty()) {
-		const _ObjectSignalDisconnectData &dd = disconnect_data.front()->get();
-
-		_disconnect(dd.signal, dd.callable);
-		disconnect_data.pop_front();
+	for (const Callable &callable : one_shot_callables) {
+		_disconnect(p_name, callable);
 	}
 
 	return err;
 }
 
+void Object::SignalData::insert_target(int p_index, const Connection &p_connection) {
+	Target t;
+	t.callable = p_connection.callable;
+	t.flags = p_connection.flags;
+	if (!p_connection.callable.is_custom()) {
+		t.object_id = p_connection.callable.get_object_id();
+		t.method = p_connection.callable.get_method();
+	}
+	targets.insert(p_index, t);
+}
+
 void Object::_add_user_signal(const String &p_name, const Array &p_args) {
 	// this version of add_user_signal is meant to be used from scripts or external apis
 	// without access to ADD_SIGNAL in bind_methods
@@ -1284,7 +1290,8 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 	}
 
 	//use callable version as key, so binds can be ignored
-	s->slot_map[*target.get_base_comparator()] = slot;
+	int index = s->slot_map.insert(*target.get_base_comparator(), slot);
+	s->insert_target(index, conn);
 
 	return OK;
 }
@@ -1340,6 +1347,9 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	}
 
 	target_object->connections.erase(slot->cE);
+	// Drop the target right away, so it doesn't keep the callable, its binds
+	// and the references they hold alive until the next emission.
+	s->targets.remove_at(s->slot_map.find(*p_callable.get_base_comparator()));
 	s->slot_map.erase(*p_callable.get_base_comparator());
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
@@ -1832,9 +1842,10 @@ void postinitialize_handler(Object *p_object) {
 void ObjectDB::debug_objects(DebugFunc p_func) {
 	spin_lock.lock();
 
-	for (uint32_t i = 0, count = slot_count; i < slot_max && count != 0; i++) {
-		if (object_slots[i].validator) {
-			p_func(object_slots[i].object);
+	for (uint32_t i = 0, count = slot_count; i < slot_max.load(std::memory_order_relaxed) && count != 0; i++) {
+		ObjectSlot &object_slot = _get_slot(i);
+		if (object_slot.validator.load(std::memory_order_relaxed)) {
+			p_func(object_slot.object.load(std::memory_order_relaxed));
 			count--;
 		}
 	}
@@ -1886,8 +1897,9 @@ void Object::get_argument_options(const StringName &p_function, int p_idx, List<
 
 SpinLock ObjectDB::spin_lock;
 uint32_t ObjectDB::slot_count = 0;
-uint32_t ObjectDB::slot_max = 0;
-ObjectDB::ObjectSlot *ObjectDB::object_slots = nullptr;
+std::atomic<uint32_t> ObjectDB::slot_max = { 0 };
+ObjectDB::ObjectSlot *ObjectDB::object_blocks[OBJECTDB_MAX_BLOCKS] = {};
+uint32_t *ObjectDB::free_slots = nullptr;
 uint64_t ObjectDB::validator_counter = 0;
 
 int ObjectDB::get_object_count() {
@@ -1896,32 +1908,39 @@ int ObjectDB::get_object_count() {
 
 ObjectID ObjectDB::add_instance(Object *p_object) {
 	spin_lock.lock();
-	if (unlikely(slot_count == slot_max)) {
+	uint32_t current_slot_max = slot_max.load(std::memory_order_relaxed);
+	if (unlikely(slot_count == current_slot_max)) {
 		CRASH_COND(slot_count == (1 << OBJECTDB_SLOT_MAX_COUNT_BITS));
 
-		uint32_t new_slot_max = slot_max > 0 ? slot_max * 2 : 1;
-		object_slots = (ObjectSlot *)memrealloc(object_slots, sizeof(ObjectSlot) * new_slot_max);
-		for (uint32_t i = slot_max; i < new_slot_max; i++) {
-			object_slots[i].object = nullptr;
-			object_slots[i].is_ref_counted = false;
-			object_slots[i].next_free = i;
-			object_slots[i].validator = 0;
+		ObjectSlot *block = (ObjectSlot *)memalloc(sizeof(ObjectSlot) * OBJECTDB_BLOCK_SIZE);
+		for (uint32_t i = 0; i < OBJECTDB_BLOCK_SIZE; i++) {
+			memnew_placement(&block[i].validator, std::atomic<uint64_t>(0));
+			memnew_placement(&block[i].object, std::atomic<Object *>(nullptr));
+		}
+		object_blocks[current_slot_max >> OBJECTDB_BLOCK_BITS] = block;
+
+		uint32_t new_slot_max = current_slot_max + OBJECTDB_BLOCK_SIZE;
+		free_slots = (uint32_t *)memrealloc(free_slots, sizeof(uint32_t) * new_slot_max);
+		for (uint32_t i = current_slot_max; i < new_slot_max; i++) {
+			free_slots[i] = i;
 		}
-		slot_max = new_slot_max;
+		// Publish the block before lookups can accept its slots.
+		slot_max.store(new_slot_max, std::memory_order_release);
 	}
 
-	uint32_t slot = object_slots[slot_count].next_free;
-	if (object_slots[slot].object != nullptr) {
+	uint32_t slot = free_slots[slot_count];
+	ObjectSlot &object_slot = _get_slot(slot);
+	if (object_slot.object.load(std::memory_order_relaxed) != nullptr) {
 		spin_lock.unlock();
-		ERR_FAIL_COND_V(object_slots[slot].object != nullptr, ObjectID());
+		ERR_FAIL_COND_V(object_slot.object.load(std::memory_order_relaxed) != nullptr, ObjectID());
 	}
-	object_slots[slot].object = p_object;
-	object_slots[slot].is_ref_counted = p_object->is_ref_counted();
 	validator_counter = (validator_counter + 1) & OBJECTDB_VALIDATOR_MASK;
 	if (unlikely(validator_counter == 0)) {
 		validator_counter = 1;
 	}
-	object_slots[slot].validator = validator_counter;
+	// The object must be visible before the validator that lets lookups return it.
+	object_slot.object.store(p_object, std::memory_order_release);
+	object_slot.validator.store(validator_counter, std::memory_order_release);
 
 	uint64_t id = validator_counter;
 	id <<= OBJECTDB_SLOT_MAX_COUNT_BITS;
@@ -1944,17 +1963,19 @@ void ObjectDB::remove_instance(Object *p_object) {
 
 	spin_lock.lock();
 
+	ObjectSlot &object_slot = _get_slot(slot);
+
 #ifdef DEBUG_ENABLED
 
-	if (object_slots[slot].object != p_object) {
+	if (object_slot.object.load(std::memory_order_relaxed) != p_object) {
 		spin_lock.unlock();
-		ERR_FAIL_COND(object_slots[slot].object != p_object);
+		ERR_FAIL_COND(object_slot.object.load(std::memory_order_relaxed) != p_object);
 	}
 	{
 		uint64_t validator = (t >> OBJECTDB_SLOT_MAX_COUNT_BITS) & OBJECTDB_VALIDATOR_MASK;
-		if (object_slots[slot].validator != validator) {
+		if (object_slot.validator.load(std::memory_order_relaxed) != validator) {
 			spin_lock.unlock();
-			ERR_FAIL_COND(object_slots[slot].validator != validator);
+			ERR_FAIL_COND(object_slot.validator.load(std::memory_order_relaxed) != validator);
 		}
 	}
 
@@ -1962,11 +1983,10 @@ void ObjectDB::remove_instance(Object *p_object) {
 	//decrease slot count
 	slot_count--;
 	//set the free slot properly
-	object_slots[slot_count].next_free = slot;
-	//invalidate, so checks against it fail
-	object_slots[slot].validator = 0;
-	object_slots[slot].is_ref_counted = false;
-	object_slots[slot].object = nullptr;
+	free_slots[slot_count] = slot;
+	//invalidate, so checks against it fail. This must happen before the object changes, see get_instance().
+	object_slot.validator.store(0, std::memory_order_release);
+	object_slot.object.store(nullptr, std::memory_order_release);
 
 	spin_lock.unlock();
 }
@@ -1988,9 +2008,10 @@ void ObjectDB::cleanup() {
 			MethodBind *resource_get_path = ClassDB::get_method("Resource", "get_path");
 			Callable::CallError call_error;
 
-			for (uint32_t i = 0, count = slot_count; i < slot_max && count != 0; i++) {
-				if (object_slots[i].validator) {
-					Object *obj = object_slots[i].object;
+			for (uint32_t i = 0, count = slot_count; i < slot_max.load(std::memory_order_relaxed) && count != 0; i++) {
+				ObjectSlot &object_slot = _get_slot(i);
+				if (object_slot.validator.load(std::memory_order_relaxed)) {
+					Object *obj = object_slot.object.load(std::memory_order_relaxed);
 
 					String extra_info;
 					if (obj->is_class("Node")) {
@@ -2000,7 +2021,7 @@ void ObjectDB::cleanup() {
 						extra_info = " - Resource path: " + String(resource_get_path->call(obj, nullptr, 0, call_error));
 					}
 
-					uint64_t id = uint64_t(i) | (uint64_t(object_slots[i].validator) << OBJECTDB_VALIDATOR_BITS) | (object_slots[i].is_ref_counted ? OBJECTDB_REFERENCE_BIT : 0);
+					uint64_t id = uint64_t(i) | (uint64_t(object_slot.validator.load(std::memory_order_relaxed)) << OBJECTDB_SLOT_MAX_COUNT_BITS) | (obj->is_ref_counted() ? OBJECTDB_REFERENCE_BIT : 0);
 					print_line("Leaked instance: " + String(obj->get_class()) + ":" + itos(id) + extra_info);
 
 					count--;
@@ -2011,7 +2032,13 @@ void ObjectDB::cleanup() {
 		spin_lock.unlock();
 	}
 
-	if (object_slots) {
-		memfree(object_slots);
+	for (uint32_t i = 0; i < slot_max.load(std::memory_order_relaxed) >> OBJECTDB_BLOCK_BITS; i++) {
+		memfree(object_blocks[i]);
+		object_blocks[i] = nullptr;
+	}
+	if (free_slots) {
+		memfree(free_slots);
+		free_slots = nullptr;
 	}
+	slot_max.store(0, std::memory_order_relaxed);
 }
@@ -589,8 +589,21 @@ private:
 			List<Connection>::Element *cE = nullptr;
 		};
 
+		// What emitting needs from each slot, kept contiguous and in the same
+		// order as slot_map. Emissions hold a reference to it, so connecting
+		// or disconnecting during one affects the next one.
+		struct Target {
+			Callable callable;
+			ObjectID object_id; // Of non-custom callables, resolved once per call.
+			StringName method;
+			uint32_t flags = 0;
+		};
+
 		MethodInfo user;
 		VMap<Callable, Slot> slot_map;
+		Vector<Target> targets;
+
+		void insert_target(int p_index, const Connection &p_connection);
 	};
 
 	HashMap<StringName, SignalData> signal_map;
@@ -939,17 +952,24 @@ class ObjectDB {
 #define OBJECTDB_SLOT_MAX_COUNT_MASK ((uint64_t(1) << OBJECTDB_SLOT_MAX_COUNT_BITS) - 1)
 #define OBJECTDB_REFERENCE_BIT (uint64_t(1) << (OBJECTDB_SLOT_MAX_COUNT_BITS + OBJECTDB_VALIDATOR_BITS))
 
+	// Slots are allocated in blocks that never move, so lookups can read them
+	// without locking while other threads add and remove instances.
+#define OBJECTDB_BLOCK_BITS 12
+#define OBJECTDB_BLOCK_SIZE (1 << OBJECTDB_BLOCK_BITS)
+#define OBJECTDB_BLOCK_MASK (OBJECTDB_BLOCK_SIZE - 1)
+#define OBJECTDB_MAX_BLOCKS (1 << (OBJECTDB_SLOT_MAX_COUNT_BITS - OBJECTDB_BLOCK_BITS))
+
 	struct ObjectSlot { // 128 bits per slot.
-		uint64_t validator : OBJECTDB_VALIDATOR_BITS;
-		uint64_t next_free : OBJECTDB_SLOT_MAX_COUNT_BITS;
-		uint64_t is_ref_counted : 1;
-		Object *object = nullptr;
+		std::atomic<uint64_t> validator; // 0 when free.
+		std::atomic<Object *> object;
 	};
 
+	// Only needed to add and remove instances, lookups don't lock.
 	static SpinLock spin_lock;
 	static uint32_t slot_count;
-	static uint32_t slot_max;
-	static ObjectSlot *object_slots;
+	static std::atomic<uint32_t> slot_max;
+	static ObjectSlot *object_blocks[OBJECTDB_MAX_BLOCKS];
+	static uint32_t *free_slots;
 	static uint64_t validator_counter;
 
 	friend class Object;
@@ -962,6 +982,10 @@ class ObjectDB {
 	friend void register_core_types();
 	static void setup();
 
+	_ALWAYS_INLINE_ static ObjectSlot &_get_slot(uint32_t p_slot) {
+		return object_blocks[p_slot >> OBJECTDB_BLOCK_BITS][p_slot & OBJECTDB_BLOCK_MASK];
+	}
+
 public:
 	typedef void (*DebugFunc)(Object *p_obj);
 
@@ -969,20 +993,23 @@ public:
 		uint64_t id = p_instance_id;
 		uint32_t slot = id & OBJECTDB_SLOT_MAX_COUNT_MASK;
 
-		ERR_FAIL_COND_V(slot >= slot_max, nullptr); // This should never happen unless RID is corrupted.
-
-		spin_lock.lock();
+		ERR_FAIL_COND_V(slot >= slot_max.load(std::memory_order_acquire), nullptr); // This should never happen unless RID is corrupted.
 
+		const ObjectSlot &object_slot = _get_slot(slot);
 		uint64_t validator = (id >> OBJECTDB_SLOT_MAX_COUNT_BITS) & OBJECTDB_VALIDATOR_MASK;
 
-		if (unlikely(object_slots[slot].validator != validator)) {
-			spin_lock.unlock();
+		if (unlikely(object_slot.validator.load(std::memory_order_acquire) != validator)) {
 			return nullptr;
 		}
 
-		Object *object = object_slots[slot].object;
+		Object *object = object_slot.object.load(std::memory_order_acquire);
 
-		spin_lock.unlock();
+		// The slot may have been freed and reused since the first check. The
+		// validator is cleared before the object is replaced, so if it still
+		// matches, the object belongs to this ID.
+		if (unlikely(object_slot.validator.load(std::memory_order_acquire) != validator)) {
+			return nullptr;
+		}
 
 		return object;
 	}
@@ -51,6 +51,7 @@ void WorkerThreadPool::_process_task_queue() {
 
 void WorkerThreadPool::_process_task(Task *p_task) {
 	bool low_priority = p_task->low_priority;
+	bool native_thread = p_task->native_thread;
 
 	if (p_task->group) {
 		// Handling a group
@@ -87,7 +88,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			memdelete(p_task->template_userdata); // This is no longer needed at this point, so get rid of it.
 		}
 
-		if (low_priority && use_native_low_priority_threads) {
+		if (native_thread) {
 			p_task->completed = true;
 			p_task->done_semaphore.post();
 			if (do_post) {
@@ -126,11 +127,18 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			p_task->callable.callp(nullptr, 0, ret, ce);
 		}
 
-		p_task->completed = true;
-		p_task->done_semaphore.post();
+		if (p_task->detached) {
+			// Nobody waits for it, so it gets rid of itself.
+			task_mutex.lock();
+			task_allocator.free(p_task);
+			task_mutex.unlock();
+		} else {
+			p_task->completed = true;
+			p_task->done_semaphore.post();
+		}
 	}
 
-	if (!use_native_low_priority_threads && low_priority) {
+	if (low_priority && !native_thread) {
 		// A low prioriry task was freed, so see if we can move a pending one to the high priority queue.
 		bool post = false;
 		task_mutex.lock();
@@ -142,7 +150,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		} else {
 			low_priority_threads_used.decrement();
 		}
-		task_mutex.lock();
+		task_mutex.unlock();
 		if (post) {
 			task_available_semaphore.post();
 		}
@@ -164,10 +172,11 @@ void WorkerThreadPool::_native_low_priority_thread_function(void *p_user) {
 	singleton->_process_task(task);
 }
 
-void WorkerThreadPool::_post_task(Task *p_task, bool p_high_priority) {
+void WorkerThreadPool::_post_task(Task *p_task, bool p_high_priority, bool p_allow_native_thread) {
 	task_mutex.lock();
 	p_task->low_priority = !p_high_priority;
-	if (!p_high_priority && use_native_low_priority_threads) {
+	p_task->native_thread = !p_high_priority && use_native_low_priority_threads && p_allow_native_thread;
+	if (p_task->native_thread) {
 		task_mutex.unlock();
 		p_task->low_priority_thread = native_thread_allocator.alloc();
 		p_task->low_priority_thread->start(_native_low_priority_thread_function, p_task); // Pask task directly to thread.
@@ -190,6 +199,18 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
 
+void WorkerThreadPool::add_native_pool_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
+	task_mutex.lock();
+	Task *task = task_allocator.alloc();
+	task->native_func = p_func;
+	task->native_func_userdata = p_userdata;
+	task->description = p_description;
+	task->detached = true;
+	task_mutex.unlock();
+
+	_post_task(task, p_high_priority, false);
+}
+
 WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description) {
 	task_mutex.lock();
 	// Get a free task
@@ -203,7 +224,7 @@ WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable,
 	tasks.insert(id, task);
 	task_mutex.unlock();
 
-	_post_task(task, p_high_priority);
+	_post_task(task, p_high_priority, true);
 
 	return id;
 }
@@ -249,7 +270,7 @@ void WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 
 	task_mutex.unlock();
 
-	if (use_native_low_priority_threads && task->low_priority) {
+	if (task->native_thread) {
 		task->low_priority_thread->wait_to_finish();
 		native_thread_allocator.free(task->low_priority_thread);
 	} else {
@@ -327,7 +348,7 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 	}
 
 	for (int i = 0; i < p_tasks; i++) {
-		_post_task(tasks_posted[i], p_high_priority);
+		_post_task(tasks_posted[i], p_high_priority, true);
 		if (!p_high_priority && use_native_low_priority_threads) {
 			group->low_priority_native_tasks[i] = tasks_posted[i];
 		}
@@ -407,17 +428,19 @@ void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 	task_mutex.unlock();
 }
 
+int WorkerThreadPool::get_thread_index() const {
+	const int *index = thread_ids.getptr(Thread::get_caller_id());
+	return index ? *index : -1;
+}
+
 void WorkerThreadPool::init(int p_thread_count, bool p_use_native_threads_low_priority, float p_low_priority_task_ratio) {
 	ERR_FAIL_COND(threads.size() > 0);
 	if (p_thread_count < 0) {
 		p_thread_count = OS::get_singleton()->get_default_thread_pool_size();
 	}
 
-	if (p_use_native_threads_low_priority) {
-		max_low_priority_threads = 0;
-	} else {
-		max_low_priority_threads = CLAMP(p_thread_count * p_low_priority_task_ratio, 1, p_thread_count);
-	}
+	// Also used with native low priority threads, by tasks that must run on the pool.
+	max_low_priority_threads = CLAMP(p_thread_count * p_low_priority_task_ratio, 1, p_thread_count);
 
 	use_native_low_priority_threads = p_use_native_threads_low_priority;
 
@@ -454,6 +477,8 @@ void WorkerThreadPool::finish() {
 	}
 
 	threads.clear();
+	thread_ids.clear();
+	exit_threads.clear();
 }
 
 void WorkerThreadPool::_bind_methods() {
@@ -83,6 +83,8 @@ private:
 		SelfList<Task> task_elem;
 		bool waiting = false; // Waiting for completion
 		bool low_priority = false;
+		bool native_thread = false; // Runs on low_priority_thread instead of a pool thread.
+		bool detached = false; // Not in tasks, frees itself when done.
 		BaseTemplateUserdata *template_userdata = nullptr;
 		Thread *low_priority_thread = nullptr;
 
@@ -125,7 +127,7 @@ private:
 	void _process_task_queue();
 	void _process_task(Task *task);
 
-	void _post_task(Task *p_task, bool p_high_priority);
+	void _post_task(Task *p_task, bool p_high_priority, bool p_allow_native_thread);
 
 	static WorkerThreadPool *singleton;
 
@@ -166,6 +168,10 @@ public:
 		return _add_task(Callable(), nullptr, nullptr, ud, p_high_priority, p_description);
 	}
 	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
+	// Low priority tasks added this way always wait for a pool thread, even when other low priority
+	// tasks get a system thread each. Use it when many low priority tasks may be added at once.
+	// The task frees itself when done and can't be waited for, the caller tracks its completion.
+	void add_native_pool_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
 	TaskID add_task(const Callable &p_action, bool p_high_priority = false, const String &p_description = String());
 
 	bool is_task_completed(TaskID p_task_id) const;
@@ -187,6 +193,7 @@ public:
 	void wait_for_group_task_completion(GroupID p_group);
 
 	_FORCE_INLINE_ int get_thread_count() const { return threads.size(); }
+	int get_thread_index() const; // Index of the calling thread in the pool, -1 if it's not a pool thread.
 
 	static WorkerThreadPool *get_singleton() { return singleton; }
 	void init(int p_thread_count = -1, bool p_use_native_threads_low_priority = true, float p_low_priority_task_ratio = 0.3);
@@ -0,0 +1,194 @@
+/**************************************************************************/
+/*  frame_allocator.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "frame_allocator.h"
+
+#include "core/error/error_macros.h"
+#include "core/typedefs.h"
+
+#include <string.h>
+
+namespace {
+
+enum {
+	HEADER_SIZE = 16, // Keeps allocations 16-byte aligned.
+	INITIAL_CAPACITY = 64 * 1024,
+	SHRINK_RATIO = 4,
+};
+
+_FORCE_INLINE_ size_t _align(size_t p_bytes) {
+	return (p_bytes + 15) & ~size_t(15);
+}
+
+struct FrameArena {
+	uint8_t *block = nullptr;
+	size_t capacity = 0;
+	size_t offset = 0;
+	uint32_t live = 0;
+	size_t peak = 0;
+	// Previous blocks that still had live allocations when the arena grew,
+	// linked through their first word. Released once the arena is empty.
+	uint8_t *retired = nullptr;
+
+	void release_retired() {
+		while (retired) {
+			uint8_t *next = *(uint8_t **)retired;
+			memfree(retired);
+			retired = next;
+		}
+	}
+
+	void grow(size_t p_bytes) {
+		size_t new_capacity = MAX(capacity * 2, (size_t)INITIAL_CAPACITY);
+		while (new_capacity < p_bytes) {
+			new_capacity *= 2;
+		}
+		if (block) {
+			if (live) {
+				*(uint8_t **)block = retired;
+				retired = block;
+			} else {
+				memfree(block);
+			}
+		}
+		block = (uint8_t *)memalloc(new_capacity);
+		capacity = new_capacity;
+		// Keep room for the retired list link.
+		offset = HEADER_SIZE;
+	}
+
+	~FrameArena() {
+		release_retired();
+		if (block) {
+			memfree(block);
+		}
+	}
+};
+
+thread_local FrameArena frame_arena;
+
+_FORCE_INLINE_ uint64_t &_get_size(void *p_memory) {
+	return *(uint64_t *)((uint8_t *)p_memory - HEADER_SIZE);
+}
+
+} // namespace
+
+void *FrameAllocator::alloc(size_t p_bytes) {
+	FrameArena &arena = frame_arena;
+
+	size_t size = HEADER_SIZE + _align(p_bytes);
+	if (unlikely(arena.offset + size > arena.capacity)) {
+		arena.grow(HEADER_SIZE + size);
+		CRASH_COND_MSG(!arena.block, "Out of memory");
+	}
+
+	uint8_t *mem = arena.block + arena.offset + HEADER_SIZE;
+	*(uint64_t *)(mem - HEADER_SIZE) = p_bytes;
+	arena.offset += size;
+	arena.peak = MAX(arena.peak, arena.offset);
+	arena.live++;
+	return mem;
+}
+
+void *FrameAllocator::realloc(void *p_memory, size_t p_bytes) {
+	if (!p_memory) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_memory);
+		return nullptr;
+	}
+
+	FrameArena &arena = frame_arena;
+	uint8_t *mem = (uint8_t *)p_memory;
+	uint64_t &size = _get_size(p_memory);
+
+	// The most recent allocation can grow or shrink in place.
+	if (mem + _align(size) == arena.block + arena.offset && size_t(mem - arena.block) + _align(p_bytes) <= arena.capacity) {
+		arena.offset = (mem - arena.block) + _align(p_bytes);
+		arena.peak = MAX(arena.peak, arena.offset);
+		size = p_bytes;
+		return p_memory;
+	}
+
+	void *new_mem = alloc(p_bytes);
+	memcpy(new_mem, p_memory, MIN(size, p_bytes));
+	free(p_memory);
+	return new_mem;
+}
+
+void FrameAllocator::free(void *p_memory) {
+	ERR_FAIL_NULL(p_memory);
+
+	FrameArena &arena = frame_arena;
+	ERR_FAIL_COND_MSG(arena.live == 0, "Frame allocation freed twice or on another thread.");
+
+	arena.live--;
+	if (arena.live == 0) {
+		arena.release_retired();
+		arena.offset = HEADER_SIZE;
+		return;
+	}
+
+	uint8_t *mem = (uint8_t *)p_memory;
+	if (mem + _align(_get_size(p_memory)) == arena.block + arena.offset) {
+		arena.offset = (mem - arena.block) - HEADER_SIZE;
+	}
+}
+
+void FrameAllocator::end_frame() {
+	FrameArena &arena = frame_arena;
+
+#ifdef DEV_ENABLED
+	if (arena.live) {
+		WARN_PRINT_ONCE("Frame allocations were not freed before the end of the frame.");
+	}
+#endif
+
+	if (!arena.live && arena.capacity > SHRINK_RATIO * MAX(arena.peak, (size_t)INITIAL_CAPACITY)) {
+		memfree(arena.block);
+		arena.block = nullptr;
+		arena.capacity = 0;
+		arena.grow(arena.peak);
+	}
+	arena.peak = 0;
+}
+
+size_t FrameAllocator::get_used() {
+	return frame_arena.block ? frame_arena.offset - HEADER_SIZE : 0;
+}
+
+size_t FrameAllocator::get_capacity() {
+	return frame_arena.capacity;
+}
+
+uint32_t FrameAllocator::get_live_allocations() {
+	return frame_arena.live;
+}
@@ -0,0 +1,76 @@
+/**************************************************************************/
+/*  frame_allocator.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FRAME_ALLOCATOR_H
+#define FRAME_ALLOCATOR_H
+
+#include "core/os/memory.h"
+
+// Linear allocator for short-lived buffers, with one arena per thread.
+//
+// Allocating bumps an offset in the arena of the calling thread, and freeing
+// only rewinds it for the most recent allocation. Once every allocation of a
+// thread has been freed, its arena starts over from the beginning, so buffers
+// that are allocated and released within a frame never reach `malloc` once
+// the arena has grown to the size a frame needs.
+//
+// Memory must be freed on the thread that allocated it, before the end of the
+// frame. Use it as the allocator of a LocalVector, or FrameTypedAllocator for
+// the elements of a HashMap.
+class FrameAllocator {
+public:
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_memory);
+
+	// Called by the main loop once per frame. Gives back memory left over by
+	// a frame that needed much more than usual.
+	static void end_frame();
+
+	// Statistics for the arena of the calling thread.
+	static size_t get_used();
+	static size_t get_capacity();
+	static uint32_t get_live_allocations();
+};
+
+template <class T>
+class FrameTypedAllocator {
+public:
+	template <class... Args>
+	_FORCE_INLINE_ T *new_allocation(const Args &&...p_args) { return memnew_placement(FrameAllocator::alloc(sizeof(T)), T(p_args...)); }
+	_FORCE_INLINE_ void delete_allocation(T *p_allocation) {
+		if (!std::is_trivially_destructible<T>::value) {
+			p_allocation->~T();
+		}
+		FrameAllocator::free(p_allocation);
+	}
+};
+
+#endif // FRAME_ALLOCATOR_H
@@ -33,8 +33,13 @@
 #include "core/error/error_macros.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+#include "core/os/size_class_allocator.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
@@ -65,14 +70,58 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
+// The size class allocator needs the size stored in the padding to find the
+// class of a block when it is freed, so it always pads.
+#if defined(DEBUG_ENABLED) || defined(SIZE_CLASS_ALLOCATOR_ENABLED)
+#define MEMORY_ALWAYS_PREPAD
+#endif
+
+static _FORCE_INLINE_ void *_alloc_block(size_t p_bytes) {
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	if (p_bytes <= SizeClassAllocator::MAX_SIZE) {
+		return SizeClassAllocator::alloc(SizeClassAllocator::get_size_class(p_bytes));
+	}
+#endif
+	return malloc(p_bytes);
+}
+
+static _FORCE_INLINE_ void _free_block(void *p_mem, size_t p_bytes) {
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	if (p_bytes <= SizeClassAllocator::MAX_SIZE) {
+		SizeClassAllocator::free(p_mem, SizeClassAllocator::get_size_class(p_bytes));
+		return;
+	}
+#endif
+	free(p_mem);
+}
+
+static void *_realloc_block(void *p_mem, size_t p_old_bytes, size_t p_bytes) {
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	bool old_small = p_old_bytes <= SizeClassAllocator::MAX_SIZE;
+	bool new_small = p_bytes <= SizeClassAllocator::MAX_SIZE;
+	if (old_small || new_small) {
+		if (old_small && new_small && SizeClassAllocator::get_size_class(p_old_bytes) == SizeClassAllocator::get_size_class(p_bytes)) {
+			return p_mem;
+		}
+		void *mem = _alloc_block(p_bytes);
+		if (mem) {
+			memcpy(mem, p_mem, MIN(p_old_bytes, p_bytes));
+			_free_block(p_mem, p_old_bytes);
+		}
+		return mem;
+	}
+#endif
+	return realloc(p_mem, p_bytes);
+}
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ALWAYS_PREPAD
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+	void *mem = _alloc_block(p_bytes + (prepad ? PAD_ALIGN : 0));
 
 	ERR_FAIL_COND_V(!mem, nullptr);
 
@@ -101,7 +150,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ALWAYS_PREPAD
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -121,12 +170,10 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			_free_block(mem, *s + PAD_ALIGN);
 			return nullptr;
 		} else {
-			*s = p_bytes;
-
-			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+			mem = (uint8_t *)_realloc_block(mem, *s + PAD_ALIGN, p_bytes + PAD_ALIGN);
 			ERR_FAIL_COND_V(!mem, nullptr);
 
 			s = (uint64_t *)mem;
@@ -149,7 +196,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ALWAYS_PREPAD
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -159,13 +206,13 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	if (prepad) {
 		mem -= PAD_ALIGN;
+		uint64_t *s = (uint64_t *)mem;
 
 #ifdef DEBUG_ENABLED
-		uint64_t *s = (uint64_t *)mem;
 		mem_usage.sub(*s);
 #endif
 
-		free(mem);
+		_free_block(mem, *s + PAD_ALIGN);
 	} else {
 		free(mem);
 	}
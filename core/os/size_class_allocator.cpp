@@ -0,0 +1,332 @@
+/**************************************************************************/
+/*  size_class_allocator.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "size_class_allocator.h"
+
+#include "core/error/error_macros.h"
+#include "core/os/mutex.h"
+
+#include <stdlib.h>
+#include <atomic>
+
+namespace {
+
+struct FreeBlock {
+	FreeBlock *next;
+};
+
+enum {
+	CHUNK_SIZE = 64 * 1024,
+	CHUNK_HEADER = 16, // Keeps blocks 16-byte aligned after the chunk link.
+	BATCH_BYTES = 8 * 1024,
+};
+
+const size_t class_sizes[SizeClassAllocator::CLASS_COUNT] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256,
+	320, 384, 448, 512,
+	640, 768, 896, 1024
+};
+
+// Shared state of a size class. Chunks are linked through their first word so
+// they stay reachable for leak checkers.
+struct CentralList {
+	BinaryMutex mutex;
+	FreeBlock *free = nullptr;
+	uint32_t free_count = 0;
+	uint64_t reserved = 0;
+	void *chunks = nullptr;
+};
+
+CentralList central[SizeClassAllocator::CLASS_COUNT];
+
+// Per-thread free lists. Counters are only written by the owning thread and
+// read with relaxed loads when gathering statistics.
+struct ThreadCache {
+	FreeBlock *free[SizeClassAllocator::CLASS_COUNT];
+	std::atomic<uint32_t> count[SizeClassAllocator::CLASS_COUNT];
+	std::atomic<uint64_t> allocations[SizeClassAllocator::CLASS_COUNT];
+	std::atomic<uint64_t> frees[SizeClassAllocator::CLASS_COUNT];
+	ThreadCache *prev;
+	ThreadCache *next;
+	bool registered;
+};
+
+// Live thread caches, plus the counters of caches whose threads exited.
+BinaryMutex registry_mutex;
+ThreadCache *registry = nullptr;
+std::atomic<uint64_t> retired_allocations[SizeClassAllocator::CLASS_COUNT];
+std::atomic<uint64_t> retired_frees[SizeClassAllocator::CLASS_COUNT];
+
+// Trivially destructible, so it stays usable until the thread is gone; the
+// guard below hands its blocks back when the thread exits.
+thread_local ThreadCache thread_cache;
+thread_local bool thread_cache_released = false;
+
+void _release_thread_cache();
+
+struct ThreadCacheGuard {
+	bool active = false;
+	~ThreadCacheGuard() {
+		if (active) {
+			_release_thread_cache();
+		}
+	}
+};
+
+thread_local ThreadCacheGuard thread_cache_guard;
+
+_FORCE_INLINE_ uint32_t _get_batch(uint32_t p_class) {
+	return CLAMP(BATCH_BYTES / class_sizes[p_class], (size_t)8, (size_t)64);
+}
+
+void _register_thread_cache() {
+	ThreadCache &cache = thread_cache;
+	thread_cache_guard.active = true;
+
+	MutexLock lock(registry_mutex);
+	cache.prev = nullptr;
+	cache.next = registry;
+	if (registry) {
+		registry->prev = &cache;
+	}
+	registry = &cache;
+	cache.registered = true;
+}
+
+// Returns `p_count` blocks starting at `p_first` to the shared list.
+void _give_back(uint32_t p_class, FreeBlock *p_first, FreeBlock *p_last, uint32_t p_count) {
+	CentralList &list = central[p_class];
+	MutexLock lock(list.mutex);
+	p_last->next = list.free;
+	list.free = p_first;
+	list.free_count += p_count;
+}
+
+void _release_thread_cache() {
+	ThreadCache &cache = thread_cache;
+
+	for (uint32_t i = 0; i < SizeClassAllocator::CLASS_COUNT; i++) {
+		FreeBlock *first = cache.free[i];
+		if (!first) {
+			continue;
+		}
+		FreeBlock *last = first;
+		while (last->next) {
+			last = last->next;
+		}
+		_give_back(i, first, last, cache.count[i].load(std::memory_order_relaxed));
+		cache.free[i] = nullptr;
+		cache.count[i].store(0, std::memory_order_relaxed);
+	}
+
+	{
+		MutexLock lock(registry_mutex);
+		for (uint32_t i = 0; i < SizeClassAllocator::CLASS_COUNT; i++) {
+			retired_allocations[i].fetch_add(cache.allocations[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			retired_frees[i].fetch_add(cache.frees[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		if (cache.prev) {
+			cache.prev->next = cache.next;
+		} else {
+			registry = cache.next;
+		}
+		if (cache.next) {
+			cache.next->prev = cache.prev;
+		}
+	}
+
+	cache.registered = false;
+	thread_cache_released = true;
+}
+
+// Moves up to `p_max` blocks from the shared list (carving a new chunk if it
+// is empty) and returns them as a chain.
+FreeBlock *_take(uint32_t p_class, uint32_t p_max, uint32_t &r_count) {
+	CentralList &list = central[p_class];
+	MutexLock lock(list.mutex);
+
+	if (!list.free) {
+		uint8_t *chunk = (uint8_t *)malloc(CHUNK_SIZE);
+		if (!chunk) {
+			r_count = 0;
+			return nullptr;
+		}
+		*(void **)chunk = list.chunks;
+		list.chunks = chunk;
+
+		size_t size = class_sizes[p_class];
+		uint32_t blocks = (CHUNK_SIZE - CHUNK_HEADER) / size;
+		FreeBlock *first = (FreeBlock *)(chunk + CHUNK_HEADER);
+		FreeBlock *block = first;
+		for (uint32_t i = 1; i < blocks; i++) {
+			FreeBlock *next = (FreeBlock *)((uint8_t *)block + size);
+			block->next = next;
+			block = next;
+		}
+		block->next = nullptr;
+
+		list.free = first;
+		list.free_count = blocks;
+		list.reserved += blocks;
+	}
+
+	FreeBlock *first = list.free;
+	FreeBlock *last = first;
+	uint32_t count = 1;
+	while (count < p_max && last->next) {
+		last = last->next;
+		count++;
+	}
+	list.free = last->next;
+	list.free_count -= count;
+	last->next = nullptr;
+
+	r_count = count;
+	return first;
+}
+
+} // namespace
+
+size_t SizeClassAllocator::get_class_size(uint32_t p_class) {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_class, (uint32_t)CLASS_COUNT, 0);
+	return class_sizes[p_class];
+}
+
+void *SizeClassAllocator::alloc(uint32_t p_class) {
+	ThreadCache &cache = thread_cache;
+	if (unlikely(!cache.registered)) {
+		if (thread_cache_released) {
+			// Thread is shutting down, go straight to the shared list.
+			uint32_t count;
+			FreeBlock *block = _take(p_class, 1, count);
+			if (block) {
+				retired_allocations[p_class].fetch_add(1, std::memory_order_relaxed);
+			}
+			return block;
+		}
+		_register_thread_cache();
+	}
+
+	FreeBlock *block = cache.free[p_class];
+	uint32_t count = cache.count[p_class].load(std::memory_order_relaxed);
+	if (unlikely(!block)) {
+		block = _take(p_class, _get_batch(p_class), count);
+		if (!block) {
+			return nullptr;
+		}
+	}
+
+	cache.free[p_class] = block->next;
+	cache.count[p_class].store(count - 1, std::memory_order_relaxed);
+	cache.allocations[p_class].store(cache.allocations[p_class].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	return block;
+}
+
+void SizeClassAllocator::free(void *p_block, uint32_t p_class) {
+	FreeBlock *block = (FreeBlock *)p_block;
+
+	ThreadCache &cache = thread_cache;
+	if (unlikely(!cache.registered)) {
+		if (thread_cache_released) {
+			block->next = nullptr;
+			_give_back(p_class, block, block, 1);
+			retired_frees[p_class].fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		_register_thread_cache();
+	}
+
+	block->next = cache.free[p_class];
+	cache.free[p_class] = block;
+	uint32_t count = cache.count[p_class].load(std::memory_order_relaxed) + 1;
+	cache.frees[p_class].store(cache.frees[p_class].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	uint32_t batch = _get_batch(p_class);
+	if (unlikely(count > batch * 2)) {
+		// Give a batch back so blocks freed here can be reused by other threads.
+		FreeBlock *last = block;
+		for (uint32_t i = 1; i < batch; i++) {
+			last = last->next;
+		}
+		cache.free[p_class] = last->next;
+		count -= batch;
+		_give_back(p_class, block, last, batch);
+	}
+	cache.count[p_class].store(count, std::memory_order_relaxed);
+}
+
+SizeClassAllocator::Stats SizeClassAllocator::get_stats(uint32_t p_class) {
+	Stats stats;
+	ERR_FAIL_UNSIGNED_INDEX_V(p_class, (uint32_t)CLASS_COUNT, stats);
+
+	stats.size = class_sizes[p_class];
+	{
+		CentralList &list = central[p_class];
+		MutexLock lock(list.mutex);
+		stats.cached = list.free_count;
+		stats.reserved = list.reserved;
+	}
+
+	uint64_t frees = 0;
+	{
+		MutexLock lock(registry_mutex);
+		stats.allocations = retired_allocations[p_class].load(std::memory_order_relaxed);
+		frees = retired_frees[p_class].load(std::memory_order_relaxed);
+		for (ThreadCache *cache = registry; cache; cache = cache->next) {
+			stats.allocations += cache->allocations[p_class].load(std::memory_order_relaxed);
+			frees += cache->frees[p_class].load(std::memory_order_relaxed);
+			stats.cached += cache->count[p_class].load(std::memory_order_relaxed);
+		}
+	}
+
+	// Counters are read without stopping other threads, so clamp rather than
+	// report a wrapped value for blocks freed on a thread counted first.
+	stats.in_use = stats.allocations > frees ? stats.allocations - frees : 0;
+	return stats;
+}
+
+uint64_t SizeClassAllocator::get_used_bytes() {
+	uint64_t bytes = 0;
+	for (uint32_t i = 0; i < CLASS_COUNT; i++) {
+		bytes += get_stats(i).in_use * class_sizes[i];
+	}
+	return bytes;
+}
+
+uint64_t SizeClassAllocator::get_reserved_bytes() {
+	uint64_t bytes = 0;
+	for (uint32_t i = 0; i < CLASS_COUNT; i++) {
+		CentralList &list = central[i];
+		MutexLock lock(list.mutex);
+		bytes += list.reserved * class_sizes[i];
+	}
+	return bytes;
+}
@@ -0,0 +1,84 @@
+/**************************************************************************/
+/*  size_class_allocator.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SIZE_CLASS_ALLOCATOR_H
+#define SIZE_CLASS_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Small block allocator used behind Memory::alloc_static() when the engine is
+// built with `allocator=size_classes`.
+//
+// Requests up to MAX_SIZE bytes are rounded up to one of CLASS_COUNT size
+// classes. Each thread keeps a free list per class and only touches the shared
+// per-class list (under a lock) to refill or give back a batch of blocks, so the
+// common alloc/free pair is a couple of pointer swaps. Blocks are carved from
+// chunks that are never returned to the system.
+class SizeClassAllocator {
+public:
+	enum {
+		CLASS_COUNT = 20,
+		MAX_SIZE = 1024,
+	};
+
+	struct Stats {
+		size_t size = 0; // Block size of the class, in bytes.
+		uint64_t allocations = 0; // Total number of blocks handed out.
+		uint64_t in_use = 0; // Blocks currently allocated.
+		uint64_t cached = 0; // Free blocks held in thread and shared free lists.
+		uint64_t reserved = 0; // Blocks carved from chunks so far.
+	};
+
+	// Classes are 16 bytes apart up to 128 bytes, then four per power of two.
+	static _FORCE_INLINE_ uint32_t get_size_class(size_t p_bytes) {
+		if (p_bytes <= 128) {
+			return p_bytes ? (p_bytes - 1) >> 4 : 0;
+		} else if (p_bytes <= 256) {
+			return 4 + ((p_bytes - 1) >> 5);
+		} else if (p_bytes <= 512) {
+			return 8 + ((p_bytes - 1) >> 6);
+		} else {
+			return 12 + ((p_bytes - 1) >> 7);
+		}
+	}
+
+	static size_t get_class_size(uint32_t p_class);
+
+	static void *alloc(uint32_t p_class);
+	static void free(void *p_block, uint32_t p_class);
+
+	static Stats get_stats(uint32_t p_class);
+	static uint64_t get_used_bytes();
+	static uint64_t get_reserved_bytes();
+};
+
+#endif // SIZE_CLASS_ALLOCATOR_H
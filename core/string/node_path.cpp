@@ -31,6 +31,7 @@
 #include "node_path.h"
 
 #include "core/string/print_string.h"
+#include "core/templates/small_vector.h"
 
 void NodePath::_update_hash_cache() const {
 	uint32_t h = data->absolute ? 1 : 0;
@@ -367,7 +368,7 @@ NodePath::NodePath(const String &p_path) {
 	}
 
 	String path = p_path;
-	Vector<StringName> subpath;
+	SmallVector<StringName, 4> subpath;
 
 	bool absolute = (path[0] == '/');
 	bool last_is_slash = true;
@@ -39,38 +39,114 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
-
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
+std::atomic<StringName::Table *> StringName::table = { nullptr };
+StringName::Stripe StringName::stripes[STRIPE_COUNT];
+SafeNumeric<uint32_t> StringName::name_count;
 
 #ifdef DEBUG_ENABLED
 bool StringName::debug_stringname = false;
 #endif
 
+// Lookups don't lock: they walk the bucket chain and take a reference with
+// SafeRefCount::ref(), which fails for a name whose last reference is being
+// released. Insertions and removals lock one of the stripes, picked by the low
+// bits of the hash, so threads only contend when their names share a stripe.
+// A lookup that misses retries with the stripe locked before inserting, so a
+// chain changing under a lock-free lookup (e.g. while the table grows) only
+// costs a retry.
+//
+// Removed names may still be walked by lock-free lookups, so they are freed
+// with epoch-based reclamation: a lookup publishes the global epoch it started
+// in, the epoch only advances once every running lookup has seen the current
+// one, and a name removed during epoch E is freed once it reaches E + 2.
+
+namespace {
+
+enum {
+	MAX_READERS = 128, // Threads beyond this always lock.
+	RETIRE_BATCH = 64,
+};
+
+struct StringNameReader {
+	std::atomic<uint64_t> epoch = { 0 }; // `(epoch << 1) | 1` during a lookup, 0 otherwise.
+	std::atomic<bool> in_use = { false };
+};
+
+StringNameReader readers[MAX_READERS];
+std::atomic<uint64_t> global_epoch = { 1 };
+
+struct StringNameReaderSlot {
+	StringNameReader *reader = nullptr;
+	bool claimed = false;
+
+	~StringNameReaderSlot() {
+		if (reader) {
+			reader->epoch.store(0, std::memory_order_release);
+			reader->in_use.store(false, std::memory_order_release);
+		}
+	}
+};
+
+thread_local StringNameReaderSlot reader_slot;
+
+_FORCE_INLINE_ StringNameReader *get_reader() {
+	StringNameReaderSlot &slot = reader_slot;
+	if (likely(slot.claimed)) {
+		return slot.reader;
+	}
+	slot.claimed = true;
+	for (int i = 0; i < MAX_READERS; i++) {
+		bool expected = false;
+		if (readers[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+			slot.reader = &readers[i];
+			break;
+		}
+	}
+	return slot.reader;
+}
+
+void try_advance_epoch() {
+	uint64_t epoch = global_epoch.load(std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	for (int i = 0; i < MAX_READERS; i++) {
+		uint64_t reader_epoch = readers[i].epoch.load(std::memory_order_acquire);
+		if ((reader_epoch & 1) && (reader_epoch >> 1) != epoch) {
+			return; // A lookup started in an older epoch is still running.
+		}
+	}
+	global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_release, std::memory_order_relaxed);
+}
+
+} // namespace
+
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
+	Table *initial = memnew(Table);
+	initial->mask = STRING_TABLE_LEN - 1;
+	initial->buckets = memnew_arr(std::atomic<_Data *>, STRING_TABLE_LEN);
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+		initial->buckets[i].store(nullptr, std::memory_order_relaxed);
 	}
+	table.store(initial, std::memory_order_release);
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
+	Table *current = table.load(std::memory_order_acquire);
 
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
-		for (int i = 0; i < STRING_TABLE_LEN; i++) {
-			_Data *d = _table[i];
+		for (uint32_t i = 0; i <= current->mask; i++) {
+			_Data *d = current->buckets[i].load(std::memory_order_relaxed);
 			while (d) {
 				data.push_back(d);
-				d = d->next;
+				d = d->next.load(std::memory_order_relaxed);
 			}
 		}
 
@@ -80,10 +156,10 @@ void StringName::cleanup() {
 		int unreferenced_stringnames = 0;
 		int rarely_referenced_stringnames = 0;
 		for (int i = 0; i < data.size(); i++) {
-			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references));
-			if (data[i]->debug_references == 0) {
+			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references.get()));
+			if (data[i]->debug_references.get() == 0) {
 				unreferenced_stringnames += 1;
-			} else if (data[i]->debug_references < 5) {
+			} else if (data[i]->debug_references.get() < 5) {
 				rarely_referenced_stringnames += 1;
 			}
 		}
@@ -93,9 +169,9 @@ void StringName::cleanup() {
 	}
 #endif
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
+	for (uint32_t i = 0; i <= current->mask; i++) {
+		_Data *d = current->buckets[i].load(std::memory_order_relaxed);
+		while (d) {
 			if (d->static_count.get() != d->refcount.get()) {
 				lost_strings++;
 
@@ -108,22 +184,212 @@ void StringName::cleanup() {
 				}
 			}
 
-			_table[i] = _table[i]->next;
+			_Data *next = d->next.load(std::memory_order_relaxed);
 			memdelete(d);
+			d = next;
 		}
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
+
+	for (int i = 0; i < STRIPE_COUNT; i++) {
+		for (const Retired &retired : stripes[i].retired) {
+			memdelete(retired.data);
+		}
+		stripes[i].retired.reset();
+	}
+
+	while (current) {
+		Table *previous = current->previous;
+		memdelete_arr(current->buckets);
+		memdelete(current);
+		current = previous;
+	}
+	table.store(nullptr, std::memory_order_release);
+	name_count.set(0);
+
 	configured = false;
 }
 
+template <typename T>
+StringName::_Data *StringName::_find(const Table *p_table, uint32_t p_hash, const T &p_name) {
+	_Data *data = p_table->buckets[p_hash & p_table->mask].load(std::memory_order_acquire);
+	while (data) {
+		// compare hash first
+		if (data->hash == p_hash && data->get_name() == p_name) {
+			return data;
+		}
+		data = data->next.load(std::memory_order_acquire);
+	}
+	return nullptr;
+}
+
+template <typename T>
+StringName::_Data *StringName::_acquire(uint32_t p_hash, const T &p_name) {
+	StringNameReader *reader = get_reader();
+	if (reader) {
+		reader->epoch.store((global_epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		_Data *data = _find(table.load(std::memory_order_acquire), p_hash, p_name);
+		if (data && !data->refcount.ref()) {
+			data = nullptr; // Being released.
+		}
+
+		reader->epoch.store(0, std::memory_order_release);
+		if (data) {
+			return data;
+		}
+	}
+
+	// Not found, or this thread has no reader slot. The chains can only be
+	// trusted with the stripe locked.
+	MutexLock lock(stripes[p_hash & STRIPE_MASK].mutex);
+	_Data *data = _find(table.load(std::memory_order_relaxed), p_hash, p_name);
+	if (data && !data->refcount.ref()) {
+		data = nullptr;
+	}
+	return data;
+}
+
+template <typename T>
+StringName::_Data *StringName::_intern(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static) {
+	_Data *data = _acquire(p_hash, p_name);
+	bool created = false;
+	bool grow = false;
+
+	if (!data) {
+		MutexLock lock(stripes[p_hash & STRIPE_MASK].mutex);
+
+		// Another thread may have inserted it since the lookup.
+		Table *current = table.load(std::memory_order_relaxed);
+		data = _find(current, p_hash, p_name);
+		if (data && !data->refcount.ref()) {
+			data = nullptr; // Being released, insert a new one in front of it.
+		}
+
+		if (!data) {
+			data = memnew(_Data);
+			if (p_cname) {
+				data->cname = p_cname;
+			} else {
+				data->name = p_name;
+			}
+			data->refcount.init();
+			data->static_count.set(p_static ? 1 : 0);
+			data->hash = p_hash;
+#ifdef DEBUG_ENABLED
+			if (unlikely(debug_stringname)) {
+				// Keep in memory, force static.
+				data->refcount.ref();
+				data->static_count.increment();
+			}
+#endif
+
+			std::atomic<_Data *> &bucket = current->buckets[p_hash & current->mask];
+			_Data *head = bucket.load(std::memory_order_relaxed);
+			data->next.store(head, std::memory_order_relaxed);
+			if (head) {
+				head->prev = data;
+			}
+			bucket.store(data, std::memory_order_release);
+
+			created = true;
+			grow = name_count.increment() > current->mask + 1;
+		}
+	}
+
+	if (grow) {
+		_grow();
+	}
+
+	if (!created) {
+		// exists
+		if (p_static) {
+			data->static_count.increment();
+		}
+#ifdef DEBUG_ENABLED
+		if (unlikely(debug_stringname)) {
+			data->debug_references.increment();
+		}
+#endif
+	}
+	return data;
+}
+
+void StringName::_retire(Stripe &p_stripe, _Data *p_data) {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	Retired retired;
+	retired.data = p_data;
+	retired.epoch = global_epoch.load(std::memory_order_relaxed);
+	p_stripe.retired.push_back(retired);
+
+	if (p_stripe.retired.size() < RETIRE_BATCH) {
+		return;
+	}
+
+	try_advance_epoch();
+	uint64_t epoch = global_epoch.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < p_stripe.retired.size();) {
+		if (epoch - p_stripe.retired[i].epoch >= 2) {
+			memdelete(p_stripe.retired[i].data);
+			p_stripe.retired.remove_at_unordered(i);
+		} else {
+			i++;
+		}
+	}
+}
+
+void StringName::_grow() {
+	for (int i = 0; i < STRIPE_COUNT; i++) {
+		stripes[i].mutex.lock();
+	}
+
+	Table *current = table.load(std::memory_order_relaxed);
+	if (name_count.get() > current->mask + 1) {
+		// Names are relinked into the new buckets in place, lock-free lookups
+		// still walking the old chains may miss and retry locked, but always
+		// reach the end of a chain.
+		uint32_t len = (current->mask + 1) * 2;
+		Table *grown = memnew(Table);
+		grown->mask = len - 1;
+		grown->buckets = memnew_arr(std::atomic<_Data *>, len);
+		for (uint32_t i = 0; i < len; i++) {
+			grown->buckets[i].store(nullptr, std::memory_order_relaxed);
+		}
+
+		for (uint32_t i = 0; i <= current->mask; i++) {
+			_Data *data = current->buckets[i].load(std::memory_order_relaxed);
+			while (data) {
+				_Data *next = data->next.load(std::memory_order_relaxed);
+
+				std::atomic<_Data *> &bucket = grown->buckets[data->hash & grown->mask];
+				_Data *head = bucket.load(std::memory_order_relaxed);
+				data->prev = nullptr;
+				data->next.store(head, std::memory_order_release);
+				if (head) {
+					head->prev = data;
+				}
+				bucket.store(data, std::memory_order_relaxed);
+
+				data = next;
+			}
+		}
+
+		grown->previous = current;
+		table.store(grown, std::memory_order_release);
+	}
+
+	for (int i = STRIPE_COUNT - 1; i >= 0; i--) {
+		stripes[i].mutex.unlock();
+	}
+}
+
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
-
 		if (_data->static_count.get() > 0) {
 			if (_data->cname) {
 				ERR_PRINT("BUG: Unreferenced static string to 0: " + String(_data->cname));
@@ -131,19 +397,29 @@ void StringName::unref() {
 				ERR_PRINT("BUG: Unreferenced static string to 0: " + String(_data->name));
 			}
 		}
+
+		Stripe &stripe = stripes[_data->hash & STRIPE_MASK];
+		MutexLock lock(stripe.mutex);
+
+		_Data *next = _data->next.load(std::memory_order_relaxed);
 		if (_data->prev) {
-			_data->prev->next = _data->next;
+			_data->prev->next.store(next, std::memory_order_release);
 		} else {
-			if (_table[_data->idx] != _data) {
+			Table *current = table.load(std::memory_order_relaxed);
+			std::atomic<_Data *> &bucket = current->buckets[_data->hash & current->mask];
+			if (bucket.load(std::memory_order_relaxed) != _data) {
 				ERR_PRINT("BUG!");
 			}
-			_table[_data->idx] = _data->next;
+			bucket.store(next, std::memory_order_release);
 		}
 
-		if (_data->next) {
-			_data->next->prev = _data->prev;
+		if (next) {
+			next->prev = _data->prev;
 		}
-		memdelete(_data);
+		name_count.decrement();
+
+		// Keep `next` intact, lookups walking this name still reach the rest of the chain.
+		_retire(stripe, _data);
 	}
 
 	_data = nullptr;
@@ -210,56 +486,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(String::hash(p_name), p_name, nullptr, p_static);
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -269,55 +496,7 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(String::hash(p_static_string.ptr), p_static_string.ptr, p_static_string.ptr, p_static);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -329,54 +508,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(p_name.hash(), p_name, nullptr, p_static);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -387,25 +519,12 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
+	_Data *_data = _acquire(String::hash(p_name), p_name);
 
-	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
+	if (_data) {
 #ifdef DEBUG_ENABLED
 		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
+			_data->debug_references.increment();
 		}
 #endif
 
@@ -423,23 +542,9 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Data *_data = _acquire(String::hash(p_name), p_name);
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
+	if (_data) {
 		return StringName(_data);
 	}
 
@@ -449,26 +554,12 @@ StringName StringName::search(const char32_t *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
+	_Data *_data = _acquire(p_name.hash(), p_name);
 
-	if (_data && _data->refcount.ref()) {
+	if (_data) {
 #ifdef DEBUG_ENABLED
 		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
+			_data->debug_references.increment();
 		}
 #endif
 		return StringName(_data);
@@ -33,6 +33,7 @@
 
 #include "core/os/mutex.h"
 #include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/safe_refcount.h"
 
 #define UNIQUE_NODE_PREFIX "%"
@@ -46,9 +47,11 @@ struct StaticCString {
 
 class StringName {
 	enum {
-		STRING_TABLE_BITS = 16,
+		STRING_TABLE_BITS = 16, // Initial size, the table grows with the number of names.
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRIPE_BITS = 8,
+		STRIPE_COUNT = 1 << STRIPE_BITS,
+		STRIPE_MASK = STRIPE_COUNT - 1,
 	};
 
 	struct _Data {
@@ -57,17 +60,35 @@ class StringName {
 		const char *cname = nullptr;
 		String name;
 #ifdef DEBUG_ENABLED
-		uint32_t debug_references = 0;
+		SafeNumeric<uint32_t> debug_references;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx = 0;
 		uint32_t hash = 0;
-		_Data *prev = nullptr;
-		_Data *next = nullptr;
+		_Data *prev = nullptr; // Only used with the stripe locked.
+		std::atomic<_Data *> next = { nullptr }; // Also followed by lock-free lookups.
 		_Data() {}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	struct Table {
+		uint32_t mask = 0;
+		std::atomic<_Data *> *buckets = nullptr;
+		Table *previous = nullptr; // Kept until cleanup, lock-free lookups may still be using it.
+	};
+
+	struct Retired {
+		_Data *data = nullptr;
+		uint64_t epoch = 0;
+	};
+
+	// Insertions and removals lock the stripe of the name's hash.
+	struct Stripe {
+		BinaryMutex mutex;
+		LocalVector<Retired> retired; // Removed names, freed once no lookup can reach them.
+	};
+
+	static std::atomic<Table *> table;
+	static Stripe stripes[STRIPE_COUNT];
+	static SafeNumeric<uint32_t> name_count;
 
 	_Data *_data = nullptr;
 
@@ -76,18 +97,26 @@ class StringName {
 		uint32_t hash;
 	};
 
+	template <typename T>
+	static _Data *_find(const Table *p_table, uint32_t p_hash, const T &p_name);
+	template <typename T>
+	static _Data *_acquire(uint32_t p_hash, const T &p_name);
+	template <typename T>
+	static _Data *_intern(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static);
+	static void _retire(Stripe &p_stripe, _Data *p_data);
+	static void _grow();
+
 	void unref();
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
 	static void setup();
 	static void cleanup();
 	static bool configured;
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
 		bool operator()(const _Data *p_left, const _Data *p_right) const {
-			return p_left->debug_references > p_right->debug_references;
+			return p_left->debug_references.get() > p_right->debug_references.get();
 		}
 	};
 
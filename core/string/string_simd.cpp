@@ -0,0 +1,517 @@
+/**************************************************************************/
+/*  string_simd.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "string_simd.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define STRING_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static _FORCE_INLINE_ uint32_t _ctz(uint64_t p_mask) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(p_mask);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index;
+	_BitScanForward64(&index, p_mask);
+	return index;
+#else
+	uint32_t r = 0;
+	while (!(p_mask & 1)) {
+		p_mask >>= 1;
+		r++;
+	}
+	return r;
+#endif
+}
+
+// Four characters per vector. Masks have one bit per character.
+#if defined(STRING_SIMD_SSE2)
+
+typedef __m128i Chars;
+
+static _FORCE_INLINE_ Chars _load(const char32_t *p_ptr) {
+	return _mm_loadu_si128((const __m128i *)p_ptr);
+}
+
+static _FORCE_INLINE_ void _store(char32_t *p_ptr, Chars p_chars) {
+	_mm_storeu_si128((__m128i *)p_ptr, p_chars);
+}
+
+static _FORCE_INLINE_ Chars _splat(char32_t p_char) {
+	return _mm_set1_epi32(int32_t(p_char));
+}
+
+static _FORCE_INLINE_ uint32_t _eq_mask(Chars p_chars, Chars p_char) {
+	return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(p_chars, p_char)));
+}
+
+// Characters above `p_max`, compared unsigned.
+static _FORCE_INLINE_ uint32_t _gt_mask(Chars p_chars, char32_t p_max) {
+	const __m128i bias = _mm_set1_epi32(INT32_MIN);
+	return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(_mm_xor_si128(p_chars, bias), _mm_set1_epi32(int32_t(p_max ^ 0x80000000)))));
+}
+
+// Characters in [`p_first`, `p_last`].
+static _FORCE_INLINE_ uint32_t _range_mask(Chars p_chars, char32_t p_first, char32_t p_last) {
+	return ~_gt_mask(_mm_sub_epi32(p_chars, _splat(p_first)), p_last - p_first) & 0xf;
+}
+
+// Adds 32 to characters in ['A', 'Z'], or subtracts it from ['a', 'z']. Characters must be ASCII.
+static _FORCE_INLINE_ Chars _convert_case(Chars p_chars, bool p_upper) {
+	const char32_t first = p_upper ? 'a' : 'A';
+	const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi32(p_chars, _splat(first - 1)), _mm_cmpgt_epi32(_splat(first + 26), p_chars));
+	const __m128i delta = _mm_and_si128(in_range, _splat(32));
+	return p_upper ? _mm_sub_epi32(p_chars, delta) : _mm_add_epi32(p_chars, delta);
+}
+
+// Number of leading bytes out of 16 that are ASCII, not NUL, and not CR if requested.
+static _FORCE_INLINE_ uint32_t _utf8_ascii_block(const char *p_utf8, bool p_skip_cr) {
+	const __m128i bytes = _mm_loadu_si128((const __m128i *)p_utf8);
+	uint32_t mask = _mm_movemask_epi8(bytes) | _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128()));
+	if (p_skip_cr) {
+		mask |= _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+	}
+	return mask ? _ctz(mask) : 16;
+}
+
+// Index of the first byte out of 16 that is a quote, a backslash or a control character, or 16.
+static _FORCE_INLINE_ uint32_t _json_special_block(const char *p_utf8) {
+	const __m128i bytes = _mm_loadu_si128((const __m128i *)p_utf8);
+	// Unsigned `byte <= 0x1f`, as `max(byte, 0x1f) == 0x1f`.
+	const __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(bytes, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f));
+	const __m128i quote = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"'));
+	const __m128i backslash = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\'));
+	const uint32_t mask = _mm_movemask_epi8(_mm_or_si128(control, _mm_or_si128(quote, backslash)));
+	return mask ? _ctz(mask) : 16;
+}
+
+static _FORCE_INLINE_ void _widen_block(char32_t *p_dst, const char *p_src) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bytes = _mm_loadu_si128((const __m128i *)p_src);
+	const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+	const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+	_store(p_dst, _mm_unpacklo_epi16(low, zero));
+	_store(p_dst + 4, _mm_unpackhi_epi16(low, zero));
+	_store(p_dst + 8, _mm_unpacklo_epi16(high, zero));
+	_store(p_dst + 12, _mm_unpackhi_epi16(high, zero));
+}
+
+static _FORCE_INLINE_ void _narrow_block(char *p_dst, const char32_t *p_src) {
+	// Saturating packs, exact since the characters are ASCII.
+	const __m128i low = _mm_packs_epi32(_load(p_src), _load(p_src + 4));
+	const __m128i high = _mm_packs_epi32(_load(p_src + 8), _load(p_src + 12));
+	_mm_storeu_si128((__m128i *)p_dst, _mm_packus_epi16(low, high));
+}
+
+#elif defined(STRING_SIMD_NEON)
+
+typedef uint32x4_t Chars;
+
+static _FORCE_INLINE_ Chars _load(const char32_t *p_ptr) {
+	return vld1q_u32((const uint32_t *)p_ptr);
+}
+
+static _FORCE_INLINE_ void _store(char32_t *p_ptr, Chars p_chars) {
+	vst1q_u32((uint32_t *)p_ptr, p_chars);
+}
+
+static _FORCE_INLINE_ Chars _splat(char32_t p_char) {
+	return vdupq_n_u32(p_char);
+}
+
+static _FORCE_INLINE_ uint32_t _lanes_to_mask(uint32x4_t p_lanes) {
+	static const uint32_t bits[4] = { 1, 2, 4, 8 };
+	return vaddvq_u32(vandq_u32(p_lanes, vld1q_u32(bits)));
+}
+
+static _FORCE_INLINE_ uint32_t _eq_mask(Chars p_chars, Chars p_char) {
+	return _lanes_to_mask(vceqq_u32(p_chars, p_char));
+}
+
+static _FORCE_INLINE_ uint32_t _gt_mask(Chars p_chars, char32_t p_max) {
+	return _lanes_to_mask(vcgtq_u32(p_chars, vdupq_n_u32(p_max)));
+}
+
+static _FORCE_INLINE_ uint32_t _range_mask(Chars p_chars, char32_t p_first, char32_t p_last) {
+	return _lanes_to_mask(vandq_u32(vcgeq_u32(p_chars, vdupq_n_u32(p_first)), vcleq_u32(p_chars, vdupq_n_u32(p_last))));
+}
+
+static _FORCE_INLINE_ Chars _convert_case(Chars p_chars, bool p_upper) {
+	const char32_t first = p_upper ? 'a' : 'A';
+	const uint32x4_t in_range = vandq_u32(vcgeq_u32(p_chars, vdupq_n_u32(first)), vcleq_u32(p_chars, vdupq_n_u32(first + 25)));
+	const uint32x4_t delta = vandq_u32(in_range, vdupq_n_u32(32));
+	return p_upper ? vsubq_u32(p_chars, delta) : vaddq_u32(p_chars, delta);
+}
+
+static _FORCE_INLINE_ uint32_t _utf8_ascii_block(const char *p_utf8, bool p_skip_cr) {
+	const uint8x16_t bytes = vld1q_u8((const uint8_t *)p_utf8);
+	uint8x16_t special = vorrq_u8(vcgtq_u8(bytes, vdupq_n_u8(0x7f)), vceqq_u8(bytes, vdupq_n_u8(0)));
+	if (p_skip_cr) {
+		special = vorrq_u8(special, vceqq_u8(bytes, vdupq_n_u8('\r')));
+	}
+	// Four bits per byte.
+	const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+	return mask ? _ctz(mask) / 4 : 16;
+}
+
+static _FORCE_INLINE_ uint32_t _json_special_block(const char *p_utf8) {
+	const uint8x16_t bytes = vld1q_u8((const uint8_t *)p_utf8);
+	const uint8x16_t special = vorrq_u8(vcltq_u8(bytes, vdupq_n_u8(0x20)), vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('"')), vceqq_u8(bytes, vdupq_n_u8('\\'))));
+	const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+	return mask ? _ctz(mask) / 4 : 16;
+}
+
+static _FORCE_INLINE_ void _widen_block(char32_t *p_dst, const char *p_src) {
+	const uint8x16_t bytes = vld1q_u8((const uint8_t *)p_src);
+	const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+	const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+	_store(p_dst, vmovl_u16(vget_low_u16(low)));
+	_store(p_dst + 4, vmovl_u16(vget_high_u16(low)));
+	_store(p_dst + 8, vmovl_u16(vget_low_u16(high)));
+	_store(p_dst + 12, vmovl_u16(vget_high_u16(high)));
+}
+
+static _FORCE_INLINE_ void _narrow_block(char *p_dst, const char32_t *p_src) {
+	const uint16x8_t low = vcombine_u16(vmovn_u32(_load(p_src)), vmovn_u32(_load(p_src + 4)));
+	const uint16x8_t high = vcombine_u16(vmovn_u32(_load(p_src + 8)), vmovn_u32(_load(p_src + 12)));
+	vst1q_u8((uint8_t *)p_dst, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+}
+
+#endif
+
+#if defined(STRING_SIMD_SSE2) || defined(STRING_SIMD_NEON)
+#define STRING_SIMD_ENABLED
+#endif
+
+int StringSIMD::find_char(const char32_t *p_str, int p_len, char32_t p_char) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	const Chars c = _splat(p_char);
+	for (; i + 4 <= p_len; i += 4) {
+		uint32_t mask = _eq_mask(_load(p_str + i), c);
+		if (mask) {
+			return i + _ctz(mask);
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		if (p_str[i] == p_char) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int StringSIMD::find_either_char(const char32_t *p_str, int p_len, char32_t p_a, char32_t p_b) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	const Chars a = _splat(p_a);
+	const Chars b = _splat(p_b);
+	for (; i + 4 <= p_len; i += 4) {
+		const Chars chars = _load(p_str + i);
+		uint32_t mask = _eq_mask(chars, a) | _eq_mask(chars, b);
+		if (mask) {
+			return i + _ctz(mask);
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		if (p_str[i] == p_a || p_str[i] == p_b) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int StringSIMD::find(const char32_t *p_str, int p_len, const char32_t *p_sub, int p_sub_len) {
+	if (p_sub_len <= 0 || p_sub_len > p_len) {
+		return -1;
+	}
+	if (p_sub_len == 1) {
+		return find_char(p_str, p_len, p_sub[0]);
+	}
+
+	const int last_start = p_len - p_sub_len;
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	// Compare the first and last characters of the substring at four positions
+	// at once, and only compare the rest where both match.
+	const Chars first = _splat(p_sub[0]);
+	const Chars last = _splat(p_sub[p_sub_len - 1]);
+	for (; i + 3 <= last_start; i += 4) {
+		uint32_t mask = _eq_mask(_load(p_str + i), first) & _eq_mask(_load(p_str + i + p_sub_len - 1), last);
+		while (mask) {
+			const int pos = i + _ctz(mask);
+			if (memcmp(p_str + pos + 1, p_sub + 1, (p_sub_len - 2) * sizeof(char32_t)) == 0) {
+				return pos;
+			}
+			mask &= mask - 1;
+		}
+	}
+#endif
+	for (; i <= last_start; i++) {
+		if (p_str[i] == p_sub[0] && memcmp(p_str + i + 1, p_sub + 1, (p_sub_len - 1) * sizeof(char32_t)) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int StringSIMD::find_ascii_case_change(const char32_t *p_str, int p_len, bool p_upper) {
+	const char32_t first = p_upper ? 'a' : 'A';
+	const char32_t last = p_upper ? 'z' : 'Z';
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	for (; i + 4 <= p_len; i += 4) {
+		const Chars chars = _load(p_str + i);
+		uint32_t mask = _gt_mask(chars, 0x7f) | _range_mask(chars, first, last);
+		if (mask) {
+			return i + _ctz(mask);
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		const char32_t c = p_str[i];
+		if (c > 0x7f || (c >= first && c <= last)) {
+			return i;
+		}
+	}
+	return p_len;
+}
+
+int StringSIMD::convert_ascii_case(char32_t *p_str, int p_len, bool p_upper) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	for (; i + 4 <= p_len; i += 4) {
+		const Chars chars = _load(p_str + i);
+		if (_gt_mask(chars, 0x7f)) {
+			break;
+		}
+		_store(p_str + i, _convert_case(chars, p_upper));
+	}
+#endif
+	const char32_t first = p_upper ? 'a' : 'A';
+	for (; i < p_len; i++) {
+		const char32_t c = p_str[i];
+		if (c > 0x7f) {
+			break;
+		}
+		if (c >= first && c < first + 26) {
+			p_str[i] = p_upper ? c - 32 : c + 32;
+		}
+	}
+	return i;
+}
+
+int StringSIMD::skip_whitespace(const char32_t *p_str, int p_len) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	for (; i + 4 <= p_len; i += 4) {
+		uint32_t mask = _gt_mask(_load(p_str + i), 32);
+		if (mask) {
+			return i + _ctz(mask);
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		if (p_str[i] > 32) {
+			return i;
+		}
+	}
+	return p_len;
+}
+
+int StringSIMD::skip_whitespace_backwards(const char32_t *p_str, int p_len) {
+	int end = p_len;
+#ifdef STRING_SIMD_ENABLED
+	for (; end >= 4; end -= 4) {
+		uint32_t mask = _gt_mask(_load(p_str + end - 4), 32);
+		if (mask) {
+			int last = 3;
+			while (!(mask & (1u << last))) {
+				last--;
+			}
+			return end - 4 + last + 1;
+		}
+	}
+#endif
+	for (; end > 0; end--) {
+		if (p_str[end - 1] > 32) {
+			return end;
+		}
+	}
+	return 0;
+}
+
+int StringSIMD::ascii_prefix_length(const char32_t *p_str, int p_len) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	for (; i + 4 <= p_len; i += 4) {
+		uint32_t mask = _gt_mask(_load(p_str + i), 0x7f);
+		if (mask) {
+			return i + _ctz(mask);
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		if (p_str[i] > 0x7f) {
+			return i;
+		}
+	}
+	return p_len;
+}
+
+int StringSIMD::utf8_ascii_prefix_length(const char *p_utf8, int p_len, bool p_skip_cr) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	for (; i + 16 <= p_len; i += 16) {
+		uint32_t ascii = _utf8_ascii_block(p_utf8 + i, p_skip_cr);
+		if (ascii < 16) {
+			return i + ascii;
+		}
+	}
+#else
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t high_bits = 0x8080808080808080ULL;
+	const uint64_t cr_bytes = ones * '\r';
+	for (; i + 8 <= p_len; i += 8) {
+		uint64_t word;
+		memcpy(&word, p_utf8 + i, sizeof(word));
+		// Non-ASCII bytes have the high bit set, and `(x - 1) & ~x` sets it for zero bytes.
+		uint64_t special = (word & high_bits) | ((word - ones) & ~word & high_bits);
+		if (p_skip_cr) {
+			uint64_t cr = word ^ cr_bytes;
+			special |= (cr - ones) & ~cr & high_bits;
+		}
+		if (special) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		uint8_t c = p_utf8[i];
+		if (c == 0 || c > 0x7f || (p_skip_cr && c == '\r')) {
+			break;
+		}
+	}
+	return i;
+}
+
+void StringSIMD::widen_ascii(char32_t *p_dst, const char *p_src, int p_len) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	for (; i + 16 <= p_len; i += 16) {
+		_widen_block(p_dst + i, p_src + i);
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = uint8_t(p_src[i]);
+	}
+}
+
+void StringSIMD::narrow_ascii(char *p_dst, const char32_t *p_src, int p_len) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	for (; i + 16 <= p_len; i += 16) {
+		_narrow_block(p_dst + i, p_src + i);
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = char(p_src[i]);
+	}
+}
+
+int StringSIMD::find_json_string_special(const char *p_utf8, int p_len) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	for (; i + 16 <= p_len; i += 16) {
+		uint32_t plain = _json_special_block(p_utf8 + i);
+		if (plain < 16) {
+			return i + plain;
+		}
+	}
+#else
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t high_bits = 0x8080808080808080ULL;
+	const uint64_t quote_bytes = ones * '"';
+	const uint64_t backslash_bytes = ones * '\\';
+	for (; i + 8 <= p_len; i += 8) {
+		uint64_t word;
+		memcpy(&word, p_utf8 + i, sizeof(word));
+		// `(x - n) & ~x` sets the high bit of bytes below n, if no earlier byte did.
+		uint64_t special = (word - ones * 0x20) & ~word & high_bits;
+		uint64_t quote = word ^ quote_bytes;
+		uint64_t backslash = word ^ backslash_bytes;
+		special |= ((quote - ones) & ~quote & high_bits) | ((backslash - ones) & ~backslash & high_bits);
+		if (special) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		uint8_t c = p_utf8[i];
+		if (c < 0x20 || c == '"' || c == '\\') {
+			break;
+		}
+	}
+	return i;
+}
+
+int StringSIMD::json_plain_prefix_length(const char32_t *p_str, int p_len) {
+	int i = 0;
+#ifdef STRING_SIMD_ENABLED
+	const Chars quote = _splat('"');
+	const Chars backslash = _splat('\\');
+	for (; i + 4 <= p_len; i += 4) {
+		const Chars chars = _load(p_str + i);
+		uint32_t mask = _gt_mask(chars, 0x7f) | _range_mask(chars, 0, 0x1f) | _eq_mask(chars, quote) | _eq_mask(chars, backslash);
+		if (mask) {
+			return i + _ctz(mask);
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		const char32_t c = p_str[i];
+		if (c > 0x7f || c < 0x20 || c == '"' || c == '\\') {
+			return i;
+		}
+	}
+	return p_len;
+}
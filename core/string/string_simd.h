@@ -0,0 +1,80 @@
+/**************************************************************************/
+/*  string_simd.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef STRING_SIMD_H
+#define STRING_SIMD_H
+
+#include "core/typedefs.h"
+
+// Vectorized loops over string buffers, used by String for searching, case
+// conversion, stripping and UTF-8 conversion. Uses SSE2 on x86_64 and NEON on
+// ARM64, which are always available there, with scalar fallbacks elsewhere
+// and for the tails of buffers.
+class StringSIMD {
+public:
+	// Index of the first `p_char` in `p_str`, or -1.
+	static int find_char(const char32_t *p_str, int p_len, char32_t p_char);
+	// Index of the first `p_a` or `p_b` in `p_str`, or -1.
+	static int find_either_char(const char32_t *p_str, int p_len, char32_t p_a, char32_t p_b);
+	// Index of the first occurrence of `p_sub` in `p_str`, or -1.
+	static int find(const char32_t *p_str, int p_len, const char32_t *p_sub, int p_sub_len);
+
+	// Index of the first character that is either not ASCII, or an ASCII
+	// letter that changes when converting to the given case. `p_len` if none.
+	static int find_ascii_case_change(const char32_t *p_str, int p_len, bool p_upper);
+	// Converts ASCII letters in place, up to the first non-ASCII character.
+	// Returns the number of characters processed.
+	static int convert_ascii_case(char32_t *p_str, int p_len, bool p_upper);
+
+	// Index of the first character above 32 (space), or `p_len`.
+	static int skip_whitespace(const char32_t *p_str, int p_len);
+	// Index after the last character above 32 (space), or 0.
+	static int skip_whitespace_backwards(const char32_t *p_str, int p_len);
+
+	// Length of the leading run of ASCII characters.
+	static int ascii_prefix_length(const char32_t *p_str, int p_len);
+	// Length of the leading run of ASCII bytes in UTF-8 text, which need no
+	// decoding. Stops at NUL, and at CR when it must be skipped.
+	static int utf8_ascii_prefix_length(const char *p_utf8, int p_len, bool p_skip_cr);
+
+	// Copies ASCII bytes to characters.
+	static void widen_ascii(char32_t *p_dst, const char *p_src, int p_len);
+	// Copies ASCII characters to bytes. Characters must be 0x7f or less.
+	static void narrow_ascii(char *p_dst, const char32_t *p_src, int p_len);
+
+	// Index of the first byte of UTF-8 text that ends a plain run inside a
+	// JSON string: a quote, a backslash or a control character. `p_len` if none.
+	static int find_json_string_special(const char *p_utf8, int p_len);
+	// Length of the leading run of ASCII characters that can be written in a
+	// JSON string without escaping.
+	static int json_plain_prefix_length(const char32_t *p_str, int p_len);
+};
+
+#endif // STRING_SIMD_H
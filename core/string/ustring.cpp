@@ -35,9 +35,11 @@
 #include "core/math/math_funcs.h"
 #include "core/os/memory.h"
 #include "core/string/print_string.h"
+#include "core/string/string_simd.h"
 #include "core/string/string_name.h"
 #include "core/string/translation.h"
 #include "core/string/ucaps.h"
+#include "core/templates/small_vector.h"
 #include "core/variant/variant.h"
 #include "core/version_generated.gen.h"
 
@@ -1371,13 +1373,26 @@ char32_t String::char_lowercase(char32_t p_char) {
 }
 
 String String::to_upper() const {
-	String upper = *this;
+	const int len = length();
+	const char32_t *src = get_data();
 
-	for (int i = 0; i < upper.size(); i++) {
-		const char32_t s = upper[i];
-		const char32_t t = _find_upper(s);
-		if (s != t) { // avoid copy on write
-			upper[i] = t;
+	// Skip what doesn't change, to avoid copy on write.
+	int i = StringSIMD::find_ascii_case_change(src, len, true);
+	while (i < len && src[i] > 0x7f && _find_upper(src[i]) == (int)src[i]) {
+		i += 1 + StringSIMD::find_ascii_case_change(src + i + 1, len - i - 1, true);
+	}
+	if (i >= len) {
+		return *this;
+	}
+
+	String upper = *this;
+	char32_t *dst = upper.ptrw();
+	while (i < len) {
+		// ASCII runs are converted in bulk.
+		i += StringSIMD::convert_ascii_case(dst + i, len - i, true);
+		if (i < len) {
+			dst[i] = _find_upper(dst[i]);
+			i++;
 		}
 	}
 
@@ -1385,13 +1400,26 @@ String String::to_upper() const {
 }
 
 String String::to_lower() const {
-	String lower = *this;
+	const int len = length();
+	const char32_t *src = get_data();
 
-	for (int i = 0; i < lower.size(); i++) {
-		const char32_t s = lower[i];
-		const char32_t t = _find_lower(s);
-		if (s != t) { // avoid copy on write
-			lower[i] = t;
+	// Skip what doesn't change, to avoid copy on write.
+	int i = StringSIMD::find_ascii_case_change(src, len, false);
+	while (i < len && src[i] > 0x7f && _find_lower(src[i]) == (int)src[i]) {
+		i += 1 + StringSIMD::find_ascii_case_change(src + i + 1, len - i - 1, false);
+	}
+	if (i >= len) {
+		return *this;
+	}
+
+	String lower = *this;
+	char32_t *dst = lower.ptrw();
+	while (i < len) {
+		// ASCII runs are converted in bulk.
+		i += StringSIMD::convert_ascii_case(dst + i, len - i, false);
+		if (i < len) {
+			dst[i] = _find_lower(dst[i]);
+			i++;
 		}
 	}
 
@@ -1660,8 +1688,9 @@ CharString String::ascii(bool p_allow_extended) const {
 	CharString cs;
 	cs.resize(size());
 
+	const char32_t *src = ptr();
 	for (int i = 0; i < size(); i++) {
-		char32_t c = operator[](i);
+		char32_t c = src[i];
 		if ((c <= 0x7f) || (c <= 0xff && p_allow_extended)) {
 			cs[i] = c;
 		} else {
@@ -1685,27 +1714,41 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 		return ERR_INVALID_DATA;
 	}
 
-	String aux;
-
-	int cstr_size = 0;
-	int str_size = 0;
+	if (p_len < 0) {
+		p_len = strlen(p_utf8);
+	}
 
 	/* HANDLE BOM (Byte Order Mark) */
-	if (p_len < 0 || p_len >= 3) {
+	if (p_len >= 3) {
 		bool has_bom = uint8_t(p_utf8[0]) == 0xef && uint8_t(p_utf8[1]) == 0xbb && uint8_t(p_utf8[2]) == 0xbf;
 		if (has_bom) {
 			//8-bit encoding, byte order has no meaning in UTF-8, just skip it
-			if (p_len >= 0) {
-				p_len -= 3;
-			}
+			p_len -= 3;
 			p_utf8 += 3;
 		}
 	}
 
+	// Most text is plain ASCII, which can be widened without decoding.
+	const int ascii_len = StringSIMD::utf8_ascii_prefix_length(p_utf8, p_len, p_skip_cr);
+	if (ascii_len == p_len || p_utf8[ascii_len] == 0) {
+		if (ascii_len == 0) {
+			clear();
+			return OK; // empty string
+		}
+		resize(ascii_len + 1);
+		char32_t *dst = ptrw();
+		StringSIMD::widen_ascii(dst, p_utf8, ascii_len);
+		dst[ascii_len] = 0;
+		return OK;
+	}
+
+	int cstr_size = ascii_len;
+	int str_size = ascii_len;
+
 	bool decode_error = false;
 	bool decode_failed = false;
 	{
-		const char *ptrtmp = p_utf8;
+		const char *ptrtmp = p_utf8 + ascii_len;
 		const char *ptrtmp_limit = &p_utf8[p_len];
 		int skip = 0;
 		uint8_t c_start = 0;
@@ -1775,6 +1818,11 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 	char32_t *dst = ptrw();
 	dst[str_size] = 0;
 
+	StringSIMD::widen_ascii(dst, p_utf8, ascii_len);
+	dst += ascii_len;
+	p_utf8 += ascii_len;
+	cstr_size -= ascii_len;
+
 	int skip = 0;
 	uint32_t unichar = 0;
 	while (cstr_size) {
@@ -1859,8 +1907,12 @@ CharString String::utf8() const {
 	}
 
 	const char32_t *d = &operator[](0);
-	int fl = 0;
-	for (int i = 0; i < l; i++) {
+
+	// Plain ASCII prefix, copied as is.
+	const int ascii_len = StringSIMD::ascii_prefix_length(d, l);
+
+	int fl = ascii_len;
+	for (int i = ascii_len; i < l; i++) {
 		uint32_t c = d[i];
 		if (c <= 0x7f) { // 7 bits.
 			fl += 1;
@@ -1892,7 +1944,10 @@ CharString String::utf8() const {
 
 #define APPEND_CHAR(m_c) *(cdst++) = m_c
 
-	for (int i = 0; i < l; i++) {
+	StringSIMD::narrow_ascii((char *)cdst, d, ascii_len);
+	cdst += ascii_len;
+
+	for (int i = ascii_len; i < l; i++) {
 		uint32_t c = d[i];
 
 		if (c <= 0x7f) { // 7 bits.
@@ -2552,8 +2607,8 @@ done:
 #define READING_EXP 3
 #define READING_DONE 4
 
-double String::to_float(const char *p_str) {
-	return built_in_strtod<char>(p_str);
+double String::to_float(const char *p_str, const char **r_end) {
+	return built_in_strtod<char>(p_str, (char **)r_end);
 }
 
 double String::to_float(const char32_t *p_str, const char32_t **r_end) {
@@ -2842,35 +2897,12 @@ int String::find(const String &p_str, int p_from) const {
 
 	const int len = length();
 
-	if (src_len == 0 || len == 0) {
+	if (src_len == 0 || len == 0 || p_from > len - src_len) {
 		return -1; // won't find anything!
 	}
 
-	const char32_t *src = get_data();
-	const char32_t *str = p_str.get_data();
-
-	for (int i = p_from; i <= (len - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= len) {
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			}
-
-			if (src[read_pos] != str[j]) {
-				found = false;
-				break;
-			}
-		}
-
-		if (found) {
-			return i;
-		}
-	}
-
-	return -1;
+	int pos = StringSIMD::find(get_data() + p_from, len - p_from, p_str.get_data(), src_len);
+	return pos < 0 ? -1 : pos + p_from;
 }
 
 int String::find(const char *p_str, int p_from) const {
@@ -2891,35 +2923,29 @@ int String::find(const char *p_str, int p_from) const {
 		src_len++;
 	}
 
-	if (src_len == 1) {
-		const char32_t needle = p_str[0];
+	if (src_len == 0) {
+		return -1;
+	}
 
-		for (int i = p_from; i < len; i++) {
-			if (src[i] == needle) {
-				return i;
-			}
+	// Look for the first character, then compare the rest.
+	const char32_t first = (uint8_t)p_str[0];
+	for (int i = p_from; i <= (len - src_len); i++) {
+		int pos = StringSIMD::find_char(src + i, len - src_len + 1 - i, first);
+		if (pos < 0) {
+			break;
 		}
+		i += pos;
 
-	} else {
-		for (int i = p_from; i <= (len - src_len); i++) {
-			bool found = true;
-			for (int j = 0; j < src_len; j++) {
-				int read_pos = i + j;
-
-				if (read_pos >= len) {
-					ERR_PRINT("read_pos>=len");
-					return -1;
-				}
-
-				if (src[read_pos] != (char32_t)p_str[j]) {
-					found = false;
-					break;
-				}
+		bool found = true;
+		for (int j = 1; j < src_len; j++) {
+			if (src[i + j] != (char32_t)(uint8_t)p_str[j]) {
+				found = false;
+				break;
 			}
+		}
 
-			if (found) {
-				return i;
-			}
+		if (found) {
+			return i;
 		}
 	}
 
@@ -2927,7 +2953,11 @@ int String::find(const char *p_str, int p_from) const {
 }
 
 int String::find_char(const char32_t &p_char, int p_from) const {
-	return _cowdata.find(p_char, p_from);
+	if (p_from < 0 || p_from >= size()) {
+		return -1;
+	}
+	int pos = StringSIMD::find_char(get_data() + p_from, size() - p_from, p_char);
+	return pos < 0 ? -1 : pos + p_from;
 }
 
 int String::findmk(const Vector<String> &p_keys, int p_from, int *r_key) const {
@@ -2990,26 +3020,33 @@ int String::findn(const String &p_str, int p_from) const {
 		return -1;
 	}
 
-	int src_len = p_str.length();
+	const int src_len = p_str.length();
+	const int len = length();
 
-	if (src_len == 0 || length() == 0) {
+	if (src_len == 0 || len == 0) {
 		return -1; // won't find anything!
 	}
 
 	const char32_t *srcd = get_data();
+	const char32_t *strd = p_str.get_data();
 
-	for (int i = p_from; i <= (length() - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
+	// Look for either case of the first character, then compare the rest.
+	// The case tables are symmetric, so only these two characters have the
+	// same lower case as the first one.
+	const char32_t first_lower = _find_lower(strd[0]);
+	const char32_t first_upper = _find_upper(first_lower);
 
-			if (read_pos >= length()) {
-				ERR_PRINT("read_pos>=length()");
-				return -1;
-			}
+	for (int i = p_from; i <= (len - src_len); i++) {
+		int pos = StringSIMD::find_either_char(srcd + i, len - src_len + 1 - i, first_lower, first_upper);
+		if (pos < 0) {
+			break;
+		}
+		i += pos;
 
-			char32_t src = _find_lower(srcd[read_pos]);
-			char32_t dst = _find_lower(p_str[j]);
+		bool found = true;
+		for (int j = 0; j < src_len; j++) {
+			char32_t src = _find_lower(srcd[i + j]);
+			char32_t dst = _find_lower(strd[j]);
 
 			if (src != dst) {
 				found = false;
@@ -3228,14 +3265,11 @@ int String::_count(const String &p_string, int p_from, int p_to, bool p_case_ins
 		return 0;
 	}
 	int c = 0;
-	int idx = -1;
-	do {
-		idx = p_case_insensitive ? str.findn(p_string) : str.find(p_string);
-		if (idx != -1) {
-			str = str.substr(idx + slen, str.length() - slen);
-			++c;
-		}
-	} while (idx != -1);
+	int idx = 0;
+	while ((idx = p_case_insensitive ? str.findn(p_string, idx) : str.find(p_string, idx)) != -1) {
+		idx += slen;
+		++c;
+	}
 	return c;
 }
 
@@ -3404,47 +3438,53 @@ String String::format(const Variant &values, String placeholder) const {
 }
 
 String String::replace(const String &p_key, const String &p_with) const {
-	String new_string;
-	int search_from = 0;
-	int result = 0;
+	const int key_len = p_key.length();
+	int result = find(p_key);
+	if (result < 0) {
+		return *this;
+	}
 
-	while ((result = find(p_key, search_from)) >= 0) {
-		new_string += substr(search_from, result - search_from);
-		new_string += p_with;
-		search_from = result + p_key.length();
+	// Find all matches first, so the result is allocated once.
+	SmallVector<int, 16> matches;
+	while (result >= 0) {
+		matches.push_back(result);
+		result = find(p_key, result + key_len);
 	}
 
-	if (search_from == 0) {
-		return *this;
+	const int len = length();
+	const int with_len = p_with.length();
+	const int new_len = len + int(matches.size()) * (with_len - key_len);
+	if (new_len == 0) {
+		return String();
 	}
 
-	new_string += substr(search_from, length() - search_from);
+	String new_string;
+	new_string.resize(new_len + 1);
+	char32_t *dst = new_string.ptrw();
+	const char32_t *src = get_data();
+	const char32_t *with = p_with.get_data();
+
+	int search_from = 0;
+	for (uint32_t i = 0; i < matches.size(); i++) {
+		const int match = matches[i];
+		memcpy(dst, src + search_from, (match - search_from) * sizeof(char32_t));
+		dst += match - search_from;
+		memcpy(dst, with, with_len * sizeof(char32_t));
+		dst += with_len;
+		search_from = match + key_len;
+	}
+	memcpy(dst, src + search_from, (len - search_from) * sizeof(char32_t));
+	new_string.ptrw()[new_len] = 0;
 
 	return new_string;
 }
 
 String String::replace(const char *p_key, const char *p_with) const {
-	String new_string;
-	int search_from = 0;
-	int result = 0;
-
-	while ((result = find(p_key, search_from)) >= 0) {
-		new_string += substr(search_from, result - search_from);
-		new_string += p_with;
-		int k = 0;
-		while (p_key[k] != '\0') {
-			k++;
-		}
-		search_from = result + k;
-	}
-
-	if (search_from == 0) {
+	if (find(p_key) < 0) {
 		return *this;
 	}
 
-	new_string += substr(search_from, length() - search_from);
-
-	return new_string;
+	return replace(String(p_key), String(p_with));
 }
 
 String String::replace_first(const String &p_key, const String &p_with) const {
@@ -3600,23 +3640,11 @@ String String::strip_edges(bool left, bool right) const {
 	int beg = 0, end = len;
 
 	if (left) {
-		for (int i = 0; i < len; i++) {
-			if (operator[](i) <= 32) {
-				beg++;
-			} else {
-				break;
-			}
-		}
+		beg = StringSIMD::skip_whitespace(get_data(), len);
 	}
 
 	if (right) {
-		for (int i = len - 1; i >= 0; i--) {
-			if (operator[](i) <= 32) {
-				end--;
-			} else {
-				break;
-			}
-		}
+		end = beg + StringSIMD::skip_whitespace_backwards(get_data() + beg, len - beg);
 	}
 
 	if (beg == 0 && end == len) {
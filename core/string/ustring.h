@@ -332,7 +332,7 @@ public:
 	static int64_t to_int(const wchar_t *p_str, int p_len = -1);
 	static int64_t to_int(const char32_t *p_str, int p_len = -1, bool p_clamp = false);
 
-	static double to_float(const char *p_str);
+	static double to_float(const char *p_str, const char **r_end = nullptr);
 	static double to_float(const wchar_t *p_str, const wchar_t **r_end = nullptr);
 	static double to_float(const char32_t *p_str, const char32_t **r_end = nullptr);
 
@@ -0,0 +1,503 @@
+/**************************************************************************/
+/*  ordered_hash_map.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef ORDERED_HASH_MAP_H
+#define ORDERED_HASH_MAP_H
+
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * A hash map that stores its elements by insertion order in arrays, instead
+ * of individually allocated list nodes like HashMap. Iterating walks memory
+ * sequentially, and lookups go through a table of (hash, element index) slots
+ * using linear probing with backward shift deletion.
+ *
+ * Elements live in segments of growing size (8, 16, 32... elements), so they
+ * never move when the map grows and pointers to them stay valid across
+ * insertions. Erasing leaves a tombstone, so pointers to the other elements
+ * stay valid too. Tombstones are only removed by compact(), which moves
+ * elements, so the owner must call it when no pointer or iterator is held.
+ * Until then, a map that keeps erasing and inserting keeps growing, unless it
+ * is emptied.
+ *
+ * Elements are moved with plain memory copies during compaction, like in
+ * LocalVector.
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class OrderedHashMap {
+public:
+	static constexpr uint32_t FIRST_SEGMENT_SHIFT = 3; // The first segment holds 8 elements.
+	static constexpr uint32_t MIN_SLOT_CAPACITY = 16;
+	static constexpr uint32_t EMPTY_HASH = 0;
+
+private:
+	struct Element {
+		KeyValue<TKey, TValue> data;
+		uint32_t hash = EMPTY_HASH; // EMPTY_HASH once erased.
+		Element(const TKey &p_key, const TValue &p_value, uint32_t p_hash) :
+				data(p_key, p_value), hash(p_hash) {}
+	};
+
+	struct Slot {
+		uint32_t hash;
+		uint32_t index;
+	};
+
+	Element **segments = nullptr;
+	uint32_t segment_count = 0;
+
+	Slot *slots = nullptr;
+	uint32_t slot_capacity = 0; // Power of two.
+
+	uint32_t used = 0; // Elements stored, including erased ones.
+	uint32_t num_elements = 0;
+
+	static _FORCE_INLINE_ uint32_t _log2(uint32_t p_value) {
+#if defined(__GNUC__)
+		return 31 - __builtin_clz(p_value);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, p_value);
+		return index;
+#else
+		uint32_t r = 0;
+		while (p_value >>= 1) {
+			r++;
+		}
+		return r;
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t _segment_start(uint32_t p_segment) {
+		return ((1u << p_segment) - 1) << FIRST_SEGMENT_SHIFT;
+	}
+
+	_FORCE_INLINE_ Element *_get_element(uint32_t p_index) const {
+		uint32_t segment = _log2((p_index >> FIRST_SEGMENT_SHIFT) + 1);
+		return segments[segment] + (p_index - _segment_start(segment));
+	}
+
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
+		uint32_t hash = Hasher::hash(p_key);
+
+		if (unlikely(hash == EMPTY_HASH)) {
+			hash = EMPTY_HASH + 1;
+		}
+
+		return hash;
+	}
+
+	bool _lookup_slot(const TKey &p_key, uint32_t p_hash, uint32_t &r_slot) const {
+		if (slots == nullptr) {
+			return false;
+		}
+
+		const uint32_t mask = slot_capacity - 1;
+		uint32_t pos = p_hash & mask;
+
+		while (true) {
+			const Slot &slot = slots[pos];
+			if (slot.hash == EMPTY_HASH) {
+				return false;
+			}
+			if (slot.hash == p_hash && Comparator::compare(_get_element(slot.index)->data.key, p_key)) {
+				r_slot = pos;
+				return true;
+			}
+			pos = (pos + 1) & mask;
+		}
+	}
+
+	_FORCE_INLINE_ void _insert_slot(uint32_t p_hash, uint32_t p_index) {
+		const uint32_t mask = slot_capacity - 1;
+		uint32_t pos = p_hash & mask;
+		while (slots[pos].hash != EMPTY_HASH) {
+			pos = (pos + 1) & mask;
+		}
+		slots[pos].hash = p_hash;
+		slots[pos].index = p_index;
+	}
+
+	void _remove_slot(uint32_t p_pos) {
+		// Backward shift deletion: move later entries of the probe sequence
+		// back, so lookups never need tombstones in the slot table.
+		const uint32_t mask = slot_capacity - 1;
+		uint32_t hole = p_pos;
+		uint32_t pos = p_pos;
+		while (true) {
+			pos = (pos + 1) & mask;
+			if (slots[pos].hash == EMPTY_HASH) {
+				break;
+			}
+			uint32_t ideal = slots[pos].hash & mask;
+			// Move the entry back unless its ideal position lies cyclically in (hole, pos].
+			bool in_range = hole <= pos ? (ideal > hole && ideal <= pos) : (ideal > hole || ideal <= pos);
+			if (!in_range) {
+				slots[hole] = slots[pos];
+				hole = pos;
+			}
+		}
+		slots[hole].hash = EMPTY_HASH;
+	}
+
+	void _rebuild_slots(uint32_t p_capacity) {
+		if (p_capacity != slot_capacity) {
+			if (slots) {
+				Memory::free_static(slots);
+			}
+			slot_capacity = p_capacity;
+			slots = reinterpret_cast<Slot *>(Memory::alloc_static(sizeof(Slot) * slot_capacity));
+		}
+		for (uint32_t i = 0; i < slot_capacity; i++) {
+			slots[i].hash = EMPTY_HASH;
+		}
+		for (uint32_t i = 0; i < used; i++) {
+			const Element *e = _get_element(i);
+			if (e->hash != EMPTY_HASH) {
+				_insert_slot(e->hash, i);
+			}
+		}
+	}
+
+	Element *_append(const TKey &p_key, const TValue &p_value, uint32_t p_hash) {
+		// Keep the slot table at most half full.
+		if ((num_elements + 1) * 2 > slot_capacity) {
+			_rebuild_slots(MAX(slot_capacity * 2, MIN_SLOT_CAPACITY));
+		}
+
+		if (used == _segment_start(segment_count)) {
+			segments = reinterpret_cast<Element **>(Memory::realloc_static(segments, sizeof(Element *) * (segment_count + 1)));
+			segments[segment_count] = reinterpret_cast<Element *>(Memory::alloc_static(sizeof(Element) * (1u << (segment_count + FIRST_SEGMENT_SHIFT))));
+			segment_count++;
+		}
+
+		Element *e = _get_element(used);
+		memnew_placement(e, Element(p_key, p_value, p_hash));
+		_insert_slot(p_hash, used);
+		used++;
+		num_elements++;
+		return e;
+	}
+
+	void _compact() {
+		uint32_t to = 0;
+		for (uint32_t from = 0; from < used; from++) {
+			Element *e = _get_element(from);
+			if (e->hash == EMPTY_HASH) {
+				continue;
+			}
+			if (from != to) {
+				memcpy((void *)_get_element(to), (void *)e, sizeof(Element));
+			}
+			to++;
+		}
+		used = to;
+
+		// Keep the segment the next insertion goes to.
+		while (segment_count > 1 && _segment_start(segment_count - 1) > used) {
+			segment_count--;
+			Memory::free_static(segments[segment_count]);
+		}
+
+		_rebuild_slots(slot_capacity);
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+	_FORCE_INLINE_ bool is_empty() const { return num_elements == 0; }
+	_FORCE_INLINE_ uint32_t get_capacity() const { return _segment_start(segment_count); }
+
+	void clear() {
+		for (uint32_t i = 0; i < used; i++) {
+			Element *e = _get_element(i);
+			if (e->hash != EMPTY_HASH) {
+				e->~Element();
+			}
+		}
+		used = 0;
+		num_elements = 0;
+		for (uint32_t i = 0; i < slot_capacity; i++) {
+			slots[i].hash = EMPTY_HASH;
+		}
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_slot(p_key, _hash(p_key), pos)) {
+			return &_get_element(slots[pos].index)->data.value;
+		}
+		return nullptr;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (_lookup_slot(p_key, _hash(p_key), pos)) {
+			return &_get_element(slots[pos].index)->data.value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t pos = 0;
+		return _lookup_slot(p_key, _hash(p_key), pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_slot(p_key, _hash(p_key), pos)) {
+			return false;
+		}
+
+		uint32_t index = slots[pos].index;
+		_remove_slot(pos);
+
+		Element *e = _get_element(index);
+		e->~Element();
+		e->hash = EMPTY_HASH;
+		num_elements--;
+
+		// Trailing tombstones can simply be dropped.
+		while (used > 0 && _get_element(used - 1)->hash == EMPTY_HASH) {
+			used--;
+		}
+		return true;
+	}
+
+	// Removes the tombstones left by erase(). This moves elements, so pointers
+	// to values and iterators are invalidated.
+	void compact() {
+		if (used != num_elements) {
+			_compact();
+		}
+	}
+
+	void reserve(uint32_t p_new_capacity) {
+		uint32_t slot_target = MIN_SLOT_CAPACITY;
+		while (slot_target < p_new_capacity * 2) {
+			slot_target *= 2;
+		}
+		if (slot_target > slot_capacity) {
+			_rebuild_slots(slot_target);
+		}
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const { return E->data; }
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &E->data; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			E = map->_next_element(index);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return E == b.E; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return E != b.E; }
+
+		_FORCE_INLINE_ explicit operator bool() const { return E != nullptr; }
+
+		_FORCE_INLINE_ ConstIterator(const OrderedHashMap *p_map, uint32_t p_index, const Element *p_E) :
+				map(p_map), index(p_index), E(p_E) {}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		const OrderedHashMap *map = nullptr;
+		uint32_t index = 0;
+		const Element *E = nullptr;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const { return E->data; }
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &E->data; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			E = map->_next_element(index);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return E == b.E; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return E != b.E; }
+
+		_FORCE_INLINE_ explicit operator bool() const { return E != nullptr; }
+
+		_FORCE_INLINE_ Iterator(const OrderedHashMap *p_map, uint32_t p_index, Element *p_E) :
+				map(p_map), index(p_index), E(p_E) {}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, index, E);
+		}
+
+	private:
+		const OrderedHashMap *map = nullptr;
+		uint32_t index = 0;
+		Element *E = nullptr;
+	};
+
+	// Advances `r_index` to the next element that wasn't erased.
+	_FORCE_INLINE_ Element *_next_element(uint32_t &r_index) const {
+		while (++r_index < used) {
+			Element *e = _get_element(r_index);
+			if (e->hash != EMPTY_HASH) {
+				return e;
+			}
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ Iterator begin() {
+		uint32_t index = UINT32_MAX; // Wraps to 0.
+		Element *e = _next_element(index);
+		return Iterator(this, index, e);
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, used, nullptr);
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		uint32_t index = UINT32_MAX;
+		const Element *e = _next_element(index);
+		return ConstIterator(this, index, e);
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, used, nullptr);
+	}
+
+	Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_slot(p_key, _hash(p_key), pos)) {
+			return end();
+		}
+		uint32_t index = slots[pos].index;
+		return Iterator(this, index, _get_element(index));
+	}
+
+	ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (!_lookup_slot(p_key, _hash(p_key), pos)) {
+			return end();
+		}
+		uint32_t index = slots[pos].index;
+		return ConstIterator(this, index, _get_element(index));
+	}
+
+	// Element at a position in insertion order. Constant time unless elements
+	// were erased since the last compaction.
+	ConstIterator get_at_index(uint32_t p_index) const {
+		if (p_index >= num_elements) {
+			return end();
+		}
+		if (used == num_elements) {
+			return ConstIterator(this, p_index, _get_element(p_index));
+		}
+		ConstIterator it = begin();
+		for (uint32_t i = 0; i < p_index; i++) {
+			++it;
+		}
+		return it;
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		const TValue *value = getptr(p_key);
+		CRASH_COND(!value);
+		return *value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		if (_lookup_slot(p_key, hash, pos)) {
+			return _get_element(slots[pos].index)->data.value;
+		}
+		return _append(p_key, TValue(), hash)->data.value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		if (_lookup_slot(p_key, hash, pos)) {
+			uint32_t index = slots[pos].index;
+			Element *e = _get_element(index);
+			e->data.value = p_value;
+			return Iterator(this, index, e);
+		}
+		Element *e = _append(p_key, p_value, hash);
+		return Iterator(this, used - 1, e);
+	}
+
+	/* Constructors */
+
+	OrderedHashMap(const OrderedHashMap &p_other) {
+		reserve(p_other.num_elements);
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const OrderedHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		reserve(p_other.num_elements);
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	OrderedHashMap() {}
+
+	~OrderedHashMap() {
+		clear();
+		for (uint32_t i = 0; i < segment_count; i++) {
+			Memory::free_static(segments[i]);
+		}
+		if (segments) {
+			Memory::free_static(segments);
+		}
+		if (slots) {
+			Memory::free_static(slots);
+		}
+	}
+};
+
+#endif // ORDERED_HASH_MAP_H
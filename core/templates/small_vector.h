@@ -0,0 +1,176 @@
+/**************************************************************************/
+/*  small_vector.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+#include "core/templates/vector.h"
+
+#include <initializer_list>
+#include <type_traits>
+
+// Vector that keeps up to N elements inline, and only allocates when it grows
+// past them. Meant for short temporary lists (call arguments, path components)
+// that would otherwise allocate every time they are built.
+// Like LocalVector, elements are moved around with plain memory copies.
+template <class T, uint32_t N, class U = uint32_t>
+class SmallVector {
+	static_assert(N > 0, "SmallVector needs room for at least one inline element.");
+
+private:
+	U count = 0;
+	U capacity = N;
+	T *data = reinterpret_cast<T *>(inline_data);
+	alignas(T) uint8_t inline_data[N * sizeof(T)];
+
+	_FORCE_INLINE_ bool _is_inline() const { return data == reinterpret_cast<const T *>(inline_data); }
+
+	void _grow(U p_capacity) {
+		if (_is_inline()) {
+			T *heap_data = (T *)memalloc(p_capacity * sizeof(T));
+			CRASH_COND_MSG(!heap_data, "Out of memory");
+			memcpy((void *)heap_data, (void *)data, count * sizeof(T));
+			data = heap_data;
+		} else {
+			data = (T *)memrealloc(data, p_capacity * sizeof(T));
+			CRASH_COND_MSG(!data, "Out of memory");
+		}
+		capacity = p_capacity;
+	}
+
+public:
+	_FORCE_INLINE_ T *ptr() { return data; }
+	_FORCE_INLINE_ const T *ptr() const { return data; }
+
+	_FORCE_INLINE_ U size() const { return count; }
+	_FORCE_INLINE_ bool is_empty() const { return count == 0; }
+	_FORCE_INLINE_ U get_capacity() const { return capacity; }
+	_FORCE_INLINE_ bool is_using_heap() const { return !_is_inline(); }
+
+	_FORCE_INLINE_ void reserve(U p_size) {
+		if (p_size > capacity) {
+			_grow(p_size);
+		}
+	}
+
+	_FORCE_INLINE_ void push_back(T p_elem) {
+		if (unlikely(count == capacity)) {
+			_grow(capacity * 2);
+		}
+		if constexpr (!std::is_trivially_constructible<T>::value) {
+			memnew_placement(&data[count++], T(p_elem));
+		} else {
+			data[count++] = p_elem;
+		}
+	}
+
+	void resize(U p_size) {
+		if (p_size < count) {
+			if constexpr (!std::is_trivially_destructible<T>::value) {
+				for (U i = p_size; i < count; i++) {
+					data[i].~T();
+				}
+			}
+			count = p_size;
+		} else if (p_size > count) {
+			if (unlikely(p_size > capacity)) {
+				_grow(MAX(p_size, capacity * 2));
+			}
+			if constexpr (!std::is_trivially_constructible<T>::value) {
+				for (U i = count; i < p_size; i++) {
+					memnew_placement(&data[i], T);
+				}
+			}
+			count = p_size;
+		}
+	}
+
+	_FORCE_INLINE_ void clear() { resize(0); }
+
+	_FORCE_INLINE_ const T &operator[](U p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return data[p_index];
+	}
+	_FORCE_INLINE_ T &operator[](U p_index) {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return data[p_index];
+	}
+
+	_FORCE_INLINE_ T *begin() { return data; }
+	_FORCE_INLINE_ T *end() { return data + count; }
+	_FORCE_INLINE_ const T *begin() const { return data; }
+	_FORCE_INLINE_ const T *end() const { return data + count; }
+
+	operator Vector<T>() const {
+		Vector<T> ret;
+		ret.resize(count);
+		T *w = ret.ptrw();
+		for (U i = 0; i < count; i++) {
+			w[i] = data[i];
+		}
+		return ret;
+	}
+
+	void operator=(const SmallVector &p_from) {
+		if (this == &p_from) {
+			return;
+		}
+		clear();
+		reserve(p_from.count);
+		for (U i = 0; i < p_from.count; i++) {
+			push_back(p_from.data[i]);
+		}
+	}
+
+	_FORCE_INLINE_ SmallVector() {}
+	_FORCE_INLINE_ SmallVector(std::initializer_list<T> p_init) {
+		reserve(p_init.size());
+		for (const T &element : p_init) {
+			push_back(element);
+		}
+	}
+	_FORCE_INLINE_ SmallVector(const SmallVector &p_from) {
+		reserve(p_from.count);
+		for (U i = 0; i < p_from.count; i++) {
+			push_back(p_from.data[i]);
+		}
+	}
+
+	_FORCE_INLINE_ ~SmallVector() {
+		clear();
+		if (!_is_inline()) {
+			memfree(data);
+		}
+	}
+};
+
+#endif // SMALL_VECTOR_H
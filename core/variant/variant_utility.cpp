@@ -37,6 +37,7 @@
 #include "core/templates/oa_hash_map.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
+#include "core/templates/small_vector.h"
 #include "core/variant/binder_common.h"
 #include "core/variant/variant_parser.h"
 
@@ -1268,11 +1269,11 @@ static _FORCE_INLINE_ Variant::Type get_ret_type_helper(void (*p_func)(P...)) {
 			*r_ret = VariantUtilityFunctions::m_func(p_args, p_argcount, c);                                     \
 		}                                                                                                        \
 		static void ptrcall(void *ret, const void **p_args, int p_argcount) {                                    \
-			Vector<Variant> args;                                                                                \
+			SmallVector<Variant, 8> args;                                                                        \
 			for (int i = 0; i < p_argcount; i++) {                                                               \
 				args.push_back(PtrToArg<Variant>::convert(p_args[i]));                                           \
 			}                                                                                                    \
-			Vector<const Variant *> argsp;                                                                       \
+			SmallVector<const Variant *, 8> argsp;                                                               \
 			for (int i = 0; i < p_argcount; i++) {                                                               \
 				argsp.push_back(&args[i]);                                                                       \
 			}                                                                                                    \
@@ -1313,11 +1314,11 @@ static _FORCE_INLINE_ Variant::Type get_ret_type_helper(void (*p_func)(P...)) {
 			*r_ret = VariantUtilityFunctions::m_func(p_args, p_argcount, c);                                     \
 		}                                                                                                        \
 		static void ptrcall(void *ret, const void **p_args, int p_argcount) {                                    \
-			Vector<Variant> args;                                                                                \
+			SmallVector<Variant, 8> args;                                                                        \
 			for (int i = 0; i < p_argcount; i++) {                                                               \
 				args.push_back(PtrToArg<Variant>::convert(p_args[i]));                                           \
 			}                                                                                                    \
-			Vector<const Variant *> argsp;                                                                       \
+			SmallVector<const Variant *, 8> argsp;                                                               \
 			for (int i = 0; i < p_argcount; i++) {                                                               \
 				argsp.push_back(&args[i]);                                                                       \
 			}                                                                                                    \
@@ -1358,11 +1359,11 @@ static _FORCE_INLINE_ Variant::Type get_ret_type_helper(void (*p_func)(P...)) {
 			VariantUtilityFunctions::m_func(p_args, p_argcount, c);                                              \
 		}                                                                                                        \
 		static void ptrcall(void *ret, const void **p_args, int p_argcount) {                                    \
-			Vector<Variant> args;                                                                                \
+			SmallVector<Variant, 8> args;                                                                        \
 			for (int i = 0; i < p_argcount; i++) {                                                               \
 				args.push_back(PtrToArg<Variant>::convert(p_args[i]));                                           \
 			}                                                                                                    \
-			Vector<const Variant *> argsp;                                                                       \
+			SmallVector<const Variant *, 8> argsp;                                                               \
 			for (int i = 0; i < p_argcount; i++) {                                                               \
 				argsp.push_back(&args[i]);                                                                       \
 			}                                                                                                    \
@@ -37,6 +37,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -127,6 +128,7 @@ Error FileAccessUnix::open_internal(const String &p_path, int p_mode_flags) {
 
 	last_error = OK;
 	flags = p_mode_flags;
+	map_failed = false;
 	return OK;
 }
 
@@ -135,6 +137,12 @@ void FileAccessUnix::_close() {
 		return;
 	}
 
+	if (mapped) {
+		munmap(mapped, mapped_size);
+		mapped = nullptr;
+		mapped_size = 0;
+	}
+
 	fclose(f);
 	f = nullptr;
 
@@ -230,6 +238,32 @@ uint64_t FileAccessUnix::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return read;
 }
 
+const uint8_t *FileAccessUnix::get_mapped_buffer() const {
+	ERR_FAIL_COND_V_MSG(!f, nullptr, "File must be opened before use.");
+
+	if (mapped || map_failed) {
+		return mapped;
+	}
+
+	// Only files opened for reading, a mapping of a file being written would go stale.
+	// Empty files can't be mapped either.
+	uint64_t size = flags == READ ? get_length() : 0;
+	if (size == 0 || size > SIZE_MAX) {
+		map_failed = true;
+		return nullptr;
+	}
+
+	void *ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (ptr == MAP_FAILED) {
+		map_failed = true;
+		return nullptr;
+	}
+
+	mapped = (uint8_t *)ptr;
+	mapped_size = size;
+	return mapped;
+}
+
 Error FileAccessUnix::get_error() const {
 	return last_error;
 }
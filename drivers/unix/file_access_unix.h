@@ -49,6 +49,11 @@ class FileAccessUnix : public FileAccess {
 	String path;
 	String path_src;
 
+	// Lazily mapped in get_mapped_buffer(), for read-only files.
+	mutable uint8_t *mapped = nullptr;
+	mutable uint64_t mapped_size = 0;
+	mutable bool map_failed = false;
+
 	void _close();
 
 public:
@@ -69,6 +74,7 @@ public:
 
 	virtual uint8_t get_8() const override; ///< get a byte
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_mapped_buffer() const override;
 
 	virtual Error get_error() const override; ///< get last error
 
@@ -40,6 +40,7 @@
 #include <windows.h>
 
 #include <errno.h>
+#include <io.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <tchar.h>
@@ -148,6 +149,7 @@ Error FileAccessWindows::open_internal(const String &p_path, int p_mode_flags) {
 	} else {
 		last_error = OK;
 		flags = p_mode_flags;
+		map_failed = false;
 		return OK;
 	}
 }
@@ -157,6 +159,11 @@ void FileAccessWindows::_close() {
 		return;
 	}
 
+	if (mapped) {
+		UnmapViewOfFile(mapped);
+		mapped = nullptr;
+	}
+
 	fclose(f);
 	f = nullptr;
 
@@ -289,6 +296,45 @@ uint64_t FileAccessWindows::get_buffer(uint8_t *p_dst, uint64_t p_length) const
 	return read;
 }
 
+const uint8_t *FileAccessWindows::get_mapped_buffer() const {
+	ERR_FAIL_COND_V_MSG(!f, nullptr, "File must be opened before use.");
+
+	if (mapped || map_failed) {
+		return mapped;
+	}
+
+	// Only files opened for reading, a mapping of a file being written would go stale.
+	// Empty files can't be mapped either.
+	uint64_t size = flags == READ ? get_length() : 0;
+	if (size == 0 || size > SIZE_MAX) {
+		map_failed = true;
+		return nullptr;
+	}
+
+	HANDLE file_handle = (HANDLE)_get_osfhandle(_fileno(f));
+#ifdef UWP_ENABLED
+	HANDLE mapping = CreateFileMappingFromApp(file_handle, nullptr, PAGE_READONLY, 0, nullptr);
+#else
+	HANDLE mapping = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+#endif
+	if (!mapping) {
+		map_failed = true;
+		return nullptr;
+	}
+	// The view keeps the mapping alive, so the handle isn't needed anymore.
+#ifdef UWP_ENABLED
+	mapped = (uint8_t *)MapViewOfFileFromApp(mapping, FILE_MAP_READ, 0, 0);
+#else
+	mapped = (uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#endif
+	CloseHandle(mapping);
+
+	if (!mapped) {
+		map_failed = true;
+	}
+	return mapped;
+}
+
 Error FileAccessWindows::get_error() const {
 	return last_error;
 }
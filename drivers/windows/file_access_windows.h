@@ -48,6 +48,10 @@ class FileAccessWindows : public FileAccess {
 	String path_src;
 	String save_path;
 
+	// Lazily mapped in get_mapped_buffer(), for read-only files.
+	mutable uint8_t *mapped = nullptr;
+	mutable bool map_failed = false;
+
 	void _close();
 
 	static bool is_path_invalid(const String &p_path);
@@ -69,6 +73,7 @@ public:
 
 	virtual uint8_t get_8() const override; ///< get a byte
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_mapped_buffer() const override;
 
 	virtual Error get_error() const override; ///< get last error
 
@@ -34,7 +34,7 @@
 #include "core/crypto/crypto_core.h"
 #include "core/extension/gdextension.h"
 #include "core/io/file_access_encrypted.h"
-#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION, PackIndex
 #include "core/io/zip_io.h"
 #include "core/version.h"
 #include "editor/editor_file_system.h"
@@ -1612,25 +1612,24 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 		fhead = fae;
 	}
 
+	Vector<PackIndex::FileInfo> index_files;
+	index_files.resize(pd.file_ofs.size());
 	for (int i = 0; i < pd.file_ofs.size(); i++) {
-		uint32_t string_len = pd.file_ofs[i].path_utf8.length();
-		uint32_t pad = _get_pad(4, string_len);
-
-		fhead->store_32(string_len + pad);
-		fhead->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), string_len);
-		for (uint32_t j = 0; j < pad; j++) {
-			fhead->store_8(0);
-		}
-
-		fhead->store_64(pd.file_ofs[i].ofs);
-		fhead->store_64(pd.file_ofs[i].size); // pay attention here, this is where file is
-		fhead->store_buffer(pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
-		uint32_t flags = 0;
+		PackIndex::FileInfo &fi = index_files.write[i];
+		fi.path = String::utf8(pd.file_ofs[i].path_utf8.get_data(), pd.file_ofs[i].path_utf8.length());
+		fi.offset = pd.file_ofs[i].ofs;
+		fi.size = pd.file_ofs[i].size; // pay attention here, this is where file is
+		memcpy(fi.md5, pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
 		if (pd.file_ofs[i].encrypted) {
-			flags |= PACK_FILE_ENCRYPTED;
+			fi.flags |= PACK_FILE_ENCRYPTED;
 		}
-		fhead->store_32(flags);
 	}
+	Vector<uint8_t> index = PackIndex::build(index_files);
+	if (index.is_empty()) {
+		add_message(EXPORT_MESSAGE_ERROR, TTR("Save PCK"), TTR("Can't create the PCK directory."));
+		return ERR_CANT_CREATE;
+	}
+	fhead->store_buffer(index.ptr(), index.size());
 
 	if (fae.is_valid()) {
 		fhead.unref();
@@ -48,6 +48,7 @@
 #include "core/io/ip.h"
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
+#include "core/os/frame_allocator.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/register_core_types.h"
@@ -3222,6 +3223,11 @@ bool Main::iteration() {
 
 	iterating--;
 
+	if (iterating == 0) {
+		// Not from a nested iteration (e.g. a progress dialog), those are still inside a frame.
+		FrameAllocator::end_frame();
+	}
+
 	// Needed for OSs using input buffering regardless accumulation (like Android)
 	if (Input::get_singleton()->is_using_input_buffering() && !agile_input_event_flushing) {
 		Input::get_singleton()->flush_buffered_events();
@@ -32,6 +32,7 @@
 
 #include "core/object/message_queue.h"
 #include "core/os/os.h"
+#include "core/os/size_class_allocator.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
@@ -51,6 +52,7 @@ void Performance::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_custom_monitor", "id"), &Performance::get_custom_monitor);
 	ClassDB::bind_method(D_METHOD("get_monitor_modification_time"), &Performance::get_monitor_modification_time);
 	ClassDB::bind_method(D_METHOD("get_custom_monitor_names"), &Performance::get_custom_monitor_names);
+	ClassDB::bind_method(D_METHOD("get_memory_size_class_stats"), &Performance::get_memory_size_class_stats);
 
 	BIND_ENUM_CONSTANT(TIME_FPS);
 	BIND_ENUM_CONSTANT(TIME_PROCESS);
@@ -85,6 +87,11 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(MEMORY_SIZE_CLASS_USED);
+	BIND_ENUM_CONSTANT(MEMORY_SIZE_CLASS_RESERVED);
+	BIND_ENUM_CONSTANT(OBJECT_NODE_POOL_HITS);
+	BIND_ENUM_CONSTANT(OBJECT_NODE_POOL_MISSES);
+	BIND_ENUM_CONSTANT(OBJECT_POOLED_NODE_COUNT);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -133,6 +140,11 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"navigation/edges_merged",
 		"navigation/edges_connected",
 		"navigation/edges_free",
+		"memory/size_class_used",
+		"memory/size_class_reserved",
+		"object/node_pool_hits",
+		"object/node_pool_misses",
+		"object/pooled_nodes",
 
 	};
 
@@ -207,6 +219,22 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+		case MEMORY_SIZE_CLASS_USED:
+			return SizeClassAllocator::get_used_bytes();
+		case MEMORY_SIZE_CLASS_RESERVED:
+			return SizeClassAllocator::get_reserved_bytes();
+		case OBJECT_NODE_POOL_HITS: {
+			SceneTree *sml = Object::cast_to<SceneTree>(OS::get_singleton()->get_main_loop());
+			return sml ? sml->get_node_pool_hit_count() : 0;
+		}
+		case OBJECT_NODE_POOL_MISSES: {
+			SceneTree *sml = Object::cast_to<SceneTree>(OS::get_singleton()->get_main_loop());
+			return sml ? sml->get_node_pool_miss_count() : 0;
+		}
+		case OBJECT_POOLED_NODE_COUNT: {
+			SceneTree *sml = Object::cast_to<SceneTree>(OS::get_singleton()->get_main_loop());
+			return sml ? sml->get_pooled_node_count() : 0;
+		}
 
 		default: {
 		}
@@ -252,6 +280,11 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
@@ -313,6 +346,21 @@ uint64_t Performance::get_monitor_modification_time() {
 	return _monitor_modification_time;
 }
 
+TypedArray<Dictionary> Performance::get_memory_size_class_stats() const {
+	TypedArray<Dictionary> classes;
+	for (uint32_t i = 0; i < SizeClassAllocator::CLASS_COUNT; i++) {
+		SizeClassAllocator::Stats stats = SizeClassAllocator::get_stats(i);
+		Dictionary d;
+		d["size"] = (int64_t)stats.size;
+		d["allocations"] = stats.allocations;
+		d["in_use"] = stats.in_use;
+		d["cached"] = stats.cached;
+		d["reserved"] = stats.reserved;
+		classes.push_back(d);
+	}
+	return classes;
+}
+
 Performance::Performance() {
 	_process_time = 0;
 	_physics_process_time = 0;
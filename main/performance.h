@@ -100,6 +100,11 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		MEMORY_SIZE_CLASS_USED,
+		MEMORY_SIZE_CLASS_RESERVED,
+		OBJECT_NODE_POOL_HITS,
+		OBJECT_NODE_POOL_MISSES,
+		OBJECT_POOLED_NODE_COUNT,
 		MONITOR_MAX
 	};
 
@@ -126,6 +131,8 @@ public:
 
 	uint64_t get_monitor_modification_time();
 
+	TypedArray<Dictionary> get_memory_size_class_stats() const;
+
 	static Performance *get_singleton() { return singleton; }
 
 	Performance();
@@ -2014,11 +2014,25 @@ void GDScriptLanguage::init() {
 		_add_global(E.name, E.ptr);
 	}
 
+#ifdef DEBUG_ENABLED
+	if (GLOBAL_GET("debug/gdscript/sampling_profiler/enabled") && !Engine::get_singleton()->is_editor_hint()) {
+		set_sampling_profiler(memnew(GDScriptSamplingProfiler));
+		sampling_profiler->start(GLOBAL_GET("debug/gdscript/sampling_profiler/interval_usec"));
+	}
+#endif
+
 #ifdef TESTS_ENABLED
 	GDScriptTests::GDScriptTestRunner::handle_cmdline();
 #endif
 }
 
+void GDScriptLanguage::set_sampling_profiler(GDScriptSamplingProfiler *p_profiler) {
+	if (sampling_profiler) {
+		memdelete(sampling_profiler);
+	}
+	sampling_profiler = p_profiler;
+}
+
 String GDScriptLanguage::get_type() const {
 	return "GDScript";
 }
@@ -2038,6 +2052,17 @@ void GDScriptLanguage::finish() {
 		_call_stack = nullptr;
 	}
 
+	if (sampling_profiler) {
+		sampling_profiler->stop();
+		String output_path = GLOBAL_GET("debug/gdscript/sampling_profiler/output_path");
+		if (!output_path.is_empty() && sampling_profiler->get_total_samples() > 0) {
+			sampling_profiler->save(output_path);
+		}
+		set_sampling_profiler(nullptr);
+	}
+
+	state_stack_pool.clear();
+
 	// Clear the cache before parsing the script_list
 	GDScriptCache::clear();
 
@@ -2071,6 +2096,32 @@ void GDScriptLanguage::finish() {
 	}
 }
 
+Vector<uint8_t> GDScriptLanguage::_take_state_stack(uint32_t p_size) {
+	// Must be called with the mutex held.
+	Vector<uint8_t> stack;
+	LocalVector<Vector<uint8_t>> *pool = state_stack_pool.getptr(p_size);
+	if (pool && pool->size() > 0) {
+		stack = (*pool)[pool->size() - 1];
+		pool->resize(pool->size() - 1);
+	} else {
+		stack.resize(p_size);
+	}
+	return stack;
+}
+
+void GDScriptLanguage::_release_state_stack(Vector<uint8_t> &p_stack) {
+	// Must be called with the mutex held, and the stack cleared.
+	static const uint32_t MAX_POOLED_STACKS = 256;
+	if (p_stack.is_empty()) {
+		return;
+	}
+	LocalVector<Vector<uint8_t>> &pool = state_stack_pool[p_stack.size()];
+	if (pool.size() < MAX_POOLED_STACKS) {
+		pool.push_back(p_stack);
+	}
+	p_stack = Vector<uint8_t>();
+}
+
 void GDScriptLanguage::profiling_start() {
 #ifdef DEBUG_ENABLED
 	MutexLock lock(this->mutex);
@@ -2342,6 +2393,9 @@ void GDScriptLanguage::frame() {
 		}
 	}
 
+	if (sampling_profiler) {
+		sampling_profiler->flush();
+	}
 #endif
 }
 
@@ -2577,6 +2631,10 @@ GDScriptLanguage::GDScriptLanguage() {
 	}
 
 #ifdef DEBUG_ENABLED
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/enabled", false);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "debug/gdscript/sampling_profiler/interval_usec", PROPERTY_HINT_RANGE, "100,100000,1,or_greater"), 1000);
+	GLOBAL_DEF(PropertyInfo(Variant::STRING, "debug/gdscript/sampling_profiler/output_path", PROPERTY_HINT_SAVE_FILE, "*.folded"), "user://gdscript_profile.folded");
+
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/exclude_addons", true);
 	for (int i = 0; i < (int)GDScriptWarning::WARNING_MAX; i++) {
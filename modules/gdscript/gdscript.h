@@ -39,6 +39,7 @@
 #include "core/object/script_language.h"
 #include "core/templates/rb_set.h"
 #include "gdscript_function.h"
+#include "gdscript_sampling_profiler.h"
 
 class GDScriptNativeClass : public RefCounted {
 	GDCLASS(GDScriptNativeClass, RefCounted);
@@ -375,8 +376,16 @@ class GDScriptLanguage : public ScriptLanguage {
 	friend class GDScriptFunction;
 
 	SelfList<GDScriptFunction>::List function_list;
+
+	// Stack buffers of finished GDScriptFunctionStates, by size, reused by
+	// the next `await`. Guarded by `mutex`.
+	HashMap<uint32_t, LocalVector<Vector<uint8_t>>> state_stack_pool;
+	Vector<uint8_t> _take_state_stack(uint32_t p_size);
+	void _release_state_stack(Vector<uint8_t> &p_stack);
+
 	bool profiling;
 	uint64_t script_frame_time;
+	GDScriptSamplingProfiler *sampling_profiler = nullptr;
 
 	HashMap<String, ObjectID> orphan_subclasses;
 
@@ -386,6 +395,11 @@ public:
 	bool debug_break(const String &p_error, bool p_allow_continue = true);
 	bool debug_break_parse(const String &p_file, int p_line, const String &p_error);
 
+	// Takes ownership of the profiler, and frees the previous one. Must not be
+	// called while GDScript functions are running.
+	void set_sampling_profiler(GDScriptSamplingProfiler *p_profiler);
+	GDScriptSamplingProfiler *get_sampling_profiler() const { return sampling_profiler; }
+
 	_FORCE_INLINE_ void enter_function(GDScriptInstance *p_instance, GDScriptFunction *p_function, Variant *p_stack, int *p_ip, int *p_line) {
 		if (Thread::get_main_id() != Thread::get_caller_id()) {
 			return; //no support for other threads than main for now
@@ -33,6 +33,59 @@
 #include "core/debugger/engine_debugger.h"
 #include "gdscript.h"
 
+// Operators on two ints or two floats have their own opcodes, which read and
+// write the values without calling an evaluator. Greater comparisons use the
+// less opcodes with the operands swapped.
+static bool _get_typed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type, GDScriptFunction::Opcode &r_opcode, bool &r_swap_operands) {
+	if (p_left_type != p_right_type || (p_left_type != Variant::INT && p_left_type != Variant::FLOAT)) {
+		return false;
+	}
+
+	bool is_int = p_left_type == Variant::INT;
+	r_swap_operands = false;
+
+	switch (p_operator) {
+		case Variant::OP_ADD:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_ADD_INT : GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT;
+			return true;
+		case Variant::OP_SUBTRACT:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT : GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT;
+			return true;
+		case Variant::OP_MULTIPLY:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT : GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT;
+			return true;
+		case Variant::OP_DIVIDE:
+			// Integer division stays on the validated operator until a zero divisor check is added to both.
+			if (is_int) {
+				return false;
+			}
+			r_opcode = GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT;
+			return true;
+		case Variant::OP_EQUAL:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT : GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+			return true;
+		case Variant::OP_NOT_EQUAL:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT : GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT;
+			return true;
+		case Variant::OP_LESS:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_LESS_INT : GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT;
+			return true;
+		case Variant::OP_LESS_EQUAL:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT : GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT;
+			return true;
+		case Variant::OP_GREATER:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_LESS_INT : GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT;
+			r_swap_operands = true;
+			return true;
+		case Variant::OP_GREATER_EQUAL:
+			r_opcode = is_int ? GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT : GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT;
+			r_swap_operands = true;
+			return true;
+		default:
+			return false;
+	}
+}
+
 uint32_t GDScriptByteCodeGenerator::add_parameter(const StringName &p_name, bool p_is_optional, const GDScriptDataType &p_type) {
 #ifdef TOOLS_ENABLED
 	function->arg_names.push_back(p_name);
@@ -585,6 +638,16 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 			}
 		}
 
+		GDScriptFunction::Opcode typed_opcode;
+		bool swap_operands;
+		if (_get_typed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type, typed_opcode, swap_operands)) {
+			append_opcode(typed_opcode);
+			append(swap_operands ? p_right_operand : p_left_operand);
+			append(swap_operands ? p_left_operand : p_right_operand);
+			append(p_target);
+			return;
+		}
+
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
@@ -793,6 +856,24 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
+	if (HAS_BUILTIN_TYPE(p_source) && (p_source.type.builtin_type == Variant::VECTOR2 || p_source.type.builtin_type == Variant::VECTOR3)) {
+		// Vector components are read directly, without a validated getter.
+		int axis = -1;
+		if (p_name == SNAME("x")) {
+			axis = 0;
+		} else if (p_name == SNAME("y")) {
+			axis = 1;
+		} else if (p_name == SNAME("z") && p_source.type.builtin_type == Variant::VECTOR3) {
+			axis = 2;
+		}
+		if (axis >= 0) {
+			append_opcode(p_source.type.builtin_type == Variant::VECTOR2 ? GDScriptFunction::OPCODE_GET_VECTOR2_COMPONENT : GDScriptFunction::OPCODE_GET_VECTOR3_COMPONENT);
+			append(p_source);
+			append(p_target);
+			append(axis);
+			return;
+		}
+	}
 	if (HAS_BUILTIN_TYPE(p_source) && Variant::get_member_validated_getter(p_source.type.builtin_type, p_name)) {
 		Variant::ValidatedGetter getter = Variant::get_member_validated_getter(p_source.type.builtin_type, p_name);
 		append_opcode(GDScriptFunction::OPCODE_GET_NAMED_VALIDATED);
@@ -31,6 +31,7 @@
 #include "gdscript_cache.h"
 
 #include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/vector.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
@@ -43,6 +44,7 @@ bool GDScriptParserRef::is_valid() const {
 }
 
 GDScriptParserRef::Status GDScriptParserRef::get_status() const {
+	MutexLock lock(parse_mutex);
 	return status;
 }
 
@@ -60,16 +62,18 @@ GDScriptAnalyzer *GDScriptParserRef::get_analyzer() {
 Error GDScriptParserRef::raise_status(Status p_new_status) {
 	ERR_FAIL_COND_V(parser == nullptr, ERR_INVALID_DATA);
 
-	if (result != OK) {
+	MutexLock lock(parse_mutex);
+	if (p_new_status > EMPTY && status == EMPTY) {
+		status = PARSED;
+		result = parser->parse(GDScriptCache::get_source_code(path), path, false);
+	}
+
+	if (p_new_status <= PARSED || result != OK) {
 		return result;
 	}
 
 	while (p_new_status > status) {
 		switch (status) {
-			case EMPTY:
-				status = PARSED;
-				result = parser->parse(GDScriptCache::get_source_code(path), path, false);
-				break;
 			case PARSED: {
 				status = INHERITANCE_SOLVED;
 				Error inheritance_result = get_analyzer()->resolve_inheritance();
@@ -91,6 +95,7 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 					result = body_result;
 				}
 			} break;
+			case EMPTY: // Handled above.
 			case FULLY_SOLVED: {
 				return result;
 			}
@@ -191,17 +196,14 @@ void GDScriptCache::remove_script(const String &p_path) {
 	singleton->full_gdscript_cache.erase(p_path);
 }
 
-Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
-	MutexLock lock(singleton->mutex);
+Ref<GDScriptParserRef> GDScriptCache::_get_parser_ref(const String &p_path, Error &r_error) {
+	// Must be called with the cache mutex held.
 	Ref<GDScriptParserRef> ref;
-	if (!p_owner.is_empty()) {
-		singleton->dependencies[p_owner].insert(p_path);
-	}
+	r_error = OK;
 	if (singleton->parser_map.has(p_path)) {
 		ref = Ref<GDScriptParserRef>(singleton->parser_map[p_path]);
 		if (ref.is_null()) {
 			r_error = ERR_INVALID_DATA;
-			return ref;
 		}
 	} else {
 		if (!FileAccess::exists(p_path)) {
@@ -214,6 +216,120 @@ Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptP
 		ref->path = p_path;
 		singleton->parser_map[p_path] = ref.ptr();
 	}
+	return ref;
+}
+
+void GDScriptCache::_parse_parser_ref(void *p_userdata, uint32_t p_index) {
+	Ref<GDScriptParserRef> *parsers = (Ref<GDScriptParserRef> *)p_userdata;
+	parsers[p_index]->raise_status(GDScriptParserRef::PARSED);
+}
+
+void GDScriptCache::_get_parsed_dependencies(const Ref<GDScriptParserRef> &p_ref, Vector<String> &r_paths) {
+	const GDScriptParser *parser = p_ref->get_parser();
+	const GDScriptParser::ClassNode *tree = parser->get_tree();
+	if (tree == nullptr) {
+		return;
+	}
+	const StringName gdscript_name = GDScriptLanguage::get_singleton()->get_name();
+
+	if (!tree->extends_path.is_empty()) {
+		String base_path = tree->extends_path;
+		if (base_path.is_relative_path()) {
+			base_path = p_ref->path.get_base_dir().path_join(base_path).simplify_path();
+		}
+		r_paths.push_back(base_path);
+	} else if (!tree->extends.is_empty() && ScriptServer::is_global_class(tree->extends[0]) && ScriptServer::get_global_class_language(tree->extends[0]) == gdscript_name) {
+		r_paths.push_back(ScriptServer::get_global_class_path(tree->extends[0]));
+	}
+
+	for (const String &path : parser->get_preloaded_paths()) {
+		if (path.get_extension().to_lower() == "gd") {
+			r_paths.push_back(path);
+		}
+	}
+
+	for (const StringName &name : parser->get_referenced_identifiers()) {
+		if (ScriptServer::is_global_class(name) && ScriptServer::get_global_class_language(name) == gdscript_name) {
+			r_paths.push_back(ScriptServer::get_global_class_path(name));
+		}
+	}
+}
+
+int GDScriptCache::parse_dependencies(const String &p_path, Vector<Ref<GDScriptParserRef>> &r_parsers) {
+	// Parses the script and every script it depends on (base scripts, preloaded
+	// scripts and global classes it references), one dependency level per batch,
+	// spreading each batch over the WorkerThreadPool. The analyzer and compiler
+	// then find the trees already parsed in the parser map.
+	// Only parsing is done here: analysis resolves other scripts and has to
+	// happen in dependency order under the cache mutex.
+	HashSet<String> visited;
+	Vector<String> pending;
+	pending.push_back(p_path);
+	int parsed_on_pool = 0;
+
+	// Shared lookup tables are built lazily, make sure that happens on this thread.
+	GDScriptParser::get_builtin_type(StringName());
+
+	while (!pending.is_empty()) {
+		Vector<Ref<GDScriptParserRef>> batch;
+		{
+			MutexLock lock(singleton->mutex);
+			if (singleton->cleared) {
+				return parsed_on_pool;
+			}
+			for (const String &path : pending) {
+				if (visited.has(path) || singleton->full_gdscript_cache.has(path)) {
+					continue;
+				}
+				visited.insert(path);
+				Error err = OK;
+				Ref<GDScriptParserRef> ref = _get_parser_ref(path, err);
+				if (err == OK) {
+					batch.push_back(ref);
+				}
+			}
+		}
+		pending.clear();
+
+		if (batch.is_empty()) {
+			break;
+		}
+
+		// Not done from pool threads (e.g. scripts loaded by a threaded resource
+		// load), which would block waiting for a group nothing may be left to run.
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (batch.size() > 1 && pool != nullptr && pool->get_thread_count() > 1 && pool->get_thread_index() == -1) {
+			WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&GDScriptCache::_parse_parser_ref, batch.ptrw(), batch.size(), -1, true, SNAME("GDScriptParse"));
+			pool->wait_for_group_task_completion(group_task);
+			parsed_on_pool += batch.size();
+		} else {
+			for (int i = 0; i < batch.size(); i++) {
+				_parse_parser_ref(batch.ptrw(), i);
+			}
+		}
+
+		Ref<GDScriptParserRef> *batch_ptr = batch.ptrw();
+		for (int i = 0; i < batch.size(); i++) {
+			// Already parsed, this only reads the result under the lock.
+			if (batch_ptr[i]->raise_status(GDScriptParserRef::PARSED) == OK) {
+				_get_parsed_dependencies(batch_ptr[i], pending);
+			}
+		}
+		r_parsers.append_array(batch);
+	}
+
+	return parsed_on_pool;
+}
+
+Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
+	MutexLock lock(singleton->mutex);
+	if (!p_owner.is_empty()) {
+		singleton->dependencies[p_owner].insert(p_path);
+	}
+	Ref<GDScriptParserRef> ref = _get_parser_ref(p_path, r_error);
+	if (r_error != OK) {
+		return ref;
+	}
 	r_error = ref->raise_status(p_status);
 
 	return ref;
@@ -265,6 +381,12 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_e
 }
 
 Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_error, const String &p_owner, bool p_update_from_disk) {
+	// Keeps the parsed trees alive until compilation is done.
+	Vector<Ref<GDScriptParserRef>> parsers;
+	if (!p_update_from_disk && get_cached_script(p_path).is_null()) {
+		parse_dependencies(p_path, parsers);
+	}
+
 	MutexLock lock(singleton->mutex);
 
 	if (!p_owner.is_empty()) {
@@ -59,6 +59,12 @@ private:
 	String path;
 	bool cleared = false;
 
+	// Guards status and result. Parsing may run on a worker thread, see
+	// GDScriptCache::parse_dependencies(), and analysis holds it too so both
+	// never overlap. Recursive, since analysis can raise the status of the same
+	// script again through cyclic references.
+	mutable Mutex parse_mutex;
+
 	friend class GDScriptCache;
 
 public:
@@ -92,10 +98,17 @@ class GDScriptCache {
 
 	Mutex mutex;
 
+	static Ref<GDScriptParserRef> _get_parser_ref(const String &p_path, Error &r_error);
+	static void _parse_parser_ref(void *p_userdata, uint32_t p_index);
+	static void _get_parsed_dependencies(const Ref<GDScriptParserRef> &p_ref, Vector<String> &r_paths);
+
 public:
 	static void move_script(const String &p_from, const String &p_to);
 	static void remove_script(const String &p_path);
 	static Ref<GDScriptParserRef> get_parser(const String &p_path, GDScriptParserRef::Status status, Error &r_error, const String &p_owner = String());
+	// Parses the script and its dependencies ahead of analysis, keeping them alive in r_parsers.
+	// Returns the number of scripts that were parsed on the WorkerThreadPool.
+	static int parse_dependencies(const String &p_path, Vector<Ref<GDScriptParserRef>> &r_parsers);
 	static String get_source_code(const String &p_path);
 	static Ref<GDScript> get_shallow_script(const String &p_path, Error &r_error, const String &p_owner = String());
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String(), bool p_update_from_disk = false);
@@ -196,6 +196,42 @@ static bool _is_exact_type(const PropertyInfo &p_par_type, const GDScriptDataTyp
 	}
 }
 
+// Typed locals of these types always hold a value of their type, stored inline
+// in the Variant. Validated operators can then write the result straight into
+// the local, skipping the temporary and the assignment. The operands are read
+// before the result is written, so the local may also be one of them.
+static bool _can_operate_in_place(const GDScriptCodeGenerator::Address &p_target, Variant::Operator p_operator, const GDScriptDataType &p_left_type, const GDScriptDataType &p_right_type) {
+	if (p_target.mode != GDScriptCodeGenerator::Address::LOCAL_VARIABLE || !p_target.type.has_type || p_target.type.kind != GDScriptDataType::BUILTIN) {
+		return false;
+	}
+
+	switch (p_target.type.builtin_type) {
+		case Variant::BOOL:
+		case Variant::INT:
+		case Variant::FLOAT:
+		case Variant::VECTOR2:
+		case Variant::VECTOR2I:
+		case Variant::RECT2:
+		case Variant::RECT2I:
+		case Variant::VECTOR3:
+		case Variant::VECTOR3I:
+		case Variant::VECTOR4:
+		case Variant::VECTOR4I:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+		case Variant::COLOR:
+			break;
+		default:
+			return false;
+	}
+
+	if (!p_left_type.has_type || p_left_type.kind != GDScriptDataType::BUILTIN || !p_right_type.has_type || p_right_type.kind != GDScriptDataType::BUILTIN) {
+		return false;
+	}
+
+	return Variant::get_operator_return_type(p_operator, p_left_type.builtin_type, p_right_type.builtin_type) == p_target.type.builtin_type;
+}
+
 static bool _can_use_ptrcall(const MethodBind *p_method, const Vector<GDScriptCodeGenerator::Address> &p_arguments) {
 	if (p_method->is_vararg()) {
 		// ptrcall won't work with vararg methods.
@@ -1166,13 +1202,50 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 					}
 				}
 
+				bool has_operation = assignment->operation != GDScriptParser::AssignmentNode::OP_NONE;
+
+				if (!is_member && !has_operation && !assignment->use_conversion_assign && assignment->assigned_value->type == GDScriptParser::Node::BINARY_OPERATOR) {
+					// `local = a op b`, evaluate the operator into the local.
+					const GDScriptParser::BinaryOpNode *binary = static_cast<const GDScriptParser::BinaryOpNode *>(assignment->assigned_value);
+					bool is_plain_operator = binary->operation != GDScriptParser::BinaryOpNode::OP_LOGIC_AND && binary->operation != GDScriptParser::BinaryOpNode::OP_LOGIC_OR && binary->operation != GDScriptParser::BinaryOpNode::OP_TYPE_TEST;
+					if (is_plain_operator && _can_operate_in_place(target, binary->variant_op, _gdtype_from_datatype(binary->left_operand->get_datatype(), codegen.script), _gdtype_from_datatype(binary->right_operand->get_datatype(), codegen.script))) {
+						GDScriptCodeGenerator::Address left_operand = _parse_expression(codegen, r_error, binary->left_operand);
+						if (r_error) {
+							return GDScriptCodeGenerator::Address();
+						}
+						GDScriptCodeGenerator::Address right_operand = _parse_expression(codegen, r_error, binary->right_operand);
+						if (r_error) {
+							return GDScriptCodeGenerator::Address();
+						}
+
+						gen->write_binary_operator(target, binary->variant_op, left_operand, right_operand);
+
+						if (right_operand.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+							gen->pop_temporary();
+						}
+						if (left_operand.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+							gen->pop_temporary();
+						}
+						return GDScriptCodeGenerator::Address(); // Assignment does not return a value.
+					}
+				}
+
 				GDScriptCodeGenerator::Address assigned_value = _parse_expression(codegen, r_error, assignment->assigned_value);
 				if (r_error) {
 					return GDScriptCodeGenerator::Address();
 				}
 
+				if (!is_member && has_operation && !assignment->use_conversion_assign && _can_operate_in_place(target, assignment->variant_op, target.type, assigned_value.type)) {
+					// `local op= value`, evaluate the operator into the local.
+					gen->write_binary_operator(target, assignment->variant_op, target, assigned_value);
+
+					if (assigned_value.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+						gen->pop_temporary();
+					}
+					return GDScriptCodeGenerator::Address(); // Assignment does not return a value.
+				}
+
 				GDScriptCodeGenerator::Address to_assign;
-				bool has_operation = assignment->operation != GDScriptParser::AssignmentNode::OP_NONE;
 				if (has_operation) {
 					// Perform operation.
 					GDScriptCodeGenerator::Address op_result = codegen.add_temporary(_gdtype_from_datatype(assignment->get_datatype(), codegen.script));
@@ -135,6 +135,35 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+
+#define DISASSEMBLE_OPERATOR_TYPED(m_op, m_type, m_symbol) \
+	case OPCODE_OPERATOR_##m_op##_##m_type: {              \
+		text += "operator ";                               \
+		text += #m_type;                                   \
+		text += " ";                                       \
+		text += DADDR(3);                                  \
+		text += " = ";                                     \
+		text += DADDR(1);                                  \
+		text += " " m_symbol " ";                          \
+		text += DADDR(2);                                  \
+		incr += 4;                                         \
+	} break
+
+				DISASSEMBLE_OPERATOR_TYPED(ADD, INT, "+");
+				DISASSEMBLE_OPERATOR_TYPED(SUBTRACT, INT, "-");
+				DISASSEMBLE_OPERATOR_TYPED(MULTIPLY, INT, "*");
+				DISASSEMBLE_OPERATOR_TYPED(EQUAL, INT, "==");
+				DISASSEMBLE_OPERATOR_TYPED(NOT_EQUAL, INT, "!=");
+				DISASSEMBLE_OPERATOR_TYPED(LESS, INT, "<");
+				DISASSEMBLE_OPERATOR_TYPED(LESS_EQUAL, INT, "<=");
+				DISASSEMBLE_OPERATOR_TYPED(ADD, FLOAT, "+");
+				DISASSEMBLE_OPERATOR_TYPED(SUBTRACT, FLOAT, "-");
+				DISASSEMBLE_OPERATOR_TYPED(MULTIPLY, FLOAT, "*");
+				DISASSEMBLE_OPERATOR_TYPED(DIVIDE, FLOAT, "/");
+				DISASSEMBLE_OPERATOR_TYPED(EQUAL, FLOAT, "==");
+				DISASSEMBLE_OPERATOR_TYPED(NOT_EQUAL, FLOAT, "!=");
+				DISASSEMBLE_OPERATOR_TYPED(LESS, FLOAT, "<");
+				DISASSEMBLE_OPERATOR_TYPED(LESS_EQUAL, FLOAT, "<=");
 			case OPCODE_EXTENDS_TEST: {
 				text += "is object ";
 				text += DADDR(3);
@@ -260,6 +289,18 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 4;
 			} break;
+			case OPCODE_GET_VECTOR2_COMPONENT:
+			case OPCODE_GET_VECTOR3_COMPONENT: {
+				static const char *axis_names[] = { "x", "y", "z" };
+				text += "get_named component ";
+				text += DADDR(2);
+				text += " = ";
+				text += DADDR(1);
+				text += ".";
+				text += axis_names[_code_ptr[ip + 3]];
+
+				incr += 4;
+			} break;
 			case OPCODE_SET_MEMBER: {
 				text += "set_member ";
 				text += "[\"";
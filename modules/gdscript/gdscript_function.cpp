@@ -30,6 +30,7 @@
 
 #include "gdscript_function.h"
 
+#include "core/templates/hashfuncs.h"
 #include "gdscript.h"
 
 const int *GDScriptFunction::get_code() const {
@@ -161,6 +162,10 @@ GDScriptFunction::~GDScriptFunction() {
 	return_type.script_type_ref = Ref<Script>();
 
 #ifdef DEBUG_ENABLED
+	if (GDScriptLanguage::get_singleton()->sampling_profiler) {
+		// Pending samples may point to this function.
+		GDScriptLanguage::get_singleton()->sampling_profiler->flush();
+	}
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->mutex);
 
@@ -170,6 +175,69 @@ GDScriptFunction::~GDScriptFunction() {
 
 /////////////////////
 
+// Resumes a function state when the awaited signal is emitted. Used instead
+// of binding the state to `_signal_callback`, which needs a bound argument
+// array and a method lookup on every `await`.
+class GDScriptFunctionStateResumeCallable : public CallableCustom {
+	Ref<GDScriptFunctionState> state;
+
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return static_cast<const GDScriptFunctionStateResumeCallable *>(p_a)->state == static_cast<const GDScriptFunctionStateResumeCallable *>(p_b)->state;
+	}
+
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return static_cast<const GDScriptFunctionStateResumeCallable *>(p_a)->state.ptr() < static_cast<const GDScriptFunctionStateResumeCallable *>(p_b)->state.ptr();
+	}
+
+public:
+	uint32_t hash() const override {
+		return hash_murmur3_one_64((uint64_t)state.ptr());
+	}
+
+	String get_as_text() const override {
+		return "GDScriptFunctionState::resume";
+	}
+
+	CompareEqualFunc get_compare_equal_func() const override {
+		return compare_equal;
+	}
+
+	CompareLessFunc get_compare_less_func() const override {
+		return compare_less;
+	}
+
+	ObjectID get_object() const override {
+		return state->get_instance_id();
+	}
+
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override {
+		r_call_error.error = Callable::CallError::CALL_OK;
+
+		Variant arg;
+		if (p_argcount == 1) {
+			arg = *p_arguments[0];
+		} else if (p_argcount > 1) {
+			Array extra_args;
+			for (int i = 0; i < p_argcount; i++) {
+				extra_args.push_back(*p_arguments[i]);
+			}
+			arg = extra_args;
+		}
+
+		// Keep the state alive, the connection holding this callable is
+		// removed when the signal is done emitting.
+		Ref<GDScriptFunctionState> keep_alive = state;
+		r_return_value = keep_alive->resume(arg);
+	}
+
+	GDScriptFunctionStateResumeCallable(GDScriptFunctionState *p_state) :
+			state(p_state) {}
+};
+
+Callable GDScriptFunctionState::_get_resume_callable() {
+	return Callable(memnew(GDScriptFunctionStateResumeCallable(this)));
+}
+
 Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	Variant arg;
 	r_error.error = Callable::CallError::CALL_OK;
@@ -279,7 +347,13 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 		}
 
 		_clear_stack();
+#else
+		// The stack was already freed when the function returned.
+		state.stack_size = 0;
 #endif
+
+		MutexLock lock(GDScriptLanguage::singleton->mutex);
+		GDScriptLanguage::singleton->_release_state_stack(state.stack);
 	}
 
 	return ret;
@@ -31,6 +31,7 @@
 #include "gdscript_lambda_callable.h"
 
 #include "core/templates/hashfuncs.h"
+#include "core/templates/small_vector.h"
 #include "gdscript.h"
 
 bool GDScriptLambdaCallable::compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
@@ -70,16 +71,16 @@ void GDScriptLambdaCallable::call(const Variant **p_arguments, int p_argcount, V
 	int captures_amount = captures.size();
 
 	if (captures_amount > 0) {
-		Vector<const Variant *> args;
+		SmallVector<const Variant *, 8> args;
 		args.resize(p_argcount + captures_amount);
 		for (int i = 0; i < captures_amount; i++) {
-			args.write[i] = &captures[i];
+			args[i] = &captures[i];
 		}
 		for (int i = 0; i < p_argcount; i++) {
-			args.write[i + captures_amount] = p_arguments[i];
+			args[i + captures_amount] = p_arguments[i];
 		}
 
-		r_return_value = function->call(nullptr, args.ptrw(), args.size(), r_call_error);
+		r_return_value = function->call(nullptr, args.ptr(), args.size(), r_call_error);
 		r_call_error.argument -= captures_amount;
 	} else {
 		r_return_value = function->call(nullptr, p_arguments, p_argcount, r_call_error);
@@ -139,16 +140,16 @@ void GDScriptLambdaSelfCallable::call(const Variant **p_arguments, int p_argcoun
 	int captures_amount = captures.size();
 
 	if (captures_amount > 0) {
-		Vector<const Variant *> args;
+		SmallVector<const Variant *, 8> args;
 		args.resize(p_argcount + captures_amount);
 		for (int i = 0; i < captures_amount; i++) {
-			args.write[i] = &captures[i];
+			args[i] = &captures[i];
 		}
 		for (int i = 0; i < p_argcount; i++) {
-			args.write[i + captures_amount] = p_arguments[i];
+			args[i + captures_amount] = p_arguments[i];
 		}
 
-		r_return_value = function->call(static_cast<GDScriptInstance *>(object->get_script_instance()), args.ptrw(), args.size(), r_call_error);
+		r_return_value = function->call(static_cast<GDScriptInstance *>(object->get_script_instance()), args.ptr(), args.size(), r_call_error);
 		r_call_error.argument -= captures_amount;
 	} else {
 		r_return_value = function->call(static_cast<GDScriptInstance *>(object->get_script_instance()), p_arguments, p_argcount, r_call_error);
@@ -134,6 +134,8 @@ void GDScriptParser::clear() {
 	errors.clear();
 	multiline_stack.clear();
 	nodes_in_progress.clear();
+	preloaded_paths.clear();
+	referenced_identifiers.clear();
 }
 
 void GDScriptParser::push_error(const String &p_message, const Node *p_origin) {
@@ -2275,6 +2277,8 @@ GDScriptParser::ExpressionNode *GDScriptParser::parse_identifier(ExpressionNode
 			case SuiteNode::Local::UNDEFINED:
 				ERR_FAIL_V_MSG(nullptr, "Undefined local found.");
 		}
+	} else {
+		referenced_identifiers.insert(identifier->name);
 	}
 
 	return identifier;
@@ -3086,6 +3090,13 @@ GDScriptParser::ExpressionNode *GDScriptParser::parse_preload(ExpressionNode *p_
 
 	if (preload->path == nullptr) {
 		push_error(R"(Expected resource path after "(".)");
+	} else if (preload->path->type == Node::LITERAL && static_cast<LiteralNode *>(preload->path)->value.get_type() == Variant::STRING) {
+		// Resolved the same way as in GDScriptAnalyzer::reduce_preload().
+		String path = static_cast<LiteralNode *>(preload->path)->value;
+		if (path.is_relative_path()) {
+			path = script_path.get_base_dir().path_join(path);
+		}
+		preloaded_paths.insert(path.simplify_path());
 	}
 
 	pop_completion_call();
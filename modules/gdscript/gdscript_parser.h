@@ -1266,6 +1266,11 @@ private:
 	Node *list = nullptr;
 	List<ParserError> errors;
 
+	// Gathered while parsing, so GDScriptCache can parse the scripts this one
+	// depends on before analyzing it.
+	HashSet<String> preloaded_paths;
+	HashSet<StringName> referenced_identifiers;
+
 #ifdef DEBUG_ENABLED
 	bool is_ignoring_warnings = false;
 	List<GDScriptWarning> warnings;
@@ -1485,6 +1490,10 @@ public:
 	bool annotation_exists(const String &p_annotation_name) const;
 
 	const List<ParserError> &get_errors() const { return errors; }
+	// Resolved paths of preload() calls with a literal path.
+	const HashSet<String> &get_preloaded_paths() const { return preloaded_paths; }
+	// Identifiers not referring to locals, including type names. Some may be global classes.
+	const HashSet<StringName> &get_referenced_identifiers() const { return referenced_identifiers; }
 	const List<String> get_dependencies() const {
 		// TODO: Keep track of deps.
 		return List<String>();
@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "core/config/engine.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+#include "core/string/string_builder.h"
+#include "gdscript.h"
+#include "gdscript_function.h"
+
+void GDScriptSamplingProfiler::_thread_func(void *p_user) {
+	GDScriptSamplingProfiler *profiler = (GDScriptSamplingProfiler *)p_user;
+	while (!profiler->exit_thread.is_set()) {
+		profiler->_take_sample();
+		OS::get_singleton()->delay_usec(profiler->interval_usec);
+	}
+}
+
+void GDScriptSamplingProfiler::_take_sample() {
+	Scope scope = Engine::get_singleton()->is_in_physics_frame() ? SCOPE_PHYSICS : SCOPE_PROCESS;
+
+	GDScriptFunction *functions[MAX_DEPTH];
+	int lines[MAX_DEPTH];
+	uint32_t count = 0;
+
+	// Held until the sample is queued: a function freed in between would
+	// flush before this sample is queued, leaving a dangling pointer.
+	MutexLock lock(pending_mutex);
+
+	// Seqlock-style read: give up on this sample if the main thread keeps
+	// pushing and popping frames while we copy.
+	bool consistent = false;
+	for (int attempt = 0; attempt < 4 && !consistent; attempt++) {
+		uint32_t seq = sequence.get();
+		if (seq & 1) {
+			continue;
+		}
+		count = MIN(depth, (uint32_t)MAX_DEPTH);
+		for (uint32_t i = 0; i < count; i++) {
+			functions[i] = frames[i].function;
+			lines[i] = frames[i].line.load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		consistent = sequence.get() == seq;
+	}
+	if (!consistent) {
+		return;
+	}
+
+	Sample sample;
+	sample.frame_offset = pending_functions.size();
+	sample.frame_count = count;
+	sample.scope = scope;
+	pending_samples.push_back(sample);
+	for (uint32_t i = 0; i < count; i++) {
+		pending_functions.push_back(functions[i]);
+		pending_lines.push_back(lines[i]);
+	}
+}
+
+void GDScriptSamplingProfiler::start(uint64_t p_interval_usec) {
+	ERR_FAIL_COND(thread.is_started());
+	interval_usec = MAX(p_interval_usec, (uint64_t)1);
+	exit_thread.clear();
+	thread.start(_thread_func, this);
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!thread.is_started()) {
+		return;
+	}
+	exit_thread.set();
+	thread.wait_to_finish();
+	flush();
+}
+
+void GDScriptSamplingProfiler::flush() {
+	MutexLock lock(pending_mutex);
+
+	for (const Sample &sample : pending_samples) {
+		String stack = sample.scope == SCOPE_PHYSICS ? "physics" : "process";
+		if (sample.frame_count == 0) {
+			stack += ";[engine]";
+		}
+		for (uint32_t i = 0; i < sample.frame_count; i++) {
+			const GDScriptFunction *function = pending_functions[sample.frame_offset + i];
+			String source = function->get_script() ? function->get_script()->get_script_path() : String("built-in");
+			stack += vformat(";%s (%s:%d)", function->get_name(), source, pending_lines[sample.frame_offset + i]);
+		}
+		if (folded_stacks.has(stack)) {
+			folded_stacks[stack]++;
+		} else {
+			folded_stacks[stack] = 1;
+		}
+	}
+	total_samples += pending_samples.size();
+
+	pending_samples.clear();
+	pending_functions.clear();
+	pending_lines.clear();
+}
+
+void GDScriptSamplingProfiler::clear() {
+	flush();
+	folded_stacks.clear();
+	total_samples = 0;
+}
+
+String GDScriptSamplingProfiler::get_folded_stacks() {
+	flush();
+
+	StringBuilder sb;
+	for (const KeyValue<String, uint64_t> &E : folded_stacks) {
+		sb.append(E.key);
+		sb.append(" ");
+		sb.append(itos(E.value));
+		sb.append("\n");
+	}
+	return sb.as_string();
+}
+
+Error GDScriptSamplingProfiler::save(const String &p_path) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot save GDScript sampling profile to file '" + p_path + "'.");
+	f->store_string(get_folded_stacks());
+	return OK;
+}
+
+GDScriptSamplingProfiler::~GDScriptSamplingProfiler() {
+	stop();
+}
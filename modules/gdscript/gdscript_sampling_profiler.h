@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+class GDScriptFunction;
+
+// Periodically snapshots the GDScript call stack of the main thread from a
+// separate thread and aggregates the samples as folded stacks, the text
+// format consumed by flame graph tools ("frame;frame;frame count").
+//
+// Unlike the instrumenting profiler (GDScriptFunction::Profile), the cost
+// per call is a couple of stores, so short functions are not distorted.
+class GDScriptSamplingProfiler {
+public:
+	enum {
+		MAX_DEPTH = 256, // Deeper frames are not recorded.
+	};
+
+	enum Scope : uint8_t {
+		SCOPE_PROCESS,
+		SCOPE_PHYSICS,
+	};
+
+private:
+	struct Frame {
+		GDScriptFunction *function = nullptr;
+		// Updated on every line without bumping `sequence`, so it's atomic.
+		std::atomic<int> line = { 0 };
+	};
+
+	// Main thread call stack. Only the main thread writes it; the sampler
+	// thread copies it and retries when `sequence` changed during the copy.
+	Frame frames[MAX_DEPTH];
+	uint32_t depth = 0;
+	SafeNumeric<uint32_t> sequence;
+
+	struct Sample {
+		uint32_t frame_offset = 0;
+		uint32_t frame_count = 0;
+		Scope scope = SCOPE_PROCESS;
+	};
+
+	// Samples not symbolized yet, filled by the sampler thread. The sampler
+	// holds the mutex from the stack copy until the sample is queued, and
+	// functions flush before being freed, so queued functions are alive.
+	Mutex pending_mutex;
+	LocalVector<Sample> pending_samples;
+	LocalVector<GDScriptFunction *> pending_functions;
+	LocalVector<int> pending_lines;
+
+	HashMap<String, uint64_t> folded_stacks;
+	uint64_t total_samples = 0;
+
+	Thread thread;
+	SafeFlag exit_thread;
+	uint64_t interval_usec = 1000;
+
+	static void _thread_func(void *p_user);
+	void _take_sample();
+
+public:
+	_FORCE_INLINE_ bool enter_function(GDScriptFunction *p_function, int p_line) {
+		if (Thread::get_caller_id() != Thread::get_main_id()) {
+			return false;
+		}
+		sequence.set(sequence.get() + 1);
+		std::atomic_thread_fence(std::memory_order_release);
+		if (depth < MAX_DEPTH) {
+			frames[depth].function = p_function;
+			frames[depth].line.store(p_line, std::memory_order_relaxed);
+		}
+		depth++;
+		sequence.set(sequence.get() + 1);
+		return true;
+	}
+
+	// Only valid between enter_function() and exit_function() of the current function.
+	_FORCE_INLINE_ void set_line(int p_line) {
+		if (depth <= MAX_DEPTH) {
+			frames[depth - 1].line.store(p_line, std::memory_order_relaxed);
+		}
+	}
+
+	_FORCE_INLINE_ void exit_function() {
+		sequence.set(sequence.get() + 1);
+		std::atomic_thread_fence(std::memory_order_release);
+		depth--;
+		sequence.set(sequence.get() + 1);
+	}
+
+	void start(uint64_t p_interval_usec);
+	void stop();
+	bool is_running() const { return thread.is_started(); }
+
+	// Resolves pending samples to function names. Must be called before any
+	// function they reference is freed.
+	void flush();
+	void clear();
+
+	uint64_t get_total_samples() const { return total_samples; }
+	String get_folded_stacks();
+	Error save(const String &p_path);
+
+	~GDScriptSamplingProfiler();
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -201,6 +201,21 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {        \
 		&&OPCODE_OPERATOR,                           \
 		&&OPCODE_OPERATOR_VALIDATED,                 \
+		&&OPCODE_OPERATOR_ADD_INT,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,              \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,              \
+		&&OPCODE_OPERATOR_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_LESS_INT,                  \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,            \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                 \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,            \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,            \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,              \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT,               \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT,           \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,          \
 		&&OPCODE_EXTENDS_TEST,                       \
 		&&OPCODE_IS_BUILTIN,                         \
 		&&OPCODE_SET_KEYED,                          \
@@ -213,6 +228,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_SET_NAMED_VALIDATED,                \
 		&&OPCODE_GET_NAMED,                          \
 		&&OPCODE_GET_NAMED_VALIDATED,                \
+		&&OPCODE_GET_VECTOR2_COMPONENT,              \
+		&&OPCODE_GET_VECTOR3_COMPONENT,              \
 		&&OPCODE_SET_MEMBER,                         \
 		&&OPCODE_GET_MEMBER,                         \
 		&&OPCODE_ASSIGN,                             \
@@ -566,6 +583,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	memnew_placement(&stack[ADDR_STACK_NIL], Variant);
 
 	String err_text;
+	bool stack_handed_over = false;
 
 #ifdef DEBUG_ENABLED
 
@@ -644,6 +662,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		profile.call_count++;
 		profile.frame_call_count++;
 	}
+	GDScriptSamplingProfiler *sampling_profiler = GDScriptLanguage::get_singleton()->sampling_profiler;
+	bool sampled = sampling_profiler && sampling_profiler->enter_function(this, line);
 	bool exit_ok = false;
 	bool awaited = false;
 #endif
@@ -713,6 +733,35 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			// The compiler only emits these when both operands are typed, and the
+			// destination already holds the result type, as for validated operators.
+#define OPCODE_OPERATOR_TYPED(m_op, m_type, m_operand, m_result, m_symbol)                                                          \
+	OPCODE(OPCODE_OPERATOR_##m_op##_##m_type) {                                                                                     \
+		CHECK_SPACE(4);                                                                                                             \
+		GET_VARIANT_PTR(a, 0);                                                                                                      \
+		GET_VARIANT_PTR(b, 1);                                                                                                      \
+		GET_VARIANT_PTR(dst, 2);                                                                                                    \
+		*VariantInternal::get_##m_result(dst) = *VariantInternal::get_##m_operand(a) m_symbol *VariantInternal::get_##m_operand(b); \
+		ip += 4;                                                                                                                    \
+	}                                                                                                                               \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_TYPED(ADD, INT, int, int, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT, INT, int, int, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY, INT, int, int, *);
+			OPCODE_OPERATOR_TYPED(EQUAL, INT, int, bool, ==);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL, INT, int, bool, !=);
+			OPCODE_OPERATOR_TYPED(LESS, INT, int, bool, <);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL, INT, int, bool, <=);
+			OPCODE_OPERATOR_TYPED(ADD, FLOAT, float, float, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT, FLOAT, float, float, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY, FLOAT, float, float, *);
+			OPCODE_OPERATOR_TYPED(DIVIDE, FLOAT, float, float, /);
+			OPCODE_OPERATOR_TYPED(EQUAL, FLOAT, float, bool, ==);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL, FLOAT, float, bool, !=);
+			OPCODE_OPERATOR_TYPED(LESS, FLOAT, float, bool, <);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL, FLOAT, float, bool, <=);
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -1092,6 +1141,32 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_GET_VECTOR2_COMPONENT) {
+				CHECK_SPACE(3);
+
+				GET_VARIANT_PTR(src, 0);
+				GET_VARIANT_PTR(dst, 1);
+
+				int axis = _code_ptr[ip + 3];
+				GD_ERR_BREAK(axis < 0 || axis >= 2);
+				*VariantInternal::get_float(dst) = VariantInternal::get_vector2(src)->coord[axis];
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_VECTOR3_COMPONENT) {
+				CHECK_SPACE(3);
+
+				GET_VARIANT_PTR(src, 0);
+				GET_VARIANT_PTR(dst, 1);
+
+				int axis = _code_ptr[ip + 3];
+				GD_ERR_BREAK(axis < 0 || axis >= 3);
+				*VariantInternal::get_float(dst) = VariantInternal::get_vector3(src)->coord[axis];
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_SET_MEMBER) {
 				CHECK_SPACE(3);
 				GET_VARIANT_PTR(src, 0);
@@ -2281,19 +2356,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 					gdfs->function = this;
 
-					gdfs->state.stack.resize(alloca_size);
-
-					// First 3 stack addresses are special, so we just skip them here.
-					for (int i = 3; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
-					}
-					gdfs->state.stack_size = _stack_size;
-					gdfs->state.alloca_size = alloca_size;
-					gdfs->state.ip = ip + 2;
-					gdfs->state.line = line;
-					gdfs->state.script = _script;
 					{
 						MutexLock lock(GDScriptLanguage::get_singleton()->mutex);
+						if (p_state) {
+							// Resumed from a previous await, so the stack already lives in
+							// that state's buffer. Hand it over instead of copying it.
+							gdfs->state.stack = p_state->stack;
+							p_state->stack = Vector<uint8_t>();
+							p_state->stack_size = 0;
+							stack_handed_over = true;
+						} else {
+							gdfs->state.stack = GDScriptLanguage::get_singleton()->_take_state_stack(alloca_size);
+						}
 						_script->pending_func_states.add(&gdfs->scripts_list);
 						if (p_instance) {
 							gdfs->state.instance = p_instance;
@@ -2302,6 +2376,19 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 							gdfs->state.instance = nullptr;
 						}
 					}
+
+					if (!stack_handed_over) {
+						// First 3 stack addresses are special, so we just skip them here.
+						uint8_t *state_stack = gdfs->state.stack.ptrw();
+						for (int i = 3; i < _stack_size; i++) {
+							memnew_placement(&state_stack[sizeof(Variant) * i], Variant(stack[i]));
+						}
+					}
+					gdfs->state.stack_size = _stack_size;
+					gdfs->state.alloca_size = alloca_size;
+					gdfs->state.ip = ip + 2;
+					gdfs->state.line = line;
+					gdfs->state.script = _script;
 #ifdef DEBUG_ENABLED
 					gdfs->state.function_name = name;
 					gdfs->state.script_path = _script->get_script_path();
@@ -2311,7 +2398,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 					retvalue = gdfs;
 
-					Error err = sig.connect(Callable(gdfs.ptr(), "_signal_callback").bind(retvalue), Object::CONNECT_ONE_SHOT);
+					Error err = sig.connect(gdfs->_get_resume_callable(), Object::CONNECT_ONE_SHOT);
 					if (err != OK) {
 						err_text = "Error connecting to signal: " + sig.get_name() + " during await.";
 						OPCODE_BREAK;
@@ -3470,6 +3557,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
+#ifdef DEBUG_ENABLED
+				if (sampled) {
+					sampling_profiler->set_line(line);
+				}
+#endif
+
 				if (EngineDebugger::is_active()) {
 					// line
 					bool do_break = false;
@@ -3560,6 +3653,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		GDScriptLanguage::get_singleton()->script_frame_time += time_taken - function_call_time;
 	}
 
+	if (sampled) {
+		sampling_profiler->exit_function();
+	}
+
 	// Check if this is not the last time it was interrupted by `await` or if it's the first time executing.
 	// If that is the case then we exit the function as normal. Otherwise we postpone it until the last `await` is completed.
 	// This ensures the call stack can be properly shown when using `await`, showing what resumed the function.
@@ -3570,8 +3667,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 		// Free stack, except reserved addresses.
-		for (int i = 3; i < _stack_size; i++) {
-			stack[i].~Variant();
+		// A stack handed over to a new function state is now owned by it.
+		if (!stack_handed_over) {
+			for (int i = 3; i < _stack_size; i++) {
+				stack[i].~Variant();
+			}
 		}
 #ifdef DEBUG_ENABLED
 	}
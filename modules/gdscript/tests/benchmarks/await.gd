@@ -0,0 +1,18 @@
+# Suspending functions on a signal and resuming them.
+
+signal tick
+
+var resumed := 0
+
+func worker() -> void:
+	await tick
+	resumed += 1
+	await tick
+	resumed += 1
+
+func benchmark() -> void:
+	resumed = 0
+	for i in 2000:
+		worker()
+	tick.emit()
+	tick.emit()
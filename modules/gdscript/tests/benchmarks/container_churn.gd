@@ -0,0 +1,20 @@
+# Creating, filling, reading and erasing arrays and dictionaries.
+
+var result: int
+
+func benchmark() -> void:
+	var array := []
+	var dictionary := {}
+	for i in 10000:
+		array.push_back(i)
+		dictionary[i] = str(i)
+	var sum := 0
+	for value in array:
+		sum += value
+	for key in dictionary:
+		sum += dictionary[key].length()
+	for i in 10000:
+		dictionary.erase(i)
+	while not array.is_empty():
+		array.pop_back()
+	result = sum
@@ -0,0 +1,12 @@
+# Untyped loops and arithmetic, the dynamic dispatch path of the VM.
+
+var result
+
+func benchmark():
+	var sum = 0
+	for i in 100000:
+		sum += i % 7
+	var j = 0
+	while j < 100000:
+		j += 1
+	result = sum + j
@@ -0,0 +1,19 @@
+# Calls to script methods, native methods and utility functions.
+
+var result: int
+
+func add(a: int, b: int) -> int:
+	return a + b
+
+func identity(value):
+	return value
+
+func benchmark() -> void:
+	var sum := 0
+	var node := RefCounted.new()
+	for i in 20000:
+		sum = add(sum, i)
+		sum = identity(sum)
+		sum += node.get_reference_count()
+		sum += absi(-i)
+	result = sum
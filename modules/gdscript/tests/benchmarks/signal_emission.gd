@@ -0,0 +1,20 @@
+# Emitting signals connected to script methods.
+
+signal value_changed(value: int)
+
+var received := 0
+
+func _init() -> void:
+	value_changed.connect(_on_value_changed)
+	value_changed.connect(_on_value_changed_again)
+
+func _on_value_changed(value: int) -> void:
+	received += value
+
+func _on_value_changed_again(_value: int) -> void:
+	received -= 1
+
+func benchmark() -> void:
+	received = 0
+	for i in 10000:
+		value_changed.emit(1)
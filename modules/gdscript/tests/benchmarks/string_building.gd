@@ -0,0 +1,12 @@
+# Building strings by concatenation, formatting and joining.
+
+var result: String
+
+func benchmark() -> void:
+	var text := ""
+	for i in 5000:
+		text += str(i)
+	var parts := PackedStringArray()
+	for i in 5000:
+		parts.push_back("%d:%s" % [i, "value"])
+	result = text + ",".join(parts)
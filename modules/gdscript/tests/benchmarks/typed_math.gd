@@ -0,0 +1,13 @@
+# Typed arithmetic on scalars and vectors, the validated operator path of the VM.
+
+var result: float
+
+func benchmark() -> void:
+	var sum := 0.0
+	var position := Vector2()
+	var velocity := Vector2(1.5, -0.5)
+	for i in 100000:
+		var f := float(i)
+		sum += f * 0.5 - f / 3.0
+		position += velocity * 0.016
+	result = sum + position.length()
@@ -0,0 +1,16 @@
+# Typed int and float operators and vector components, the dedicated scalar opcodes of the VM.
+
+var result: float
+
+func benchmark() -> void:
+	var hits: int = 0
+	var energy: float = 0.0
+	var point := Vector3(0.25, 0.5, 0.75)
+	var i: int = 0
+	while i < 100000:
+		var t: float = float(i) * 0.001
+		if t * t < 50.0 and i - hits * 2 >= 0:
+			hits += 1
+		energy = energy + point.x * t - point.y / (t + 1.0) + point.z
+		i += 1
+	result = energy + hits
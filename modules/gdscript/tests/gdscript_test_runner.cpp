@@ -40,8 +40,10 @@
 #include "core/core_string_names.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access_pack.h"
+#include "core/io/json.h"
 #include "core/os/os.h"
 #include "core/string/string_builder.h"
+#include "core/version.h"
 #include "scene/resources/packed_scene.h"
 
 #include "tests/test_macros.h"
@@ -131,9 +133,11 @@ void finish_language() {
 }
 
 StringName GDScriptTestRunner::test_function_name;
+StringName GDScriptTestRunner::benchmark_function_name;
 
 GDScriptTestRunner::GDScriptTestRunner(const String &p_source_dir, bool p_init_language, bool p_print_filenames) {
 	test_function_name = StaticCString::create("test");
+	benchmark_function_name = StaticCString::create("benchmark");
 	do_init_languages = p_init_language;
 	print_filenames = p_print_filenames;
 
@@ -161,6 +165,7 @@ GDScriptTestRunner::GDScriptTestRunner(const String &p_source_dir, bool p_init_l
 
 GDScriptTestRunner::~GDScriptTestRunner() {
 	test_function_name = StringName();
+	benchmark_function_name = StringName();
 	if (do_init_languages) {
 		finish_language();
 	}
@@ -248,6 +253,49 @@ bool GDScriptTestRunner::generate_outputs() {
 	return true;
 }
 
+int GDScriptTestRunner::run_benchmarks(int p_iterations, Dictionary &r_report) {
+	is_benchmarking = true;
+
+	if (!make_tests()) {
+		ERR_PRINT("An error occurred while making the benchmarks.");
+		return -1;
+	}
+
+	int failed = 0;
+	Array benchmarks;
+	for (int i = 0; i < tests.size(); i++) {
+		GDScriptTest test = tests[i];
+		if (print_filenames) {
+			print_line(test.get_source_relative_filepath());
+		}
+		GDScriptTest::BenchmarkResult result = test.run_benchmark(p_iterations);
+		if (!result.ok) {
+			failed++;
+		}
+
+		Dictionary benchmark;
+		benchmark["name"] = test.get_source_relative_filepath();
+		benchmark["ok"] = result.ok;
+		benchmark["iterations"] = result.iterations;
+		benchmark["min_usec"] = result.min_usec;
+		benchmark["median_usec"] = result.median_usec;
+		benchmark["mean_usec"] = result.mean_usec;
+		benchmark["max_usec"] = result.max_usec;
+		benchmarks.push_back(benchmark);
+	}
+
+	r_report["version"] = VERSION_FULL_BUILD;
+#ifdef DEBUG_ENABLED
+	r_report["debug"] = true;
+#else
+	r_report["debug"] = false;
+#endif
+	r_report["iterations"] = p_iterations;
+	r_report["benchmarks"] = benchmarks;
+
+	return failed;
+}
+
 bool GDScriptTestRunner::make_tests_for_dir(const String &p_dir) {
 	Error err = OK;
 	Ref<DirAccess> dir(DirAccess::open(p_dir, &err));
@@ -292,7 +340,7 @@ bool GDScriptTestRunner::make_tests_for_dir(const String &p_dir) {
 #endif
 
 				String out_file = next.get_basename() + ".out";
-				if (!is_generating && !dir->file_exists(out_file)) {
+				if (!is_generating && !is_benchmarking && !dir->file_exists(out_file)) {
 					ERR_FAIL_V_MSG(false, "Could not find output file for " + next);
 				}
 				GDScriptTest test(current_dir.path_join(next), current_dir.path_join(out_file), source_dir);
@@ -362,6 +410,44 @@ void GDScriptTestRunner::handle_cmdline() {
 			bool completed = runner.generate_outputs();
 			int failed = completed ? 0 : -1;
 			exit(failed);
+		} else if (cmd == "--gdscript-benchmark") {
+			if (E->next() == nullptr) {
+				ERR_PRINT("Needed a path for the benchmark files.");
+				exit(-1);
+			}
+
+			const String &path = E->next()->get();
+
+			int iterations = DEFAULT_BENCHMARK_ITERATIONS;
+			List<String>::Element *iterations_arg = cmdline_args.find("--benchmark-iterations");
+			if (iterations_arg && iterations_arg->next()) {
+				iterations = MAX(iterations_arg->next()->get().to_int(), 1);
+			}
+
+			String output_path;
+			List<String>::Element *output_arg = cmdline_args.find("--benchmark-output");
+			if (output_arg && output_arg->next()) {
+				output_path = output_arg->next()->get();
+			}
+
+			GDScriptTestRunner runner(path, false, cmdline_args.find("--print-filenames") != nullptr);
+
+			Dictionary report;
+			int failed = runner.run_benchmarks(iterations, report);
+
+			String json = JSON::stringify(report, "\t");
+			if (output_path.is_empty()) {
+				print_line(json);
+			} else {
+				Error err = OK;
+				Ref<FileAccess> out_file = FileAccess::open(output_path, FileAccess::WRITE, &err);
+				if (err != OK) {
+					ERR_PRINT("Could not open the benchmark output file: " + output_path);
+					exit(-1);
+				}
+				out_file->store_string(json + "\n");
+			}
+			exit(failed == 0 ? 0 : -1);
 		}
 	}
 }
@@ -641,4 +727,64 @@ bool GDScriptTest::generate_output() {
 	return true;
 }
 
+GDScriptTest::BenchmarkResult GDScriptTest::run_benchmark(int p_iterations) {
+	BenchmarkResult result;
+
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_path(source_file);
+	Error err = script->load_source_code(source_file);
+	ERR_FAIL_COND_V_MSG(err != OK, result, "Could not load source code for: '" + source_file + "'.");
+
+	err = script->reload();
+	if (err != OK || !script->get_member_functions().has(GDScriptTestRunner::benchmark_function_name)) {
+		GDScriptCache::remove_script(script->get_path());
+		ERR_FAIL_V_MSG(result, "Could not find benchmark function on: '" + source_file + "'.");
+	}
+
+	Object *obj = ClassDB::instantiate(script->get_native()->get_name());
+	Ref<RefCounted> obj_ref;
+	if (obj->is_ref_counted()) {
+		obj_ref = Ref<RefCounted>(Object::cast_to<RefCounted>(obj));
+	}
+	obj->set_script(script);
+	ScriptInstance *instance = obj->get_script_instance();
+
+	// The first call is not timed, it pays for the lazy initialization that later calls don't.
+	LocalVector<uint64_t> timings;
+	Callable::CallError call_err;
+	for (int i = -1; i < p_iterations && call_err.error == Callable::CallError::CALL_OK; i++) {
+		uint64_t elapsed = benchmark_usec([&]() {
+			instance->callp(GDScriptTestRunner::benchmark_function_name, nullptr, 0, call_err);
+		});
+		if (i >= 0) {
+			timings.push_back(elapsed);
+		}
+	}
+
+	if (obj_ref.is_null()) {
+		memdelete(obj);
+	}
+	obj_ref.unref();
+
+	GDScriptCache::remove_script(script->get_path());
+
+	ERR_FAIL_COND_V_MSG(call_err.error != Callable::CallError::CALL_OK, result, "Could not call benchmark function on: '" + source_file + "'.");
+	ERR_FAIL_COND_V(timings.is_empty(), result);
+
+	timings.sort();
+	uint64_t total = 0;
+	for (uint64_t timing : timings) {
+		total += timing;
+	}
+
+	result.ok = true;
+	result.iterations = timings.size();
+	result.min_usec = timings[0];
+	result.median_usec = timings[timings.size() / 2];
+	result.mean_usec = total / timings.size();
+	result.max_usec = timings[timings.size() - 1];
+	return result;
+}
+
 } // namespace GDScriptTests
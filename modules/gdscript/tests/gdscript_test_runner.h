@@ -61,6 +61,15 @@ public:
 		bool passed;
 	};
 
+	struct BenchmarkResult {
+		bool ok = false;
+		int iterations = 0;
+		uint64_t min_usec = 0;
+		uint64_t median_usec = 0;
+		uint64_t mean_usec = 0;
+		uint64_t max_usec = 0;
+	};
+
 private:
 	struct ErrorHandlerData {
 		TestResult *result = nullptr;
@@ -90,6 +99,7 @@ public:
 	static void error_handler(void *p_this, const char *p_function, const char *p_file, int p_line, const char *p_error, const char *p_explanation, bool p_editor_notify, ErrorHandlerType p_type);
 	TestResult run_test();
 	bool generate_output();
+	BenchmarkResult run_benchmark(int p_iterations);
 
 	const String &get_source_file() const { return source_file; }
 	const String get_source_relative_filepath() const { return source_file.trim_prefix(base_dir); }
@@ -105,6 +115,7 @@ class GDScriptTestRunner {
 	Vector<GDScriptTest> tests;
 
 	bool is_generating = false;
+	bool is_benchmarking = false;
 	bool do_init_languages = false;
 	bool print_filenames; // Whether filenames should be printed when generated/running tests
 
@@ -113,11 +124,19 @@ class GDScriptTestRunner {
 	bool generate_class_index();
 
 public:
+	enum {
+		DEFAULT_BENCHMARK_ITERATIONS = 10,
+	};
+
 	static StringName test_function_name;
+	static StringName benchmark_function_name;
 
 	static void handle_cmdline();
 	int run_tests();
 	bool generate_outputs();
+	// Calls `benchmark()` in every script of the source directory, once to warm up and then
+	// `p_iterations` times, and fills `r_report` with the timings. Returns the number of failures.
+	int run_benchmarks(int p_iterations, Dictionary &r_report);
 
 	GDScriptTestRunner(const String &p_source_dir, bool p_init_language, bool p_print_filenames = false);
 	~GDScriptTestRunner();
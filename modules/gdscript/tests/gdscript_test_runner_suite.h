@@ -32,6 +32,16 @@
 #define GDSCRIPT_TEST_RUNNER_SUITE_H
 
 #include "gdscript_test_runner.h"
+
+#include "../gdscript_cache.h"
+#include "../gdscript_parser.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/object/worker_thread_pool.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/resources/packed_scene.h"
 #include "tests/test_macros.h"
 
 namespace GDScriptTests {
@@ -70,6 +80,221 @@ func _init():
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
 
+TEST_CASE("[Modules][GDScript] Parse script dependencies in parallel") {
+	const String dir = OS::get_singleton()->get_cache_path().path_join("gdscript_parse_dependencies");
+	DirAccess::make_dir_recursive_absolute(dir);
+	const char *files[][2] = {
+		{ "base.gd", "extends RefCounted\n\nfunc get_base() -> int:\n\treturn 1\n" },
+		{ "helper.gd", "extends RefCounted\n\nstatic func get_helper() -> int:\n\treturn 2\n" },
+		{ "util.gd", "extends RefCounted\n\nstatic func get_util() -> int:\n\treturn 4\n" },
+		{ "main.gd", "extends \"base.gd\"\n\nconst Helper = preload(\"helper.gd\")\n\nfunc run() -> int:\n\treturn get_base() + Helper.get_helper() + ParseDependenciesUtil.get_util()\n" },
+	};
+	for (const auto &file : files) {
+		Ref<FileAccess> f = FileAccess::open(dir.path_join(file[0]), FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string(file[1]);
+	}
+	ScriptServer::add_global_class("ParseDependenciesUtil", "RefCounted", GDScriptLanguage::get_singleton()->get_name(), dir.path_join("util.gd"));
+
+	const String main_path = dir.path_join("main.gd");
+	{
+		// The base script, the preloaded script and the global class make up the second level.
+		Vector<Ref<GDScriptParserRef>> parsers;
+		const int parsed_on_pool = GDScriptCache::parse_dependencies(main_path, parsers);
+		REQUIRE(parsers.size() == 4);
+		for (const Ref<GDScriptParserRef> &parser : parsers) {
+			CHECK(parser->get_status() >= GDScriptParserRef::PARSED);
+			CHECK(parser->get_parser()->get_tree() != nullptr);
+		}
+		if (WorkerThreadPool::get_singleton()->get_thread_count() > 1) {
+			CHECK_MESSAGE(parsed_on_pool == 3, "Independent dependencies should be parsed as a group task.");
+		}
+	}
+
+	Error err = OK;
+	Ref<GDScript> script = GDScriptCache::get_full_script(main_path, err);
+	REQUIRE(err == OK);
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(script);
+	CHECK(int(instance->call("run")) == 7);
+
+	instance.unref();
+	ScriptServer::remove_global_class("ParseDependenciesUtil");
+}
+
+TEST_CASE("[Modules][GDScript] Sampling profiler") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+func spin() -> int:
+	var count := 0
+	for i in 100000:
+		count += i
+	return count
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	GDScriptSamplingProfiler *profiler = memnew(GDScriptSamplingProfiler);
+	GDScriptLanguage::get_singleton()->set_sampling_profiler(profiler);
+	profiler->start(100);
+
+	const uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+	while (profiler->get_total_samples() < 20 && OS::get_singleton()->get_ticks_msec() < timeout) {
+		ref_counted->call("spin");
+		profiler->flush();
+	}
+	CHECK(profiler->get_total_samples() >= 20);
+
+	// Samples still pending are resolved before the functions they point to are freed.
+	for (int i = 0; i < 10; i++) {
+		ref_counted->call("spin");
+	}
+	ref_counted.unref();
+	gdscript.unref();
+	profiler->stop();
+
+	const String stacks = profiler->get_folded_stacks();
+	CHECK_MESSAGE(stacks.contains("process;spin ("), "Samples should be rooted at the engine phase.");
+	CHECK_MESSAGE((stacks.contains(":6) ") || stacks.contains(":7) ")), "Samples should record the line being run.");
+
+	profiler->clear();
+	CHECK(profiler->get_total_samples() == 0);
+	CHECK(profiler->get_folded_stacks().is_empty());
+
+	GDScriptLanguage::get_singleton()->set_sampling_profiler(nullptr);
+}
+
+struct SamplingProfilerThreadData {
+	GDScriptSamplingProfiler *profiler = nullptr;
+	bool entered = true;
+};
+
+static void _sampling_profiler_enter_function(void *p_userdata) {
+	SamplingProfilerThreadData *data = (SamplingProfilerThreadData *)p_userdata;
+	data->entered = data->profiler->enter_function(nullptr, 0);
+}
+
+TEST_CASE("[Modules][GDScript] Sampling profiler only samples the main thread") {
+	GDScriptSamplingProfiler profiler;
+	SamplingProfilerThreadData data;
+	data.profiler = &profiler;
+
+	Thread thread;
+	thread.start(_sampling_profiler_enter_function, &data);
+	thread.wait_to_finish();
+	CHECK_FALSE(data.entered);
+
+	CHECK(profiler.enter_function(nullptr, 0));
+	profiler.exit_function();
+}
+
+TEST_CASE_BENCHMARK("[Modules][GDScript][Benchmark] Await throughput") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+signal tick
+
+var resumed := 0
+
+func worker(iterations: int) -> void:
+	for i in iterations:
+		await tick
+		resumed += 1
+
+func start(coroutines: int, iterations: int) -> void:
+	for i in coroutines:
+		worker(iterations)
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	const int coroutines = 1000;
+	const int iterations = 100;
+
+	// Every coroutine awaits for the first time, from a fresh call.
+	uint64_t start_usec = benchmark_usec([&]() {
+		ref_counted->call("start", coroutines, iterations);
+	});
+	start_usec = MAX(start_usec, (uint64_t)1);
+
+	// Every coroutine is resumed and awaits again, once per emission.
+	uint64_t resume_usec = benchmark_usec([&]() {
+		for (int i = 0; i < iterations; i++) {
+			ref_counted->emit_signal("tick");
+		}
+	});
+	resume_usec = MAX(resume_usec, (uint64_t)1);
+
+	CHECK(int(ref_counted->get("resumed")) == coroutines * iterations);
+	MESSAGE(vformat("First await: %d awaits in %d usec (%d awaits/s).", coroutines, start_usec, coroutines * 1000000 / start_usec));
+	MESSAGE(vformat("Resume and await: %d awaits in %d usec (%d awaits/s).", coroutines * iterations, resume_usec, uint64_t(coroutines) * iterations * 1000000 / resume_usec));
+}
+
+TEST_CASE_BENCHMARK("[Modules][GDScript][Benchmark] Script corpus") {
+	bool print_filenames = OS::get_singleton()->get_cmdline_args().find("--print-filenames") != nullptr;
+	GDScriptTestRunner runner("modules/gdscript/tests/benchmarks", true, print_filenames);
+	Dictionary report;
+	int fail_count = runner.run_benchmarks(GDScriptTestRunner::DEFAULT_BENCHMARK_ITERATIONS, report);
+	MESSAGE(JSON::stringify(report, "\t"));
+	REQUIRE_MESSAGE(fail_count == 0, "All GDScript benchmarks should run.");
+}
+
+TEST_CASE("[Modules][GDScript][SceneTree] Pooled instances reset script variables") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends Node2D
+
+@export var speed := 2.0
+var hits := 0
+var targets := []
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Node2D *root = memnew(Node2D);
+	root->set_name("Bullet");
+	root->set_script(gdscript);
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	REQUIRE(packed_scene->pack(root) == OK);
+	memdelete(root);
+	packed_scene->set_path("res://test_pooled_scripted_scene.tscn");
+
+	SceneTree *tree = SceneTree::get_singleton();
+	Node *instance = tree->pool_instantiate(packed_scene);
+	REQUIRE(instance->get_script_instance() != nullptr);
+	instance->set("speed", 8.0);
+	instance->set("hits", 3);
+	Array targets = instance->get("targets");
+	targets.push_back(1);
+
+	tree->pool_release(instance);
+	tree->process(0.0);
+	Node *reused = tree->pool_instantiate(packed_scene);
+	CHECK(reused == instance);
+	CHECK(double(reused->get("speed")) == 2.0);
+	CHECK_MESSAGE(int(reused->get("hits")) == 0, "Script variables which aren't exported should be reset too.");
+	CHECK(Array(reused->get("targets")).is_empty());
+
+	memdelete(reused);
+	tree->pool_clear();
+}
+
 TEST_CASE("[Modules][GDScript] Validate built-in API") {
 	GDScriptLanguage *lang = GDScriptLanguage::get_singleton();
 
@@ -0,0 +1,20 @@
+# Coroutines resumed by a signal and awaiting again keep their local state.
+
+signal step(value)
+
+var results := []
+
+func accumulate(label: String) -> void:
+	var sum := 0
+	for i in 3:
+		sum += await step
+	results.append("%s: %d" % [label, sum])
+
+func test():
+	accumulate("first")
+	accumulate("second")
+	for value in [1, 10, 100]:
+		step.emit(value)
+	results.sort()
+	for result in results:
+		print(result)
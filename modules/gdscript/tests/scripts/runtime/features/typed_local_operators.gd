@@ -0,0 +1,31 @@
+# Operators assigned to typed locals are evaluated in place.
+
+func test():
+	var i: int = 3
+	i += 4
+	i = i * i - 1
+	print(i)
+
+	var f: float = 1.5
+	f *= 2.0
+	f = f + f / 2.0
+	print(f)
+
+	var v := Vector3(1, 2, 3)
+	v += Vector3.ONE
+	v = v * 2.0
+	v = Vector3(v.z, v.y, v.x) - v
+	print(v)
+
+	var b: bool = i > 10
+	b = b and f < 1.0
+	print(b)
+
+	var sum: int = 0
+	for k in 5:
+		sum += k
+	print(sum)
+
+	var c := Color(0.5, 0.5, 0.5)
+	c = c + c
+	print(c)
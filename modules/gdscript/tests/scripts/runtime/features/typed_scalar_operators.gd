@@ -0,0 +1,30 @@
+# Operators on typed ints and floats, and typed vector components, use dedicated opcodes.
+
+func test():
+	var a: int = 7
+	var b: int = -3
+	print(a + b, " ", a - b, " ", a * b)
+	print(a == b, " ", a != b, " ", a < b, " ", a <= b, " ", a > b, " ", a >= b)
+	print(a >= 7, " ", a <= 7, " ", a > 7)
+
+	var x: float = 2.5
+	var y: float = 0.5
+	print(x + y, " ", x - y, " ", x * y, " ", x / y)
+	print(x == y, " ", x != y, " ", x < y, " ", x <= y, " ", x > y, " ", x >= y)
+
+	var nan_value: float = NAN
+	print(nan_value < x, " ", nan_value > x, " ", nan_value == nan_value, " ", nan_value != nan_value)
+
+	var v2 := Vector2(1.5, -2.0)
+	var v3 := Vector3(4.0, 5.0, 6.0)
+	print(v2.x, " ", v2.y, " ", v3.x, " ", v3.y, " ", v3.z)
+	var length_squared: float = v3.x * v3.x + v3.y * v3.y + v3.z * v3.z
+	print(length_squared)
+
+	var count: int = 0
+	var i: int = 0
+	while i < 10:
+		if i >= 5:
+			count += i
+		i += 1
+	print(count)
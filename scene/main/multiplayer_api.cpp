@@ -62,6 +62,9 @@ Ref<MultiplayerAPI> MultiplayerAPI::create_default_interface() {
 // - The first LSB 6 bits are used for the variant type.
 // - The next two bits are used to store the encoding mode.
 // - Boolean values uses the encoding mode to store the value.
+// - When compact encoding is enabled, containers, strings and packed arrays
+//   use ENCODE_COMPACT, and are followed by the compact encoding without its
+//   header (see encode_variant_compact_body()).
 #define VARIANT_META_TYPE_MASK 0x3F
 #define VARIANT_META_EMODE_MASK 0xC0
 #define VARIANT_META_BOOL_MASK 0x80
@@ -69,7 +72,8 @@ Ref<MultiplayerAPI> MultiplayerAPI::create_default_interface() {
 #define ENCODE_16 1 << 6
 #define ENCODE_32 2 << 6
 #define ENCODE_64 3 << 6
-Error MultiplayerAPI::encode_and_compress_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_allow_object_decoding) {
+#define ENCODE_COMPACT 1 << 6
+Error MultiplayerAPI::encode_and_compress_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_allow_object_decoding, bool p_compact) {
 	// Unreachable because `VARIANT_MAX` == 38 and `ENCODE_VARIANT_MASK` == 77
 	CRASH_COND(p_variant.get_type() > VARIANT_META_TYPE_MASK);
 
@@ -128,6 +132,32 @@ Error MultiplayerAPI::encode_and_compress_variant(const Variant &p_variant, uint
 				buf[0] = encode_mode | p_variant.get_type();
 			}
 		} break;
+		case Variant::STRING:
+		case Variant::STRING_NAME:
+		case Variant::DICTIONARY:
+		case Variant::ARRAY:
+		case Variant::PACKED_BYTE_ARRAY:
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY:
+		case Variant::PACKED_STRING_ARRAY:
+		case Variant::PACKED_VECTOR2_ARRAY:
+		case Variant::PACKED_VECTOR3_ARRAY:
+		case Variant::PACKED_COLOR_ARRAY: {
+			if (p_compact) {
+				Error err = encode_variant_compact_body(p_variant, buf ? buf + 1 : nullptr, r_len, p_allow_object_decoding);
+				if (err != OK) {
+					return err;
+				}
+				if (buf) {
+					buf[0] = ENCODE_COMPACT | p_variant.get_type();
+				}
+				r_len += 1;
+				break;
+			}
+			[[fallthrough]];
+		}
 		default:
 			// Any other case is not yet compressed.
 			Error err = encode_variant(p_variant, r_buffer, r_len, p_allow_object_decoding);
@@ -144,7 +174,7 @@ Error MultiplayerAPI::encode_and_compress_variant(const Variant &p_variant, uint
 	return OK;
 }
 
-Error MultiplayerAPI::decode_and_decompress_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_object_decoding) {
+Error MultiplayerAPI::decode_and_decompress_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_object_decoding, bool p_compact) {
 	const uint8_t *buf = p_buffer;
 	int len = p_len;
 
@@ -203,6 +233,18 @@ Error MultiplayerAPI::decode_and_decompress_variant(Variant &r_variant, const ui
 			}
 		} break;
 		default:
+			if (encode_mode == ENCODE_COMPACT) {
+				ERR_FAIL_COND_V_MSG(!p_compact, ERR_UNAUTHORIZED, "Received a compact encoded variant, but compact variant encoding is disabled.");
+				Error err = decode_variant_compact_body(r_variant, buf + 1, len - 1, r_len, p_allow_object_decoding);
+				if (err != OK) {
+					return err;
+				}
+				ERR_FAIL_COND_V(r_variant.get_type() != type, ERR_INVALID_DATA);
+				if (r_len) {
+					(*r_len) += 1;
+				}
+				break;
+			}
 			Error err = decode_variant(r_variant, p_buffer, p_len, r_len, p_allow_object_decoding);
 			if (err != OK) {
 				return err;
@@ -212,7 +254,7 @@ Error MultiplayerAPI::decode_and_decompress_variant(Variant &r_variant, const ui
 	return OK;
 }
 
-Error MultiplayerAPI::encode_and_compress_variants(const Variant **p_variants, int p_count, uint8_t *p_buffer, int &r_len, bool *r_raw, bool p_allow_object_decoding) {
+Error MultiplayerAPI::encode_and_compress_variants(const Variant **p_variants, int p_count, uint8_t *p_buffer, int &r_len, bool *r_raw, bool p_allow_object_decoding, bool p_compact) {
 	r_len = 0;
 	int size = 0;
 
@@ -235,7 +277,7 @@ Error MultiplayerAPI::encode_and_compress_variants(const Variant **p_variants, i
 			}
 			r_len += pba.size();
 		} else {
-			encode_and_compress_variant(v, p_buffer, size, p_allow_object_decoding);
+			encode_and_compress_variant(v, p_buffer, size, p_allow_object_decoding, p_compact);
 			r_len += size;
 		}
 		return OK;
@@ -244,13 +286,13 @@ Error MultiplayerAPI::encode_and_compress_variants(const Variant **p_variants, i
 	// Regular encoding.
 	for (int i = 0; i < p_count; i++) {
 		const Variant &v = *(p_variants[i]);
-		encode_and_compress_variant(v, p_buffer ? p_buffer + r_len : nullptr, size, p_allow_object_decoding);
+		encode_and_compress_variant(v, p_buffer ? p_buffer + r_len : nullptr, size, p_allow_object_decoding, p_compact);
 		r_len += size;
 	}
 	return OK;
 }
 
-Error MultiplayerAPI::decode_and_decompress_variants(Vector<Variant> &r_variants, const uint8_t *p_buffer, int p_len, int &r_len, bool p_raw, bool p_allow_object_decoding) {
+Error MultiplayerAPI::decode_and_decompress_variants(Vector<Variant> &r_variants, const uint8_t *p_buffer, int p_len, int &r_len, bool p_raw, bool p_allow_object_decoding, bool p_compact) {
 	r_len = 0;
 	int argc = r_variants.size();
 	if (argc == 0 && p_raw) {
@@ -274,13 +316,21 @@ Error MultiplayerAPI::decode_and_decompress_variants(Vector<Variant> &r_variants
 		ERR_FAIL_COND_V_MSG(r_len >= p_len, ERR_INVALID_DATA, "Invalid packet received. Size too small.");
 
 		int vlen;
-		Error err = MultiplayerAPI::decode_and_decompress_variant(r_variants.write[i], &p_buffer[r_len], p_len - r_len, &vlen, p_allow_object_decoding);
+		Error err = MultiplayerAPI::decode_and_decompress_variant(r_variants.write[i], &p_buffer[r_len], p_len - r_len, &vlen, p_allow_object_decoding, p_compact);
 		ERR_FAIL_COND_V_MSG(err != OK, err, "Invalid packet received. Unable to decode state variable.");
 		r_len += vlen;
 	}
 	return OK;
 }
 
+void MultiplayerAPI::set_compact_variant_encoding(bool p_enabled) {
+	compact_variant_encoding = p_enabled;
+}
+
+bool MultiplayerAPI::is_compact_variant_encoding_enabled() const {
+	return compact_variant_encoding;
+}
+
 Error MultiplayerAPI::_rpc_bind(int p_peer, Object *p_object, const StringName &p_method, Array p_args) {
 	Vector<Variant> args;
 	Vector<const Variant *> argsp;
@@ -309,7 +359,11 @@ void MultiplayerAPI::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_peers"), &MultiplayerAPI::get_peer_ids);
 
+	ClassDB::bind_method(D_METHOD("set_compact_variant_encoding", "enabled"), &MultiplayerAPI::set_compact_variant_encoding);
+	ClassDB::bind_method(D_METHOD("is_compact_variant_encoding_enabled"), &MultiplayerAPI::is_compact_variant_encoding_enabled);
+
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "multiplayer_peer", PROPERTY_HINT_RESOURCE_TYPE, "MultiplayerPeer", PROPERTY_USAGE_NONE), "set_multiplayer_peer", "get_multiplayer_peer");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "compact_variant_encoding"), "set_compact_variant_encoding", "is_compact_variant_encoding_enabled");
 
 	ClassDB::bind_static_method("MultiplayerAPI", D_METHOD("set_default_interface", "interface_name"), &MultiplayerAPI::set_default_interface);
 	ClassDB::bind_static_method("MultiplayerAPI", D_METHOD("get_default_interface"), &MultiplayerAPI::get_default_interface);
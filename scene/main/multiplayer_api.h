@@ -40,6 +40,8 @@ class MultiplayerAPI : public RefCounted {
 private:
 	static StringName default_interface;
 
+	bool compact_variant_encoding = false;
+
 protected:
 	static void _bind_methods();
 	Error _rpc_bind(int p_peer, Object *p_obj, const StringName &p_method, Array args = Array());
@@ -55,10 +57,13 @@ public:
 	static void set_default_interface(const StringName &p_interface);
 	static StringName get_default_interface();
 
-	static Error encode_and_compress_variant(const Variant &p_variant, uint8_t *p_buffer, int &r_len, bool p_allow_object_decoding);
-	static Error decode_and_decompress_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_object_decoding);
-	static Error encode_and_compress_variants(const Variant **p_variants, int p_count, uint8_t *p_buffer, int &r_len, bool *r_raw = nullptr, bool p_allow_object_decoding = false);
-	static Error decode_and_decompress_variants(Vector<Variant> &r_variants, const uint8_t *p_buffer, int p_len, int &r_len, bool p_raw = false, bool p_allow_object_decoding = false);
+	static Error encode_and_compress_variant(const Variant &p_variant, uint8_t *p_buffer, int &r_len, bool p_allow_object_decoding, bool p_compact = false);
+	static Error decode_and_decompress_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_object_decoding, bool p_compact = false);
+	static Error encode_and_compress_variants(const Variant **p_variants, int p_count, uint8_t *p_buffer, int &r_len, bool *r_raw = nullptr, bool p_allow_object_decoding = false, bool p_compact = false);
+	static Error decode_and_decompress_variants(Vector<Variant> &r_variants, const uint8_t *p_buffer, int p_len, int &r_len, bool p_raw = false, bool p_allow_object_decoding = false, bool p_compact = false);
+
+	void set_compact_variant_encoding(bool p_enabled);
+	bool is_compact_variant_encoding_enabled() const;
 
 	virtual Error poll() = 0;
 	virtual void set_multiplayer_peer(const Ref<MultiplayerPeer> &p_peer) = 0;
@@ -31,6 +31,7 @@
 #include "scene_tree.h"
 
 #include "core/config/project_settings.h"
+#include "core/core_string_names.h"
 #include "core/debugger/engine_debugger.h"
 #include "core/input/input.h"
 #include "core/io/dir_access.h"
@@ -38,6 +39,7 @@
 #include "core/io/marshalls.h"
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
+#include "core/os/frame_allocator.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
@@ -64,6 +66,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// Snapshot of the nodes of a group, so nodes can leave the group while it is
+// being called. Only lives for the duration of the call.
+typedef LocalVector<Node *, uint32_t, true, true, FrameAllocator> GroupSnapshot;
+
 void SceneTreeTimer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_time_left", "time"), &SceneTreeTimer::set_time_left);
 	ClassDB::bind_method(D_METHOD("get_time_left"), &SceneTreeTimer::get_time_left);
@@ -253,8 +259,9 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 
 	_update_group_order(g);
 
-	Vector<Node *> nodes_copy = g.nodes;
-	Node **gr_nodes = nodes_copy.ptrw();
+	GroupSnapshot nodes_copy;
+	nodes_copy = g.nodes;
+	Node **gr_nodes = nodes_copy.ptr();
 	int gr_node_count = nodes_copy.size();
 
 	call_lock++;
@@ -306,8 +313,9 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 
 	_update_group_order(g);
 
-	Vector<Node *> nodes_copy = g.nodes;
-	Node **gr_nodes = nodes_copy.ptrw();
+	GroupSnapshot nodes_copy;
+	nodes_copy = g.nodes;
+	Node **gr_nodes = nodes_copy.ptr();
 	int gr_node_count = nodes_copy.size();
 
 	call_lock++;
@@ -357,8 +365,9 @@ void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group
 
 	_update_group_order(g);
 
-	Vector<Node *> nodes_copy = g.nodes;
-	Node **gr_nodes = nodes_copy.ptrw();
+	GroupSnapshot nodes_copy;
+	nodes_copy = g.nodes;
+	Node **gr_nodes = nodes_copy.ptr();
 	int gr_node_count = nodes_copy.size();
 
 	call_lock++;
@@ -571,6 +580,7 @@ void SceneTree::process_tweens(double p_delta, bool p_physics) {
 
 void SceneTree::finalize() {
 	_flush_delete_queue();
+	pool_clear();
 
 	_flush_ugc();
 
@@ -849,12 +859,13 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 
 	_update_group_order(g, p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
+	// Copy, in case something is removed from process while being called.
+	// The copy lives in the frame allocator, so this doesn't reach malloc.
+	GroupSnapshot nodes_copy;
+	nodes_copy = g.nodes;
 
 	int gr_node_count = nodes_copy.size();
-	Node **gr_nodes = nodes_copy.ptrw();
+	Node **gr_nodes = nodes_copy.ptr();
 
 	call_lock++;
 
@@ -893,16 +904,17 @@ void SceneTree::_call_input_pause(const StringName &p_group, CallInputType p_cal
 
 	_update_group_order(g);
 
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
+	// Copy, in case something is removed from process while being called.
+	// The copy lives in the frame allocator, so this doesn't reach malloc.
+	GroupSnapshot nodes_copy;
+	nodes_copy = g.nodes;
 
 	int gr_node_count = nodes_copy.size();
-	Node **gr_nodes = nodes_copy.ptrw();
+	Node **gr_nodes = nodes_copy.ptr();
 
 	call_lock++;
 
-	Vector<ObjectID> no_context_node_ids; // Nodes may be deleted due to this shortcut input.
+	LocalVector<ObjectID, uint32_t, false, false, FrameAllocator> no_context_node_ids; // Nodes may be deleted due to this shortcut input.
 
 	for (int i = gr_node_count - 1; i >= 0; i--) {
 		if (p_viewport->is_input_handled()) {
@@ -928,7 +940,7 @@ void SceneTree::_call_input_pause(const StringName &p_group, CallInputType p_cal
 					// If calling shortcut input on a control, ensure it respects the shortcut context.
 					// Shortcut context (based on focus) only makes sense for controls (UI), so don't need to worry about it for nodes
 					if (c->get_shortcut_context() == nullptr) {
-						no_context_node_ids.append(n->get_instance_id());
+						no_context_node_ids.push_back(n->get_instance_id());
 						continue;
 					}
 					if (!c->is_focus_owner_in_shortcut_context()) {
@@ -1064,6 +1076,9 @@ void SceneTree::_flush_delete_queue() {
 		}
 		delete_queue.pop_front();
 	}
+
+	// After deleting, so nodes freed after being released are skipped.
+	_flush_pool_release_queue();
 }
 
 void SceneTree::queue_delete(Object *p_object) {
@@ -1073,6 +1088,256 @@ void SceneTree::queue_delete(Object *p_object) {
 	delete_queue.push_back(p_object->get_instance_id());
 }
 
+void SceneTree::_get_pooled_nodes(Node *p_node, LocalVector<Node *> &r_nodes) {
+	r_nodes.push_back(p_node);
+	int cc = p_node->get_child_count();
+	for (int i = 0; i < cc; i++) {
+		_get_pooled_nodes(p_node->get_child(i), r_nodes);
+	}
+}
+
+void SceneTree::_record_pooled_node_state(Node *p_root, LocalVector<PooledNodeState> &r_state) {
+	LocalVector<Node *> nodes;
+	_get_pooled_nodes(p_root, nodes);
+
+	HashMap<Object *, int> node_indices;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		node_indices[nodes[i]] = i;
+	}
+
+	r_state.resize(nodes.size());
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		Node *node = nodes[i];
+		PooledNodeState &state = r_state[i];
+		state.name = node->get_name();
+		state.child_count = node->get_child_count();
+
+		List<PropertyInfo> plist;
+		node->get_property_list(&plist);
+		for (const PropertyInfo &E : plist) {
+			// Script variables are reset too, even the ones which aren't exported.
+			if (!(E.usage & (PROPERTY_USAGE_STORAGE | PROPERTY_USAGE_SCRIPT_VARIABLE)) || E.name == CoreStringNames::get_singleton()->_script) {
+				continue;
+			}
+			Variant value = node->get(E.name);
+			if (value.get_type() == Variant::OBJECT) {
+				// Node references and resources local to scene are different for each instance.
+				Ref<Resource> res = value;
+				if (value.get_validated_object() && (res.is_null() || res->is_local_to_scene())) {
+					continue;
+				}
+			}
+			state.properties.push_back(Pair<StringName, Variant>(E.name, value.duplicate(true)));
+		}
+
+		List<StringName> meta;
+		node->get_meta_list(&meta);
+		for (const StringName &E : meta) {
+			state.meta.push_back(E);
+		}
+
+		List<Node::GroupInfo> groups;
+		node->get_groups(&groups);
+		for (const Node::GroupInfo &E : groups) {
+			state.groups.push_back(E.name);
+		}
+
+		List<Object::Connection> connections;
+		node->get_all_signal_connections(&connections);
+		for (const Object::Connection &E : connections) {
+			const int *target = node_indices.getptr(E.callable.get_object());
+			if (target && !(E.flags & CONNECT_PERSIST)) {
+				PooledConnection connection;
+				connection.signal = E.signal.get_name();
+				connection.target = *target;
+				connection.method = E.callable.get_method();
+				state.connections.push_back(connection);
+			}
+		}
+	}
+}
+
+bool SceneTree::_reset_pooled_node(const LocalVector<PooledNodeState> &p_state, Node *p_root) {
+	LocalVector<Node *> nodes;
+	_get_pooled_nodes(p_root, nodes);
+
+	// Nodes added or removed at runtime can't be tracked, such instances are freed instead.
+	if (nodes.size() != p_state.size()) {
+		return false;
+	}
+	HashMap<Object *, int> node_indices;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		if (nodes[i]->get_child_count() != p_state[i].child_count || (i > 0 && nodes[i]->get_name() != p_state[i].name)) {
+			return false;
+		}
+		node_indices[nodes[i]] = i;
+	}
+
+	p_root->set_name(p_state[0].name);
+
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		Node *node = nodes[i];
+		const PooledNodeState &state = p_state[i];
+
+		// Drop connections made at runtime, they will be made again when reused.
+		// Connections to objects other than nodes (e.g. resources) are kept, as nodes
+		// usually make those when the resource is assigned, not when entering the tree.
+		List<Object::Connection> connections;
+		node->get_all_signal_connections(&connections);
+		for (const Object::Connection &E : connections) {
+			if (E.flags & CONNECT_PERSIST) {
+				continue;
+			}
+			Object *target = E.callable.get_object();
+			const int *target_index = node_indices.getptr(target);
+			bool keep = false;
+			if (target_index) {
+				for (const PooledConnection &connection : state.connections) {
+					if (connection.target == *target_index && connection.signal == E.signal.get_name() && connection.method == E.callable.get_method()) {
+						keep = true;
+						break;
+					}
+				}
+			} else {
+				keep = !Object::cast_to<Node>(target);
+			}
+			if (!keep && node->is_connected(E.signal.get_name(), E.callable)) {
+				node->disconnect(E.signal.get_name(), E.callable);
+			}
+		}
+
+		connections.clear();
+		node->get_signals_connected_to_this(&connections);
+		for (const Object::Connection &E : connections) {
+			Node *source = Object::cast_to<Node>(E.signal.get_object());
+			if (source && !(E.flags & CONNECT_PERSIST) && !node_indices.has(source) && source->is_connected(E.signal.get_name(), E.callable)) {
+				source->disconnect(E.signal.get_name(), E.callable);
+			}
+		}
+
+		for (const Pair<StringName, Variant> &E : state.properties) {
+			if (node->get(E.first) != E.second) {
+				node->set(E.first, E.second.duplicate(true));
+			}
+		}
+
+		List<StringName> meta;
+		node->get_meta_list(&meta);
+		for (const StringName &E : meta) {
+			if (state.meta.find(E) < 0) {
+				node->remove_meta(E);
+			}
+		}
+
+		List<Node::GroupInfo> groups;
+		node->get_groups(&groups);
+		for (const Node::GroupInfo &E : groups) {
+			if (state.groups.find(E.name) < 0) {
+				node->remove_from_group(E.name);
+			}
+		}
+		for (const StringName &E : state.groups) {
+			if (!node->is_in_group(E)) {
+				node->add_to_group(E, true);
+			}
+		}
+
+		node->request_ready();
+	}
+
+	return true;
+}
+
+void SceneTree::_flush_pool_release_queue() {
+	_THREAD_SAFE_METHOD_
+
+	// Removing nodes can release more of them, so don't cache the size.
+	for (uint32_t i = 0; i < pool_release_queue.size(); i++) {
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(pool_release_queue[i]));
+		if (!node) {
+			continue;
+		}
+		node->_is_queued_for_deletion = false;
+
+		if (node->get_parent()) {
+			node->get_parent()->remove_child(node);
+		}
+		if (node->get_owner()) {
+			node->set_owner(nullptr);
+		}
+
+		NodePool *pool = node_pools.getptr(node->get_scene_file_path());
+		if (!pool || pool->nodes.size() >= (uint32_t)node_pool_max_size || !_reset_pooled_node(pool->state, node)) {
+			memdelete(node);
+			continue;
+		}
+		pool->nodes.push_back(node->get_instance_id());
+		pooled_node_count++;
+	}
+	pool_release_queue.clear();
+}
+
+Node *SceneTree::pool_instantiate(const Ref<PackedScene> &p_scene) {
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND_V(p_scene.is_null(), nullptr);
+	ERR_FAIL_COND_V_MSG(p_scene->is_built_in(), nullptr, "Only scenes saved to their own file can be pooled.");
+
+	NodePool &pool = node_pools[p_scene->get_path()];
+	while (!pool.nodes.is_empty()) {
+		ObjectID id = pool.nodes[pool.nodes.size() - 1];
+		pool.nodes.resize(pool.nodes.size() - 1);
+		pooled_node_count--;
+		// Pooled nodes may have been freed by a reference kept after releasing them.
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(id));
+		if (node) {
+			node_pool_hits++;
+			return node;
+		}
+	}
+
+	Node *node = p_scene->instantiate();
+	ERR_FAIL_NULL_V(node, nullptr);
+	node_pool_misses++;
+	if (pool.state.is_empty()) {
+		_record_pooled_node_state(node, pool.state);
+	}
+	return node;
+}
+
+void SceneTree::pool_release(Node *p_node) {
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_NULL(p_node);
+	ERR_FAIL_COND_MSG(p_node->is_queued_for_deletion(), "Node was already released or queued for deletion.");
+	NodePool *pool = node_pools.getptr(p_node->get_scene_file_path());
+	ERR_FAIL_COND_MSG(!pool, "Only instances of scenes created with pool_instantiate() can be released to a pool.");
+	ERR_FAIL_COND_MSG(pool->nodes.find(p_node->get_instance_id()) >= 0, "Node is already in the pool.");
+	p_node->_is_queued_for_deletion = true;
+	pool_release_queue.push_back(p_node->get_instance_id());
+}
+
+void SceneTree::pool_clear() {
+	_THREAD_SAFE_METHOD_
+	for (KeyValue<String, NodePool> &E : node_pools) {
+		for (const ObjectID &id : E.value.nodes) {
+			Node *node = Object::cast_to<Node>(ObjectDB::get_instance(id));
+			if (node) {
+				memdelete(node);
+			}
+		}
+	}
+	node_pools.clear();
+	pooled_node_count = 0;
+}
+
+void SceneTree::set_node_pool_max_size(int p_size) {
+	ERR_FAIL_COND(p_size < 0);
+	node_pool_max_size = p_size;
+}
+
+int SceneTree::get_node_pool_max_size() const {
+	return node_pool_max_size;
+}
+
 int SceneTree::get_node_count() const {
 	return node_count;
 }
@@ -1272,6 +1537,15 @@ void SceneTree::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("queue_delete", "obj"), &SceneTree::queue_delete);
 
+	ClassDB::bind_method(D_METHOD("pool_instantiate", "packed_scene"), &SceneTree::pool_instantiate);
+	ClassDB::bind_method(D_METHOD("pool_release", "node"), &SceneTree::pool_release);
+	ClassDB::bind_method(D_METHOD("pool_clear"), &SceneTree::pool_clear);
+	ClassDB::bind_method(D_METHOD("set_node_pool_max_size", "size"), &SceneTree::set_node_pool_max_size);
+	ClassDB::bind_method(D_METHOD("get_node_pool_max_size"), &SceneTree::get_node_pool_max_size);
+	ClassDB::bind_method(D_METHOD("get_node_pool_hit_count"), &SceneTree::get_node_pool_hit_count);
+	ClassDB::bind_method(D_METHOD("get_node_pool_miss_count"), &SceneTree::get_node_pool_miss_count);
+	ClassDB::bind_method(D_METHOD("get_pooled_node_count"), &SceneTree::get_pooled_node_count);
+
 	MethodInfo mi;
 	mi.name = "call_group_flags";
 	mi.arguments.push_back(PropertyInfo(Variant::INT, "flags"));
@@ -1322,6 +1596,7 @@ void SceneTree::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "current_scene", PROPERTY_HINT_RESOURCE_TYPE, "Node", PROPERTY_USAGE_NONE), "set_current_scene", "get_current_scene");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "root", PROPERTY_HINT_RESOURCE_TYPE, "Node", PROPERTY_USAGE_NONE), "", "get_root");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "multiplayer_poll"), "set_multiplayer_poll_enabled", "is_multiplayer_poll_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "node_pool_max_size", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_node_pool_max_size", "get_node_pool_max_size");
 
 	ADD_SIGNAL(MethodInfo("tree_changed"));
 	ADD_SIGNAL(MethodInfo("tree_process_mode_changed")); //editor only signal, but due to API hash it can't be removed in run-time
@@ -1534,6 +1809,8 @@ SceneTree::SceneTree() {
 }
 
 SceneTree::~SceneTree() {
+	pool_clear();
+
 	if (root) {
 		root->_set_tree(nullptr);
 		root->_propagate_after_exit_tree();
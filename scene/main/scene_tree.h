@@ -33,6 +33,8 @@
 
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/pair.h"
 #include "core/templates/self_list.h"
 #include "scene/resources/mesh.h"
 
@@ -139,6 +141,39 @@ private:
 
 	List<ObjectID> delete_queue;
 
+	// Node pooling, see pool_instantiate().
+	struct PooledConnection {
+		StringName signal;
+		int target = 0; // Index of the target in PooledNodeState.
+		StringName method;
+	};
+
+	struct PooledNodeState {
+		StringName name;
+		int child_count = 0;
+		LocalVector<Pair<StringName, Variant>> properties;
+		LocalVector<StringName> meta;
+		LocalVector<StringName> groups;
+		LocalVector<PooledConnection> connections; // Between nodes of the instance.
+	};
+
+	struct NodePool {
+		LocalVector<PooledNodeState> state; // Every node of a fresh instance, depth first.
+		LocalVector<ObjectID> nodes; // Released instances ready for reuse.
+	};
+
+	HashMap<String, NodePool> node_pools; // By scene path.
+	LocalVector<ObjectID> pool_release_queue;
+	int node_pool_max_size = 64;
+	uint64_t node_pool_hits = 0;
+	uint64_t node_pool_misses = 0;
+	int pooled_node_count = 0;
+
+	void _flush_pool_release_queue();
+	static void _get_pooled_nodes(Node *p_node, LocalVector<Node *> &r_nodes);
+	static void _record_pooled_node_state(Node *p_root, LocalVector<PooledNodeState> &r_state);
+	static bool _reset_pooled_node(const LocalVector<PooledNodeState> &p_state, Node *p_root);
+
 	HashMap<UGCall, Vector<Variant>, UGCall> unique_group_calls;
 	bool ugc_locked = false;
 	void _flush_ugc();
@@ -346,6 +381,17 @@ public:
 
 	void queue_delete(Object *p_object);
 
+	Node *pool_instantiate(const Ref<PackedScene> &p_scene);
+	void pool_release(Node *p_node);
+	void pool_clear();
+
+	void set_node_pool_max_size(int p_size);
+	int get_node_pool_max_size() const;
+
+	uint64_t get_node_pool_hit_count() const { return node_pool_hits; }
+	uint64_t get_node_pool_miss_count() const { return node_pool_misses; }
+	int get_pooled_node_count() const { return pooled_node_count; }
+
 	void get_nodes_in_group(const StringName &p_group, List<Node *> *p_list);
 	Node *get_first_node_in_group(const StringName &p_group);
 	bool has_group(const StringName &p_identifier) const;
@@ -70,6 +70,56 @@ static Array _sanitize_node_pinned_properties(Node *p_node) {
 	return pinned;
 }
 
+const SceneState::NodePlan *SceneState::_get_instantiation_plan() const {
+	MutexLock lock(instantiation_plan_mutex);
+	if (instantiation_plan_built) {
+		return instantiation_plan.ptr();
+	}
+
+	instantiation_plan.resize(nodes.size());
+	for (int i = 0; i < nodes.size(); i++) {
+		const NodeData &n = nodes[i];
+		NodePlan &plan = instantiation_plan[i];
+		plan.create = nullptr;
+		plan.properties.clear();
+		plan.properties.resize(n.properties.size());
+
+		// Only nodes created from their class, instances and inherited nodes need the full path.
+		if ((i == 0 && base_scene_idx >= 0) || n.instance >= 0 || n.type == TYPE_INSTANTIATED || n.type < 0 || n.type >= names.size()) {
+			continue;
+		}
+		plan.create = ClassDB::get_creation_func(names[n.type]);
+		if (!plan.create) {
+			continue;
+		}
+
+		for (int j = 0; j < n.properties.size(); j++) {
+			const NodeData::Property &prop = n.properties[j];
+			if ((prop.name & FLAG_PATH_PROPERTY_IS_NODE) || prop.name >= names.size() || prop.value < 0 || prop.value >= variants.size()) {
+				continue;
+			}
+			const StringName &name = names[prop.name];
+			if (name == CoreStringNames::get_singleton()->_script) {
+				break; // The script may handle any property set after it.
+			}
+			const Variant::Type type = variants[prop.value].get_type();
+			if (type == Variant::OBJECT || type == Variant::ARRAY) {
+				continue; // Local to scene resources and typed arrays are handled when instantiating.
+			}
+			plan.properties[j].setter = ClassDB::get_property_setter_bind(names[n.type], name, &plan.properties[j].index);
+		}
+	}
+
+	instantiation_plan_built = true;
+	return instantiation_plan.ptr();
+}
+
+void SceneState::_clear_instantiation_plan() {
+	MutexLock lock(instantiation_plan_mutex);
+	instantiation_plan.clear();
+	instantiation_plan_built = false;
+}
+
 Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	// Nodes where instantiation failed (because something is missing.)
 	List<Node *> stray_instances;
@@ -111,6 +161,12 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 	LocalVector<DeferredNodePathProperties> deferred_node_paths;
 
+	// The editor relies on everything going through Object::set().
+	const NodePlan *plan = nullptr;
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED && !Engine::get_singleton()->is_editor_hint()) {
+		plan = _get_instantiation_plan();
+	}
+
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
 
@@ -181,7 +237,7 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			}
 		} else {
 			//node belongs to this scene and must be created
-			Object *obj = ClassDB::instantiate(snames[n.type]);
+			Object *obj = (plan && plan[i].create) ? plan[i].create() : ClassDB::instantiate(snames[n.type]);
 
 			node = Object::cast_to<Node>(obj);
 
@@ -236,6 +292,21 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 					ERR_FAIL_INDEX_V(nprops[j].value, prop_count, nullptr);
 
+					if (plan && plan[i].properties[j].setter) {
+						// Same as ClassDB::set_property(), without looking up the setter.
+						const PropertyPlan &prop_plan = plan[i].properties[j];
+						Callable::CallError ce;
+						if (prop_plan.index >= 0) {
+							Variant index = prop_plan.index;
+							const Variant *args[2] = { &index, &props[nprops[j].value] };
+							prop_plan.setter->call(node, args, 2, ce);
+						} else {
+							const Variant *args[1] = { &props[nprops[j].value] };
+							prop_plan.setter->call(node, args, 1, ce);
+						}
+						continue;
+					}
+
 					if (nprops[j].name & FLAG_PATH_PROPERTY_IS_NODE) {
 						uint32_t name_idx = nprops[j].name & (FLAG_PATH_PROPERTY_IS_NODE - 1);
 						ERR_FAIL_UNSIGNED_INDEX_V(name_idx, (uint32_t)sname_count, nullptr);
@@ -482,6 +553,18 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	return ret_nodes[0];
 }
 
+void SceneState::instantiate_batch(int p_count, GenEditState p_edit_state, LocalVector<Node *> &r_nodes) const {
+	ERR_FAIL_COND(p_count < 0);
+	r_nodes.reserve(r_nodes.size() + p_count);
+	for (int i = 0; i < p_count; i++) {
+		Node *node = instantiate(p_edit_state);
+		if (!node) {
+			return;
+		}
+		r_nodes.push_back(node);
+	}
+}
+
 static int _nm_get_string(const String &p_string, HashMap<StringName, int> &name_map) {
 	if (name_map.has(p_string)) {
 		return name_map[p_string];
@@ -1014,6 +1097,7 @@ void SceneState::clear() {
 	node_paths.clear();
 	editable_instances.clear();
 	base_scene_idx = -1;
+	_clear_instantiation_plan();
 }
 
 Error SceneState::copy_from(const Ref<SceneState> &p_scene_state) {
@@ -1061,6 +1145,8 @@ Ref<SceneState> SceneState::get_base_scene_state() const {
 void SceneState::update_instance_resource(String p_path, Ref<PackedScene> p_packed_scene) {
 	ERR_FAIL_COND(p_packed_scene.is_null());
 
+	_clear_instantiation_plan();
+
 	for (const NodeData &nd : nodes) {
 		if (nd.instance >= 0) {
 			if (!(nd.instance & FLAG_INSTANCE_IS_PLACEHOLDER)) {
@@ -1229,6 +1315,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 	const Vector<int> sconns = p_dictionary["conns"];
 	ERR_FAIL_COND(sconns.size() < conn_count);
 
+	_clear_instantiation_plan();
+
 	Vector<String> snames = p_dictionary["names"];
 	if (snames.size()) {
 		int namecount = snames.size();
@@ -1684,6 +1772,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.index = p_index;
 
 	nodes.push_back(nd);
+	_clear_instantiation_plan();
 
 	return nodes.size() - 1;
 }
@@ -1700,6 +1789,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 	}
 	prop.value = p_value;
 	nodes.write[p_node].properties.push_back(prop);
+	_clear_instantiation_plan();
 }
 
 void SceneState::add_node_group(int p_node, int p_group) {
@@ -1711,6 +1801,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
 	base_scene_idx = p_idx;
+	_clear_instantiation_plan();
 }
 
 void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method, int p_flags, int p_unbinds, const Vector<int> &p_binds) {
@@ -1851,6 +1942,34 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 	return s;
 }
 
+TypedArray<Node> PackedScene::instantiate_batch(int p_count, GenEditState p_edit_state) const {
+#ifndef TOOLS_ENABLED
+	ERR_FAIL_COND_V_MSG(p_edit_state != GEN_EDIT_STATE_DISABLED, TypedArray<Node>(), "Edit state is only for editors, does not work without tools compiled.");
+#endif
+	ERR_FAIL_COND_V(p_count < 0, TypedArray<Node>());
+
+	LocalVector<Node *> nodes;
+	state->instantiate_batch(p_count, (SceneState::GenEditState)p_edit_state, nodes);
+
+	const String scene_file_path = is_built_in() ? String() : get_path();
+
+	TypedArray<Node> ret;
+	ret.resize(nodes.size());
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		Node *s = nodes[i];
+		if (p_edit_state != GEN_EDIT_STATE_DISABLED) {
+			s->set_scene_instance_state(state);
+		}
+		if (!scene_file_path.is_empty()) {
+			s->set_scene_file_path(scene_file_path);
+		}
+		s->notification(Node::NOTIFICATION_SCENE_INSTANTIATED);
+		ret[i] = s;
+	}
+
+	return ret;
+}
+
 void PackedScene::replace_state(Ref<SceneState> p_by) {
 	state = p_by;
 	state->set_path(get_path());
@@ -1882,6 +2001,7 @@ void PackedScene::reset_state() {
 void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instantiate", "edit_state"), &PackedScene::instantiate, DEFVAL(GEN_EDIT_STATE_DISABLED));
+	ClassDB::bind_method(D_METHOD("instantiate_batch", "count", "edit_state"), &PackedScene::instantiate_batch, DEFVAL(GEN_EDIT_STATE_DISABLED));
 	ClassDB::bind_method(D_METHOD("can_instantiate"), &PackedScene::can_instantiate);
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene", "scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
@@ -32,6 +32,9 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/object/class_db.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -89,6 +92,25 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Class constructors and property setters resolved ahead of time, so plain
+	// instances don't look them up by name for every node. Built on first use.
+	struct PropertyPlan {
+		MethodBind *setter = nullptr; // If null, the property goes through Object::set().
+		int index = -1;
+	};
+
+	struct NodePlan {
+		ClassDB::CreationFunc create = nullptr;
+		LocalVector<PropertyPlan> properties;
+	};
+
+	mutable LocalVector<NodePlan> instantiation_plan;
+	mutable bool instantiation_plan_built = false;
+	mutable Mutex instantiation_plan_mutex;
+
+	const NodePlan *_get_instantiation_plan() const;
+	void _clear_instantiation_plan();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 
@@ -147,6 +169,7 @@ public:
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state) const;
+	void instantiate_batch(int p_count, GenEditState p_edit_state, LocalVector<Node *> &r_nodes) const;
 
 	Ref<SceneState> get_base_scene_state() const;
 
@@ -234,6 +257,7 @@ public:
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
+	TypedArray<Node> instantiate_batch(int p_count, GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
 
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
@@ -754,14 +754,21 @@ Ref<Image> CompressedTexture2D::load_image_from_file(Ref<FileAccess> f, int p_si
 			f->seek(f->get_position() + size);
 			return Ref<Image>();
 		}
-		Vector<uint8_t> pv;
-		pv.resize(size);
-		{
-			uint8_t *wr = pv.ptrw();
-			f->get_buffer(wr, size);
-		}
 		Ref<Image> img;
-		img = Image::basis_universal_unpacker(pv);
+		const uint8_t *mapped = f->get_mapped_buffer();
+		if (mapped && Image::basis_universal_unpacker_ptr && f->get_position() + size <= f->get_length()) {
+			// Transcode straight from the mapped file, the compressed data doesn't need a copy.
+			img = Image::basis_universal_unpacker_ptr(mapped + f->get_position(), size);
+			f->seek(f->get_position() + size);
+		} else {
+			Vector<uint8_t> pv;
+			pv.resize(size);
+			{
+				uint8_t *wr = pv.ptrw();
+				f->get_buffer(wr, size);
+			}
+			img = Image::basis_universal_unpacker(pv);
+		}
 		if (img.is_null() || img->is_empty()) {
 			ERR_FAIL_COND_V(img.is_null() || img->is_empty(), Ref<Image>());
 		}
@@ -788,7 +795,15 @@ Ref<Image> CompressedTexture2D::load_image_from_file(Ref<FileAccess> f, int p_si
 
 			{
 				uint8_t *wr = data.ptrw();
-				f->get_buffer(wr, data.size());
+				const uint8_t *mapped = f->get_mapped_buffer();
+				if (mapped && f->get_position() + data.size() <= f->get_length()) {
+					// The image owns its data, but it can at least be copied once from the mapped file
+					// instead of going through the file buffers.
+					memcpy(wr, mapped + f->get_position(), data.size());
+					f->seek(f->get_position() + data.size());
+				} else {
+					f->get_buffer(wr, data.size());
+				}
 			}
 
 			Ref<Image> image = Image::create_from_data(tw, th, mipmaps - i ? true : false, format, data);
@@ -31,6 +31,7 @@
 #include "physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/frame_allocator.h"
 #include "core/string/print_string.h"
 #include "core/variant/typed_array.h"
 
@@ -371,11 +372,12 @@ Dictionary PhysicsDirectSpaceState3D::_intersect_ray(const Ref<PhysicsRayQueryPa
 
 TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_point(const Ref<PhysicsPointQueryParameters3D> &p_point_query, int p_max_results) {
 	ERR_FAIL_COND_V(p_point_query.is_null(), TypedArray<Dictionary>());
+	ERR_FAIL_COND_V(p_max_results < 0, TypedArray<Dictionary>());
 
-	Vector<ShapeResult> ret;
+	LocalVector<ShapeResult, uint32_t, false, true, FrameAllocator> ret;
 	ret.resize(p_max_results);
 
-	int rc = intersect_point(p_point_query->get_parameters(), ret.ptrw(), ret.size());
+	int rc = intersect_point(p_point_query->get_parameters(), ret.ptr(), ret.size());
 
 	if (rc == 0) {
 		return TypedArray<Dictionary>();
@@ -396,10 +398,11 @@ TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_point(const Ref<Phy
 
 TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), TypedArray<Dictionary>());
+	ERR_FAIL_COND_V(p_max_results < 0, TypedArray<Dictionary>());
 
-	Vector<ShapeResult> sr;
+	LocalVector<ShapeResult, uint32_t, false, true, FrameAllocator> sr;
 	sr.resize(p_max_results);
-	int rc = intersect_shape(p_shape_query->get_parameters(), sr.ptrw(), sr.size());
+	int rc = intersect_shape(p_shape_query->get_parameters(), sr.ptr(), sr.size());
 	TypedArray<Dictionary> ret;
 	ret.resize(rc);
 	for (int i = 0; i < rc; i++) {
@@ -431,11 +434,12 @@ Vector<real_t> PhysicsDirectSpaceState3D::_cast_motion(const Ref<PhysicsShapeQue
 
 TypedArray<PackedVector3Array> PhysicsDirectSpaceState3D::_collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
 
-	Vector<Vector3> ret;
+	LocalVector<Vector3, uint32_t, true, true, FrameAllocator> ret;
 	ret.resize(p_max_results * 2);
 	int rc = 0;
-	bool res = collide_shape(p_shape_query->get_parameters(), ret.ptrw(), p_max_results, rc);
+	bool res = collide_shape(p_shape_query->get_parameters(), ret.ptr(), p_max_results, rc);
 	if (!res) {
 		return TypedArray<PackedVector3Array>();
 	}
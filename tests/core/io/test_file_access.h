@@ -32,6 +32,9 @@
 #define TEST_FILE_ACCESS_H
 
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
+#include "core/io/file_access_memory.h"
+#include "core/os/os.h"
 #include "tests/test_macros.h"
 #include "tests/test_utils.h"
 
@@ -105,6 +108,83 @@ TEST_CASE("[FileAccess] Get as UTF-8 String") {
 	CHECK(s_cr == "Hello darkness\rMy old friend\rI've come to talk\rWith you again\r");
 	CHECK(s_cr_nocr == "Hello darknessMy old friendI've come to talkWith you again");
 }
+
+TEST_CASE("[FileAccess] Mapped buffer") {
+	Ref<FileAccess> f = FileAccess::open(TestUtils::get_data_path("line_endings_lf.test.txt"), FileAccess::READ);
+	REQUIRE(!f.is_null());
+	const uint8_t *mapped = f->get_mapped_buffer();
+	if (mapped) {
+		Vector<uint8_t> contents = f->get_buffer(f->get_length());
+		REQUIRE(contents.size() == (int64_t)f->get_length());
+		CHECK_MESSAGE(
+				memcmp(mapped, contents.ptr(), contents.size()) == 0,
+				"The mapped buffer should match the file contents.");
+		CHECK_MESSAGE(
+				f->get_mapped_buffer() == mapped,
+				"The file should only be mapped once.");
+	}
+
+	Ref<FileAccess> fw = FileAccess::open(OS::get_singleton()->get_cache_path().path_join("mapped_buffer.txt"), FileAccess::WRITE);
+	REQUIRE(!fw.is_null());
+	fw->store_string("Hello darkness");
+	CHECK_MESSAGE(
+			fw->get_mapped_buffer() == nullptr,
+			"Files opened for writing should not be mapped.");
+}
+
+TEST_CASE("[FileAccess] Compressed buffer") {
+	const uint32_t block_size = 4096;
+	// An exact multiple of the block size, so the last block is empty, and large enough to be decompressed in parallel.
+	Vector<uint8_t> data;
+	data.resize(block_size * 128);
+	for (int i = 0; i < data.size(); i++) {
+		data.write[i] = (i / 7) % 251;
+	}
+	Vector<uint8_t> dictionary;
+	dictionary.resize(256);
+	for (int i = 0; i < dictionary.size(); i++) {
+		dictionary.write[i] = i % 251;
+	}
+
+	for (int use_dictionary = 0; use_dictionary < 2; use_dictionary++) {
+		Vector<uint8_t> compressed = FileAccessCompressed::compress_buffer(data.ptr(), data.size(), "TEST", Compression::MODE_ZSTD, block_size, use_dictionary ? dictionary : Vector<uint8_t>());
+		REQUIRE(!compressed.is_empty());
+		CHECK(compressed.size() < data.size());
+
+		Ref<FileAccessMemory> fm;
+		fm.instantiate();
+		REQUIRE(fm->open_custom(compressed.ptr(), compressed.size()) == OK);
+		uint8_t magic[4];
+		fm->get_buffer(magic, 4);
+		CHECK(memcmp(magic, "TEST", 4) == 0);
+
+		Ref<FileAccessCompressed> fc;
+		fc.instantiate();
+		if (use_dictionary) {
+			fc->set_dictionary(dictionary);
+		}
+		REQUIRE(fc->open_after_magic(fm) == OK);
+		Ref<FileAccess> f = fc;
+		CHECK(f->get_length() == (uint64_t)data.size());
+
+		CHECK(f->get_8() == data[0]);
+		Vector<uint8_t> read = f->get_buffer(data.size() - 1);
+		REQUIRE(read.size() == data.size() - 1);
+		CHECK_MESSAGE(
+				memcmp(read.ptr(), data.ptr() + 1, read.size()) == 0,
+				"Blocks read at once should match the original data.");
+		CHECK(!f->eof_reached());
+		f->get_8();
+		CHECK(f->eof_reached());
+
+		f->seek(data.size() - 10);
+		CHECK(f->get_8() == data[data.size() - 10]);
+		f->seek(block_size * 3 + 5);
+		CHECK(f->get_8() == data[block_size * 3 + 5]);
+		CHECK(f->get_buffer(block_size * 200).size() == data.size() - (int)block_size * 3 - 6);
+		CHECK(f->eof_reached());
+	}
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
@@ -32,8 +32,11 @@
 #define TEST_JSON_H
 
 #include "core/io/json.h"
+#include "core/io/json_stream.h"
+#include "core/io/stream_peer.h"
+#include "core/os/os.h"
 
-#include "thirdparty/doctest/doctest.h"
+#include "tests/test_macros.h"
 
 namespace TestJSON {
 
@@ -146,6 +149,415 @@ TEST_CASE("[JSON] Parsing objects (dictionaries)") {
 			dictionary["empty_object"].hash() == Dictionary().hash(),
 			"The parsed JSON should contain the expected values.");
 }
+
+static Vector<uint8_t> _to_bytes(const String &p_text) {
+	const CharString utf8 = p_text.utf8();
+	Vector<uint8_t> bytes;
+	bytes.resize(utf8.length());
+	memcpy(bytes.ptrw(), utf8.get_data(), utf8.length());
+	return bytes;
+}
+
+static Variant _read_value(const String &p_text) {
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	reader->open_buffer(_to_bytes(p_text));
+	if (reader->read_value() != JSONReader::TOKEN_VALUE) {
+		return "<error>";
+	}
+	const Variant value = reader->get_value();
+	if (reader->read() != JSONReader::TOKEN_END) {
+		return "<error>";
+	}
+	return value;
+}
+
+TEST_CASE("[JSONReader] Reading tokens") {
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	reader->open_buffer(_to_bytes(R"({"name": "Godot", "tags": [1, true, null], "empty": {}})"));
+
+	CHECK(reader->read() == JSONReader::TOKEN_OBJECT_BEGIN);
+	CHECK(reader->get_depth() == 1);
+	CHECK(reader->read() == JSONReader::TOKEN_KEY);
+	CHECK(reader->get_value() == "name");
+	CHECK(reader->read() == JSONReader::TOKEN_VALUE);
+	CHECK(reader->get_value() == "Godot");
+	CHECK(reader->read() == JSONReader::TOKEN_KEY);
+	CHECK(reader->get_value() == "tags");
+	CHECK(reader->read() == JSONReader::TOKEN_ARRAY_BEGIN);
+	CHECK(reader->get_depth() == 2);
+	CHECK(reader->read() == JSONReader::TOKEN_VALUE);
+	CHECK(reader->get_value().get_type() == Variant::FLOAT);
+	CHECK(double(reader->get_value()) == 1.0);
+	CHECK(reader->read() == JSONReader::TOKEN_VALUE);
+	CHECK(reader->get_value() == Variant(true));
+	CHECK(reader->read() == JSONReader::TOKEN_VALUE);
+	CHECK(reader->get_value() == Variant());
+	CHECK(reader->read() == JSONReader::TOKEN_ARRAY_END);
+	CHECK(reader->read() == JSONReader::TOKEN_KEY);
+	CHECK(reader->get_value() == "empty");
+	CHECK_MESSAGE(
+			reader->read_value() == JSONReader::TOKEN_VALUE,
+			"Whole values should be readable in the middle of the document.");
+	CHECK(reader->get_value().get_type() == Variant::DICTIONARY);
+	CHECK(reader->read() == JSONReader::TOKEN_OBJECT_END);
+	CHECK(reader->get_depth() == 0);
+	CHECK(reader->read() == JSONReader::TOKEN_END);
+	CHECK(reader->read() == JSONReader::TOKEN_END);
+
+	const uint8_t with_bom[] = { 0xef, 0xbb, 0xbf, '4', '2' };
+	Vector<uint8_t> bytes;
+	bytes.resize(sizeof(with_bom));
+	memcpy(bytes.ptrw(), with_bom, sizeof(with_bom));
+	reader->open_buffer(bytes);
+	CHECK_MESSAGE(
+			reader->read() == JSONReader::TOKEN_VALUE,
+			"A byte order mark at the start should be skipped.");
+	CHECK(double(reader->get_value()) == 42.0);
+}
+
+TEST_CASE("[JSONReader] Reading values like JSON::parse") {
+	const String documents[] = {
+		"null",
+		"  -12.5e2  ",
+		R"("Escapes: \" \\ \/ \b \f \n \r \t \u00e9 \u4e2d \ud83d\ude00")",
+		String::utf8("\"Raw UTF-8: é 中 😀\""),
+		"\"Multiple\nlines\"",
+		R"([1, [2, [3, [4, []]]], {"a": {"b": {}}}])",
+	};
+
+	for (const String &text : documents) {
+		JSON json;
+		REQUIRE(json.parse(text) == OK);
+		CHECK_MESSAGE(
+				JSON::stringify(_read_value(text)) == JSON::stringify(json.get_data()),
+				"The reader should return the same value as JSON::parse() for: ", text);
+	}
+}
+
+TEST_CASE("[JSONReader] Reporting errors like JSON::parse") {
+	const String documents[] = {
+		"{\"key\" 1}",
+		"[1 2]",
+		"[1, tru]",
+		"{\"a\": 1,\n\n 2}",
+		"[\"abc",
+		"\"\\ud800\"",
+		"\"\\u12g4\"",
+		"[1, 2",
+		"{\"a\": 1",
+		"[] []",
+		"[@]",
+	};
+
+	for (const String &text : documents) {
+		JSON json;
+		REQUIRE(json.parse(text) != OK);
+
+		Ref<JSONReader> reader;
+		reader.instantiate();
+		reader->open_buffer(_to_bytes(text));
+		JSONReader::Token token = reader->read_value();
+		if (token == JSONReader::TOKEN_VALUE) {
+			token = reader->read();
+		}
+		CHECK_MESSAGE(token == JSONReader::TOKEN_ERROR, "Reading should fail for: ", text);
+		CHECK_MESSAGE(reader->get_error_line() == json.get_error_line(), "The error line should match for: ", text);
+		CHECK_MESSAGE(reader->read() == JSONReader::TOKEN_ERROR, "Reading should stop after an error.");
+	}
+
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	reader->open_buffer(_to_bytes("{\"a\": 1,\n\n 2}"));
+	CHECK(reader->read_value() == JSONReader::TOKEN_ERROR);
+	CHECK(reader->get_error_message() == "Expected key");
+	CHECK(reader->get_error_line() == 2);
+}
+
+TEST_CASE("[JSONReader] Reading from a stream") {
+	const String text = R"({"id": 12345, "name": "A string long enough to be split", "escaped": "\u00e9\ud83d\ude00", "values": [0.5, true, false, null]} [1])";
+	const Vector<uint8_t> bytes = _to_bytes(text);
+
+	Ref<StreamPeerBuffer> stream;
+	stream.instantiate();
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	reader->open_stream(stream);
+
+	// Deliver a few bytes at a time, like a network connection would.
+	int delivered = 0;
+	Vector<Variant> values;
+	while (values.size() < 2) {
+		const JSONReader::Token token = reader->read_value();
+		if (token == JSONReader::TOKEN_NEED_DATA) {
+			REQUIRE(delivered < bytes.size());
+			const int position = stream->get_position();
+			delivered = MIN(delivered + 5, bytes.size());
+			stream->set_data_array(bytes.slice(0, delivered));
+			stream->seek(position);
+		} else if (token == JSONReader::TOKEN_VALUE) {
+			values.push_back(reader->get_value());
+		} else {
+			REQUIRE(token == JSONReader::TOKEN_END);
+		}
+	}
+
+	JSON json;
+	REQUIRE(json.parse(text.substr(0, text.rfind(" "))) == OK);
+	CHECK_MESSAGE(
+			JSON::stringify(values[0]) == JSON::stringify(json.get_data()),
+			"Values split across several reads should match JSON::parse().");
+	CHECK_MESSAGE(
+			JSON::stringify(values[1]) == "[1]",
+			"Documents following each other in a stream should be read one by one.");
+	CHECK(reader->read() == JSONReader::TOKEN_END);
+	CHECK(reader->read() == JSONReader::TOKEN_NEED_DATA);
+}
+
+TEST_CASE("[JSONReader] Reading from a file") {
+	// Larger than the chunks the file is read in, so values are split between them.
+	Array records;
+	for (int i = 0; i < 5000; i++) {
+		Dictionary record;
+		record["name"] = vformat("Record \"%d\"", i);
+		record["value"] = i;
+		record["ratio"] = i / 7.0;
+		records.push_back(record);
+	}
+	const String text = JSON::stringify(records, "\t");
+
+	const String path = OS::get_singleton()->get_cache_path().path_join("test_json_reader.json");
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string(text);
+	}
+
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	reader->open_file(FileAccess::open(path, FileAccess::READ));
+	REQUIRE(reader->read_value() == JSONReader::TOKEN_VALUE);
+	const Variant value = reader->get_value();
+	CHECK(reader->read() == JSONReader::TOKEN_END);
+
+	JSON json;
+	REQUIRE(json.parse(text) == OK);
+	CHECK_MESSAGE(
+			JSON::stringify(value) == JSON::stringify(json.get_data()),
+			"Reading from a file should match JSON::parse().");
+}
+
+TEST_CASE("[JSONWriter] Writing like JSON::stringify") {
+	Dictionary inner;
+	inner["zebra"] = 1;
+	inner["apple"] = Array();
+	inner["mango"] = Dictionary();
+	Array array;
+	array.push_back(-42);
+	array.push_back(0.1);
+	array.push_back(1e20);
+	array.push_back(String::utf8("Quotes \" backslashes \\ tabs \t and é 中 😀"));
+	array.push_back(Variant());
+	array.push_back(inner);
+	array.push_back(PackedInt32Array({ 1, 2, 3 }));
+	array.push_back(Vector2(1, 2));
+	Dictionary data;
+	data["list"] = array;
+	data["flag"] = false;
+
+	const String indents[] = { "", "\t", "  " };
+	for (const String &indent : indents) {
+		for (int sort_keys = 0; sort_keys < 2; sort_keys++) {
+			Ref<JSONWriter> writer;
+			writer.instantiate();
+			writer->set_indent(indent);
+			writer->set_sort_keys(sort_keys);
+			writer->open_buffer();
+			writer->write_value(data);
+			CHECK_MESSAGE(
+					String::utf8((const char *)writer->get_data().ptr(), writer->get_data().size()) == JSON::stringify(data, indent, sort_keys),
+					"The writer should produce the same text as JSON::stringify().");
+		}
+	}
+
+	// The same document, written piece by piece.
+	Ref<JSONWriter> writer;
+	writer.instantiate();
+	writer->set_indent("\t");
+	writer->open_buffer();
+	writer->begin_object();
+	writer->write_key("flag");
+	writer->write_value(false);
+	writer->write_key("list");
+	writer->begin_array();
+	for (int i = 0; i < array.size(); i++) {
+		writer->write_value(array[i]);
+	}
+	writer->end_array();
+	writer->end_object();
+	CHECK(writer->get_depth() == 0);
+	CHECK(String::utf8((const char *)writer->get_data().ptr(), writer->get_data().size()) == JSON::stringify(data, "\t"));
+
+	// Control characters are escaped, so the output can be read back.
+	writer->open_buffer();
+	writer->write_value(String("\v\x01"));
+	CHECK(String::utf8((const char *)writer->get_data().ptr(), writer->get_data().size()) == "\"\\u000b\\u0001\"");
+	CHECK(JSON::parse_string("\"\\u000b\\u0001\"") == String("\v\x01"));
+}
+
+TEST_CASE("[JSONWriter] Writing to a stream") {
+	Ref<StreamPeerBuffer> stream;
+	stream.instantiate();
+	Ref<JSONWriter> writer;
+	writer.instantiate();
+	writer->open_stream(stream);
+
+	// More than the flush threshold, so part of it is sent before the end.
+	writer->begin_array();
+	for (int i = 0; i < 20000; i++) {
+		writer->write_value(vformat("Element %d", i));
+	}
+	writer->end_array();
+	CHECK_MESSAGE(stream->get_size() > 0, "Output should be sent as it is written.");
+	writer->write_value(Array());
+	CHECK(writer->flush() == OK);
+
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	stream->seek(0);
+	reader->open_stream(stream);
+	REQUIRE(reader->read_value() == JSONReader::TOKEN_VALUE);
+	const Array array = reader->get_value();
+	CHECK(array.size() == 20000);
+	CHECK(array[19999] == "Element 19999");
+	CHECK(reader->read() == JSONReader::TOKEN_END);
+	REQUIRE(reader->read_value() == JSONReader::TOKEN_VALUE);
+	CHECK(Array(reader->get_value()).is_empty());
+}
+
+// Sums the characters of the strings in `p_var`, and the bytes they would take as UTF-8.
+static void _count_string_memory(const Variant &p_var, int64_t &r_chars, int64_t &r_utf8_bytes) {
+	if (p_var.get_type() == Variant::STRING) {
+		String s = p_var;
+		r_chars += s.length();
+		r_utf8_bytes += s.utf8().length();
+	} else if (p_var.get_type() == Variant::ARRAY) {
+		Array a = p_var;
+		for (int i = 0; i < a.size(); i++) {
+			_count_string_memory(a[i], r_chars, r_utf8_bytes);
+		}
+	} else if (p_var.get_type() == Variant::DICTIONARY) {
+		Dictionary d = p_var;
+		for (int i = 0; i < d.size(); i++) {
+			_count_string_memory(d.get_key_at_index(i), r_chars, r_utf8_bytes);
+			_count_string_memory(d.get_value_at_index(i), r_chars, r_utf8_bytes);
+		}
+	}
+}
+
+TEST_CASE_BENCHMARK("[JSON][Benchmark] Parsing ASCII heavy data") {
+	// Typical save game / level data: mostly ASCII keys, paths and names.
+	Array records;
+	for (int i = 0; i < 20000; i++) {
+		Dictionary record;
+		record["name"] = vformat("Enemy_%d", i);
+		record["scene"] = vformat("res://characters/enemies/goblin_%d/goblin.tscn", i % 50);
+		Array position;
+		position.push_back(i * 0.5);
+		position.push_back(i * 0.25);
+		record["position"] = position;
+		Array tags;
+		tags.push_back("hostile");
+		tags.push_back(vformat("group_%d", i % 10));
+		record["tags"] = tags;
+		record["health"] = 100 - i % 100;
+		records.push_back(record);
+	}
+	const CharString text = JSON::stringify(records).utf8();
+	const int iterations = 10;
+
+	uint64_t decode_usec = 0;
+	uint64_t parse_usec = 0;
+	for (int i = 0; i < iterations; i++) {
+		String string;
+		decode_usec += benchmark_usec([&]() {
+			string.parse_utf8(text.get_data(), text.length());
+		});
+
+		parse_usec += benchmark_usec([&]() {
+			JSON json;
+			CHECK(json.parse(string) == OK);
+		});
+	}
+
+	const double megabytes = double(text.length()) * iterations / (1024 * 1024);
+	MESSAGE(vformat("UTF-8 decoding: %.1f MiB/s, JSON parsing: %.1f MiB/s.",
+			megabytes / MAX(decode_usec, 1u) * 1000000.0, megabytes / MAX(parse_usec, 1u) * 1000000.0));
+
+	JSON json;
+	json.parse(String::utf8(text.get_data(), text.length()));
+	int64_t chars = 0;
+	int64_t utf8_bytes = 0;
+	_count_string_memory(json.get_data(), chars, utf8_bytes);
+	MESSAGE(vformat("Parsed strings: %d characters, %d bytes as UTF-32, %d bytes as UTF-8.", chars, chars * int64_t(sizeof(char32_t)), utf8_bytes));
+}
+
+TEST_CASE_BENCHMARK("[JSON][Benchmark] Streaming reader and writer") {
+	Array records;
+	for (int i = 0; i < 20000; i++) {
+		Dictionary record;
+		record["name"] = vformat("Enemy_%d", i);
+		record["scene"] = vformat("res://characters/enemies/goblin_%d/goblin.tscn", i % 50);
+		Array position;
+		position.push_back(i * 0.5);
+		position.push_back(i * 0.25);
+		record["position"] = position;
+		record["description"] = String::utf8("Un gobelin très rusé, \"dangereux\" la nuit.");
+		record["health"] = 100 - i % 100;
+		records.push_back(record);
+	}
+	const Vector<uint8_t> bytes = _to_bytes(JSON::stringify(records));
+	const int iterations = 10;
+
+	uint64_t parse_usec = 0;
+	uint64_t read_usec = 0;
+	uint64_t stringify_usec = 0;
+	uint64_t write_usec = 0;
+	for (int i = 0; i < iterations; i++) {
+		// The String based API needs the text decoded first, and encoded after.
+		parse_usec += benchmark_usec([&]() {
+			JSON json;
+			CHECK(json.parse(String::utf8((const char *)bytes.ptr(), bytes.size())) == OK);
+		});
+
+		read_usec += benchmark_usec([&]() {
+			Ref<JSONReader> reader;
+			reader.instantiate();
+			reader->open_buffer(bytes);
+			CHECK(reader->read_value() == JSONReader::TOKEN_VALUE);
+		});
+
+		CharString text;
+		stringify_usec += benchmark_usec([&]() {
+			text = JSON::stringify(records).utf8();
+		});
+
+		Ref<JSONWriter> writer;
+		write_usec += benchmark_usec([&]() {
+			writer.instantiate();
+			writer->open_buffer();
+			writer->write_value(records);
+		});
+		CHECK(writer->get_data().size() == text.length());
+	}
+
+	const double megabytes = double(bytes.size()) * iterations / (1024 * 1024);
+	MESSAGE(vformat("Parsing: JSON %.1f MiB/s, JSONReader %.1f MiB/s.",
+			megabytes / MAX(parse_usec, 1u) * 1000000.0, megabytes / MAX(read_usec, 1u) * 1000000.0));
+	MESSAGE(vformat("Writing: JSON %.1f MiB/s, JSONWriter %.1f MiB/s.",
+			megabytes / MAX(stringify_usec, 1u) * 1000000.0, megabytes / MAX(write_usec, 1u) * 1000000.0));
+}
 } // namespace TestJSON
 
 #endif // TEST_JSON_H
@@ -32,6 +32,8 @@
 #define TEST_MARSHALLS_H
 
 #include "core/io/marshalls.h"
+#include "core/os/os.h"
+#include "core/variant/typed_array.h"
 
 #include "tests/test_macros.h"
 
@@ -326,6 +328,309 @@ TEST_CASE("[Marshalls] FLOAT double precision Variant decoding") {
 	CHECK(r_len == 12);
 	CHECK(variant == Variant(0.33333333333333333));
 }
+
+static Vector<uint8_t> _encode_compact(const Variant &p_variant, uint32_t p_flags = 0) {
+	int len;
+	Vector<uint8_t> buffer;
+	CHECK(encode_variant_compact(p_variant, nullptr, len, false, p_flags) == OK);
+	buffer.resize(len);
+	CHECK(encode_variant_compact(p_variant, buffer.ptrw(), len, false, p_flags) == OK);
+	CHECK(len == buffer.size());
+	return buffer;
+}
+
+static Variant _decode_compact(const Vector<uint8_t> &p_buffer) {
+	Variant variant;
+	int r_len = 0;
+	CHECK(decode_variant_compact(variant, p_buffer.ptr(), p_buffer.size(), &r_len) == OK);
+	CHECK(r_len == p_buffer.size());
+	return variant;
+}
+
+TEST_CASE("[Marshalls] Compact Variant encoding") {
+	SUBCASE("INT uses zigzag varints") {
+		Vector<uint8_t> buffer = _encode_compact(300);
+		REQUIRE(buffer.size() == 5);
+		CHECK_MESSAGE(buffer[0] == 0xfe, "Compact encoding marker");
+		CHECK_MESSAGE(buffer[1] == 0x01, "Format version");
+		CHECK_MESSAGE(buffer[2] == 0x02, "Variant::INT");
+		CHECK(buffer[3] == 0xd8);
+		CHECK(buffer[4] == 0x04);
+
+		CHECK(_encode_compact(-1).size() == 4);
+		CHECK(_decode_compact(_encode_compact(INT64_MIN)) == Variant(INT64_MIN));
+		CHECK(_decode_compact(_encode_compact(INT64_MAX)) == Variant(INT64_MAX));
+	}
+
+	SUBCASE("FLOAT uses the smallest exact representation") {
+		Vector<uint8_t> buffer = _encode_compact(0.15625);
+		REQUIRE(buffer.size() == 7);
+		CHECK_MESSAGE(buffer[2] == (0x03 | 1 << 6), "Variant::FLOAT as 32-bit float");
+		CHECK(buffer[5] == 0x20);
+		CHECK(buffer[6] == 0x3e);
+
+		CHECK_MESSAGE(_encode_compact(2.0).size() == 4, "Integral floats are varints.");
+		CHECK(_encode_compact(0.1).size() == 11);
+		CHECK(_decode_compact(_encode_compact(0.1)) == Variant(0.1));
+		CHECK(_decode_compact(_encode_compact(-3.0)) == Variant(-3.0));
+		const double negative_zero = _decode_compact(_encode_compact(-0.0));
+		CHECK(std::signbit(negative_zero));
+	}
+
+	SUBCASE("Round trip") {
+		Dictionary dictionary;
+		dictionary["name"] = "Godot";
+		dictionary[StringName("id")] = 42;
+		dictionary[Vector2i(1, -2)] = Array();
+
+		Array values;
+		values.push_back(Variant());
+		values.push_back(true);
+		values.push_back(false);
+		values.push_back(-123456789);
+		values.push_back(1.0e300);
+		values.push_back(String());
+		values.push_back(String::utf8("Unicode: Ŧ€ṧ✝"));
+		values.push_back(StringName("a_name"));
+		values.push_back(Vector2(1.5, -2.25));
+		values.push_back(Vector2i(-7, 8));
+		values.push_back(Rect2(1, 2, 3, 4));
+		values.push_back(Rect2i(-1, -2, 3, 4));
+		values.push_back(Vector3(1, 2, 3));
+		values.push_back(Vector3i(1, 2, -3));
+		values.push_back(Transform2D(0.5, Vector2(3, 4)));
+		values.push_back(Vector4(1, 2, 3, 4));
+		values.push_back(Vector4i(1, 2, 3, -4));
+		values.push_back(Plane(Vector3(0, 1, 0), 2));
+		values.push_back(Quaternion(0, 0, 0.6, 0.8));
+		values.push_back(AABB(Vector3(1, 2, 3), Vector3(4, 5, 6)));
+		values.push_back(Basis(Vector3(0, 1, 0), 0.5));
+		values.push_back(Transform3D(Basis(Vector3(1, 0, 0), 0.25), Vector3(7, 8, 9)));
+		values.push_back(Projection::create_perspective(60, 1.5, 0.05, 100));
+		values.push_back(Color(0.25, 0.5, 0.75, 1));
+		values.push_back(NodePath("../node:property"));
+		values.push_back(dictionary);
+		values.push_back(PackedByteArray({ 0, 1, 255 }));
+		values.push_back(PackedInt32Array({ -1, 0, INT32_MAX }));
+		values.push_back(PackedInt64Array({ INT64_MIN, 1 }));
+		values.push_back(PackedFloat32Array({ 0.1f, -2.5f }));
+		values.push_back(PackedFloat64Array({ 0.1, 1.0e-300 }));
+		values.push_back(PackedStringArray({ "a", "b", "a" }));
+		values.push_back(PackedVector2Array({ Vector2(0.1, 0.2) }));
+		values.push_back(PackedVector3Array({ Vector3(0.1, 0.2, 0.3) }));
+		values.push_back(PackedColorArray({ Color(0.1, 0.2, 0.3, 0.4) }));
+
+		for (int i = 0; i < values.size(); i++) {
+			const Variant decoded = _decode_compact(_encode_compact(values[i]));
+			CHECK_MESSAGE(decoded.get_type() == values[i].get_type(), vformat("Type of value %d should be kept.", i));
+			CHECK_MESSAGE(decoded == values[i], vformat("Value %d should be kept.", i));
+		}
+		CHECK(_decode_compact(_encode_compact(values)) == Variant(values));
+		CHECK(_decode_compact(_encode_compact(StringName("name"))).get_type() == Variant::STRING_NAME);
+	}
+
+	SUBCASE("Strings are only stored once") {
+		Array records;
+		for (int i = 0; i < 100; i++) {
+			Dictionary record;
+			record["position"] = Vector2i(i, i * 2);
+			record["health"] = 100 - i;
+			record["name"] = "enemy";
+			records.push_back(record);
+		}
+
+		int legacy_len;
+		CHECK(encode_variant(records, nullptr, legacy_len) == OK);
+		const Vector<uint8_t> buffer = _encode_compact(records);
+		CHECK_MESSAGE(buffer.size() * 3 < legacy_len, "The compact encoding should be much smaller for repeated keys.");
+		CHECK(_decode_compact(buffer) == Variant(records));
+
+		// Long strings are never referenced.
+		const String long_string = String("x").repeat(200);
+		Array repeated;
+		repeated.push_back(long_string);
+		repeated.push_back(long_string);
+		CHECK(_encode_compact(repeated).size() > 400);
+		CHECK(_decode_compact(_encode_compact(repeated)) == Variant(repeated));
+	}
+
+	SUBCASE("Typed arrays keep their type") {
+		TypedArray<int> ints;
+		ints.push_back(1);
+		ints.push_back(-1000);
+		TypedArray<float> floats;
+		floats.push_back(1.0);
+		floats.push_back(0.5);
+		floats.push_back(1099511627777.0); // Integral, but not exact as a 32-bit float.
+		TypedArray<String> strings;
+		strings.push_back("a");
+		strings.push_back("a");
+		TypedArray<Vector3> vectors;
+		vectors.push_back(Vector3(1, 2, 3));
+		TypedArray<Dictionary> dictionaries;
+		dictionaries.push_back(Dictionary());
+
+		const Array arrays[] = { ints, floats, strings, vectors, dictionaries };
+		for (const Array &array : arrays) {
+			const Array decoded = _decode_compact(_encode_compact(array));
+			CHECK(decoded.is_typed());
+			CHECK(decoded.get_typed_builtin() == array.get_typed_builtin());
+			CHECK(decoded == array);
+		}
+		CHECK_MESSAGE(_encode_compact(ints).size() == 2 + 1 + 1 + 1 + 1 + 1 + 2, "Elements of typed integer arrays don't have tags.");
+	}
+
+	SUBCASE("Lossy packed array flags") {
+		PackedFloat32Array data;
+		for (int i = 0; i < 64; i++) {
+			data.push_back(i * 0.37f - 10.0f);
+		}
+		const Vector<uint8_t> half = _encode_compact(data, ENCODE_COMPACT_HALF_FLOATS);
+		CHECK(half.size() < int(data.size() * sizeof(float)) / 2 + 8);
+		const PackedFloat32Array decoded = _decode_compact(half);
+		REQUIRE(decoded.size() == data.size());
+		for (int i = 0; i < data.size(); i++) {
+			CHECK(decoded[i] == doctest::Approx(data[i]).epsilon(0.002));
+		}
+
+		const PackedFloat64Array doubles({ 0.1, 1234.5678 });
+		CHECK(_encode_compact(doubles, ENCODE_COMPACT_FLOAT32).size() == _encode_compact(doubles).size() - 2 * 4);
+		const PackedFloat64Array narrowed = _decode_compact(_encode_compact(doubles, ENCODE_COMPACT_FLOAT32));
+		CHECK(narrowed[0] == double(0.1f));
+		CHECK(narrowed[1] == double(1234.5678f));
+
+		const PackedVector3Array vectors({ Vector3(1.25, -0.5, 100) });
+		CHECK(_decode_compact(_encode_compact(vectors, ENCODE_COMPACT_HALF_FLOATS)) == Variant(vectors));
+	}
+
+	SUBCASE("decode_variant() detects the compact encoding") {
+		Dictionary dictionary;
+		dictionary["key"] = PackedStringArray({ "value" });
+		const Vector<uint8_t> buffer = _encode_compact(dictionary);
+
+		Variant variant;
+		int r_len = 0;
+		CHECK(decode_variant(variant, buffer.ptr(), buffer.size(), &r_len) == OK);
+		CHECK(r_len == buffer.size());
+		CHECK(variant == Variant(dictionary));
+	}
+
+	SUBCASE("The body has no header") {
+		Dictionary dictionary;
+		dictionary["key"] = PackedStringArray({ "value" });
+		const Vector<uint8_t> buffer = _encode_compact(dictionary);
+
+		int len;
+		CHECK(encode_variant_compact_body(dictionary, nullptr, len) == OK);
+		REQUIRE(len == buffer.size() - 2);
+		Vector<uint8_t> body;
+		body.resize(len);
+		CHECK(encode_variant_compact_body(dictionary, body.ptrw(), len) == OK);
+		CHECK(memcmp(body.ptr(), buffer.ptr() + 2, len) == 0);
+
+		Variant variant;
+		int r_len = 0;
+		CHECK(decode_variant_compact_body(variant, body.ptr(), body.size(), &r_len) == OK);
+		CHECK(r_len == body.size());
+		CHECK(variant == Variant(dictionary));
+	}
+}
+
+TEST_CASE("[Marshalls] Invalid compact Variant decoding") {
+	Dictionary dictionary;
+	dictionary["key"] = "value";
+	Array list;
+	list.push_back(1);
+	list.push_back(2.5);
+	list.push_back("three");
+	list.push_back(NodePath("four"));
+	dictionary["list"] = list;
+	int len;
+	CHECK(encode_variant_compact(dictionary, nullptr, len) == OK);
+	Vector<uint8_t> buffer;
+	buffer.resize(len);
+	CHECK(encode_variant_compact(dictionary, buffer.ptrw(), len) == OK);
+
+	Variant variant;
+	int r_len = 0;
+	ERR_PRINT_OFF;
+	for (int i = 0; i < buffer.size(); i++) {
+		CHECK_MESSAGE(decode_variant_compact(variant, buffer.ptr(), i, &r_len) == ERR_INVALID_DATA, vformat("Truncated to %d bytes.", i));
+	}
+	CHECK(r_len == 0);
+
+	const uint8_t unsupported_version[] = { 0xfe, 0x02, 0x00 };
+	CHECK(decode_variant_compact(variant, unsupported_version, 3, &r_len) == ERR_INVALID_DATA);
+
+	const uint8_t invalid_type[] = { 0xfe, 0x01, 0x3f };
+	CHECK(decode_variant_compact(variant, invalid_type, 3, &r_len) == ERR_INVALID_DATA);
+
+	const uint8_t huge_count[] = { 0xfe, 0x01, Variant::PACKED_INT64_ARRAY, 0xff, 0xff, 0xff, 0xff, 0x0f };
+	CHECK(decode_variant_compact(variant, huge_count, 8, &r_len) == ERR_INVALID_DATA);
+
+	const uint8_t overlong_varint[] = { 0xfe, 0x01, Variant::INT, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01 };
+	CHECK(decode_variant_compact(variant, overlong_varint, 14, &r_len) == ERR_INVALID_DATA);
+
+	const uint8_t invalid_string_reference[] = { 0xfe, 0x01, Variant::STRING, 0x03 };
+	CHECK(decode_variant_compact(variant, invalid_string_reference, 4, &r_len) == ERR_INVALID_DATA);
+
+	const uint8_t untyped_typed_array[] = { 0xfe, 0x01, Variant::ARRAY | 1 << 6, Variant::NIL, 0x00, 0x00 };
+	CHECK(decode_variant_compact(variant, untyped_typed_array, 6, &r_len) == ERR_INVALID_DATA);
+	ERR_PRINT_ON;
+	CHECK(r_len == 0);
+}
+
+TEST_CASE_BENCHMARK("[Marshalls][Benchmark] Compact Variant encoding") {
+	Array records;
+	for (int i = 0; i < 10000; i++) {
+		Dictionary record;
+		record["id"] = i;
+		record["name"] = vformat("entity_%d", i % 100);
+		record["position"] = Vector3(i, i * 0.5, -i);
+		record["tags"] = PackedStringArray({ "enemy", "flying" });
+		records.push_back(record);
+	}
+	const int iterations = 20;
+
+	int legacy_len;
+	encode_variant(records, nullptr, legacy_len);
+	Vector<uint8_t> legacy;
+	legacy.resize(legacy_len);
+	const uint64_t legacy_encode_usec = benchmark_usec([&]() {
+		for (int i = 0; i < iterations; i++) {
+			encode_variant(records, nullptr, legacy_len);
+			encode_variant(records, legacy.ptrw(), legacy_len);
+		}
+	});
+
+	int compact_len;
+	encode_variant_compact(records, nullptr, compact_len);
+	Vector<uint8_t> compact;
+	compact.resize(compact_len);
+	const uint64_t compact_encode_usec = benchmark_usec([&]() {
+		for (int i = 0; i < iterations; i++) {
+			encode_variant_compact(records, nullptr, compact_len);
+			encode_variant_compact(records, compact.ptrw(), compact_len);
+		}
+	});
+
+	Variant decoded;
+	const uint64_t legacy_decode_usec = benchmark_usec([&]() {
+		for (int i = 0; i < iterations; i++) {
+			decode_variant(decoded, legacy.ptr(), legacy.size());
+		}
+	});
+
+	const uint64_t compact_decode_usec = benchmark_usec([&]() {
+		for (int i = 0; i < iterations; i++) {
+			decode_variant_compact(decoded, compact.ptr(), compact.size());
+		}
+	});
+
+	MESSAGE(vformat("Legacy encoding: %d bytes, encoded in %d usec, decoded in %d usec.", legacy_len, int64_t(legacy_encode_usec / iterations), int64_t(legacy_decode_usec / iterations)));
+	MESSAGE(vformat("Compact encoding: %d bytes, encoded in %d usec, decoded in %d usec.", compact_len, int64_t(compact_encode_usec / iterations), int64_t(compact_decode_usec / iterations)));
+}
+
 } // namespace TestMarshalls
 
 #endif // TEST_MARSHALLS_H
@@ -31,6 +31,7 @@
 #ifndef TEST_PCK_PACKER_H
 #define TEST_PCK_PACKER_H
 
+#include "core/io/dir_access.h"
 #include "core/io/file_access_pack.h"
 #include "core/io/pck_packer.h"
 #include "core/os/os.h"
@@ -117,6 +118,101 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 35000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Pack index lookup") {
+	const String paths[] = { "res://a.txt", "res://dir/b.txt", "res://dir/sub/c.txt", String::utf8("res://dir/ü.txt"), "res://a.txt" };
+	Vector<PackIndex::FileInfo> files;
+	for (int i = 0; i < 5; i++) {
+		PackIndex::FileInfo fi;
+		fi.path = paths[i];
+		fi.offset = i * 100;
+		fi.size = i + 1;
+		fi.flags = i == 2 ? PACK_FILE_COMPRESSED : 0;
+		files.push_back(fi);
+	}
+
+	Vector<uint8_t> data = PackIndex::build(files);
+	REQUIRE(!data.is_empty());
+	PackIndex index;
+	REQUIRE(index.init_owned(data) == OK);
+	index.files_base = 1000;
+
+	PackedData::PackedFile pf;
+	for (int i = 1; i < 5; i++) {
+		int64_t file = index.find_file(paths[i]);
+		REQUIRE_MESSAGE(file != -1, "Every file should be found.");
+		index.get_file(file, pf);
+		CHECK(pf.offset == 1000 + (uint64_t)i * 100);
+		CHECK(pf.size == (uint64_t)i + 1);
+		CHECK(pf.compressed == (i == 2));
+	}
+	index.get_file(index.find_file("res://a.txt"), pf);
+	CHECK_MESSAGE(pf.offset == 1400, "Files added again should replace the previous ones.");
+	CHECK(index.find_file("res://b.txt") == -1);
+	CHECK(index.find_file("res://dir/sub") == -1);
+
+	CHECK(index.find_dir("") == 0);
+	CHECK(index.find_dir("dir/sub") != -1);
+	CHECK(index.find_dir("sub") == -1);
+	int64_t dir = index.find_dir("dir");
+	REQUIRE(dir != -1);
+	CHECK(index.dir_has_file(dir, "b.txt"));
+	CHECK(index.dir_has_file(dir, String::utf8("ü.txt")));
+	CHECK(!index.dir_has_file(dir, "c.txt"));
+
+	List<String> dirs;
+	List<String> dir_files;
+	index.get_dir_contents(dir, &dirs, &dir_files);
+	CHECK(dirs.size() == 1);
+	CHECK(dirs.front()->get() == "sub");
+	CHECK(dir_files.size() == 2);
+}
+
+TEST_CASE("[PCKPacker] Compressed files can be read back through PackedData") {
+	const String source_dir = OS::get_singleton()->get_cache_path().path_join("pck_packer_round_trip");
+	REQUIRE(DirAccess::make_dir_recursive_absolute(source_dir) == OK);
+
+	// Text compresses well. It spans several compression blocks, and both files share a header
+	// for the dictionary to pick up. Random bytes don't compress, so they are stored as is.
+	String text;
+	for (int i = 0; i < 8000; i++) {
+		text += vformat("[node name=\"Node%d\" type=\"Node3D\" parent=\".\"]\n", i);
+	}
+	Vector<uint8_t> random_data;
+	random_data.resize(4096);
+	for (int i = 0; i < random_data.size(); i++) {
+		random_data.write[i] = Math::rand() % 256;
+	}
+	const String sources[] = { "scene.tscn", "other_scene.tscn", "random.bin" };
+	Vector<uint8_t> contents[3];
+	contents[0] = text.to_utf8_buffer();
+	contents[1] = text.substr(0, 2000).to_utf8_buffer();
+	contents[2] = random_data;
+	for (int i = 0; i < 3; i++) {
+		Ref<FileAccess> f = FileAccess::open(source_dir.path_join(sources[i]), FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_buffer(contents[i].ptr(), contents[i].size());
+	}
+
+	for (int use_dictionary = 0; use_dictionary < 2; use_dictionary++) {
+		const String pack_dir = vformat("res://pck_packer_round_trip_%d", use_dictionary);
+		const String output_pck_path = source_dir.path_join(vformat("round_trip_%d.pck", use_dictionary));
+
+		PCKPacker pck_packer;
+		pck_packer.set_use_compression_dictionary(use_dictionary);
+		REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+		for (int i = 0; i < 3; i++) {
+			REQUIRE(pck_packer.add_file(pack_dir.path_join(sources[i]), source_dir.path_join(sources[i]), false, true) == OK);
+		}
+		REQUIRE(pck_packer.flush() == OK);
+
+		REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+		for (int i = 0; i < 3; i++) {
+			Vector<uint8_t> data = FileAccess::get_file_as_bytes(pack_dir.path_join(sources[i]));
+			CHECK_MESSAGE(data == contents[i], vformat("%s should read back unchanged (dictionary: %d).", sources[i], use_dictionary));
+		}
+	}
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
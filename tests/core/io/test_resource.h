@@ -34,6 +34,7 @@
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
 #include "thirdparty/doctest/doctest.h"
@@ -109,6 +110,169 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+TEST_CASE("[Resource] Loading binary resources with large sub-resources") {
+	// Big enough for the sub-resources to be decoded on separate threads.
+	const int count = 20000;
+	Ref<Resource> shared_resource = memnew(Resource);
+	shared_resource->set_name("I'm shared");
+
+	Ref<Resource> resource = memnew(Resource);
+	for (int i = 0; i < 4; i++) {
+		Ref<Resource> child_resource = memnew(Resource);
+		child_resource->set_name(vformat("Child %d", i));
+		PackedVector3Array points;
+		points.resize(count);
+		for (int j = 0; j < count; j++) {
+			points.set(j, Vector3(i, j, -j));
+		}
+		child_resource->set_meta("points", points);
+		child_resource->set_meta("shared", shared_resource);
+		resource->set_meta(vformat("child_%d", i), child_resource);
+	}
+	const String save_path = OS::get_singleton()->get_cache_path().path_join("resource_large.res");
+	CHECK(ResourceSaver::save(resource, save_path) == OK);
+
+	Ref<Resource> loaded_resource = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded_resource.is_valid());
+	Ref<Resource> loaded_shared_resource;
+	for (int i = 0; i < 4; i++) {
+		Ref<Resource> loaded_child_resource = loaded_resource->get_meta(vformat("child_%d", i));
+		REQUIRE(loaded_child_resource.is_valid());
+		CHECK(loaded_child_resource->get_name() == vformat("Child %d", i));
+
+		PackedVector3Array points = loaded_child_resource->get_meta("points");
+		REQUIRE(points.size() == count);
+		CHECK(points[0] == Vector3(i, 0, 0));
+		CHECK(points[count - 1] == Vector3(i, count - 1, -(count - 1)));
+
+		Ref<Resource> shared = loaded_child_resource->get_meta("shared");
+		REQUIRE(shared.is_valid());
+		CHECK(shared->get_name() == "I'm shared");
+		if (loaded_shared_resource.is_null()) {
+			loaded_shared_resource = shared;
+		}
+		CHECK_MESSAGE(
+				shared == loaded_shared_resource,
+				"Sub-resources decoded on different threads should still share the same instances.");
+	}
+}
+
+TEST_CASE("[Resource] Threaded loading") {
+	const String save_path_child = OS::get_singleton()->get_cache_path().path_join("resource_threaded_child.tres");
+	const String save_path_parent = OS::get_singleton()->get_cache_path().path_join("resource_threaded_parent.tres");
+	{
+		// Save the child on its own, so it's an external dependency of the parent.
+		Ref<Resource> child_resource = memnew(Resource);
+		child_resource->set_name("I'm an external resource");
+		ResourceSaver::save(child_resource, save_path_child);
+		child_resource->set_path(save_path_child);
+
+		Ref<Resource> resource = memnew(Resource);
+		resource->set_name("Hello world");
+		resource->set_meta("other_resource", child_resource);
+		ResourceSaver::save(resource, save_path_parent);
+	}
+
+	SUBCASE("Background load") {
+		CHECK(ResourceLoader::load_threaded_request(save_path_parent) == OK);
+		float progress = -1.0;
+		ResourceLoader::ThreadLoadStatus status = ResourceLoader::load_threaded_get_status(save_path_parent, &progress);
+		CHECK(status != ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+		CHECK(status != ResourceLoader::THREAD_LOAD_FAILED);
+		CHECK(progress >= 0.0);
+		CHECK(progress <= 1.0);
+
+		Error err = FAILED;
+		Ref<Resource> loaded_resource = ResourceLoader::load_threaded_get(save_path_parent, &err);
+		CHECK(err == OK);
+		REQUIRE(loaded_resource.is_valid());
+		CHECK(loaded_resource->get_name() == "Hello world");
+		Ref<Resource> loaded_child_resource = loaded_resource->get_meta("other_resource");
+		REQUIRE(loaded_child_resource.is_valid());
+		CHECK(loaded_child_resource->get_name() == "I'm an external resource");
+
+		CHECK_MESSAGE(
+				ResourceLoader::load_threaded_get_status(save_path_parent) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE,
+				"The load task should be released once the resource was retrieved.");
+	}
+
+	SUBCASE("High priority load with dependencies on sub-tasks") {
+		// Request it twice, so the load task is kept after the first get.
+		CHECK(ResourceLoader::load_threaded_request(save_path_parent, "", true, ResourceFormatLoader::CACHE_MODE_REUSE, true) == OK);
+		CHECK(ResourceLoader::load_threaded_request(save_path_parent, "", true, ResourceFormatLoader::CACHE_MODE_REUSE, true) == OK);
+
+		Ref<Resource> loaded_resource = ResourceLoader::load_threaded_get(save_path_parent);
+		REQUIRE(loaded_resource.is_valid());
+		Ref<Resource> loaded_child_resource = loaded_resource->get_meta("other_resource");
+		REQUIRE(loaded_child_resource.is_valid());
+		CHECK(loaded_child_resource->get_name() == "I'm an external resource");
+
+		float progress = 0.0;
+		CHECK(ResourceLoader::load_threaded_get_status(save_path_parent, &progress) == ResourceLoader::THREAD_LOAD_LOADED);
+		CHECK(progress == doctest::Approx(1.0));
+		CHECK(ResourceLoader::load_threaded_get(save_path_parent) == loaded_resource);
+	}
+}
+
+TEST_CASE("[Resource] Threaded loading of a shared dependency on a small pool") {
+	const String save_path_shared = OS::get_singleton()->get_cache_path().path_join("resource_threaded_shared.tres");
+	const String save_paths[2] = {
+		OS::get_singleton()->get_cache_path().path_join("resource_threaded_user_a.tres"),
+		OS::get_singleton()->get_cache_path().path_join("resource_threaded_user_b.tres"),
+	};
+	{
+		Ref<Resource> shared_resource = memnew(Resource);
+		shared_resource->set_name("I'm a shared resource");
+		ResourceSaver::save(shared_resource, save_path_shared);
+		shared_resource->set_path(save_path_shared);
+
+		for (int i = 0; i < 2; i++) {
+			Ref<Resource> resource = memnew(Resource);
+			resource->set_meta("other_resource", shared_resource);
+			ResourceSaver::save(resource, save_paths[i]);
+		}
+	}
+
+	// With one or two pool threads, a thread running one of the loads waits for the dependency
+	// the other load requested too, while nothing else is left to load it.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	for (int thread_count = 1; thread_count <= 2; thread_count++) {
+		pool->finish();
+		pool->init(thread_count);
+
+		for (int i = 0; i < 2; i++) {
+			CHECK(ResourceLoader::load_threaded_request(save_paths[i], "", true) == OK);
+		}
+
+		// Leave the loads to the pool, load_threaded_get() would run them on this thread otherwise.
+		const uint64_t timeout_msec = OS::get_singleton()->get_ticks_msec() + 10000;
+		bool loading = true;
+		while (loading && OS::get_singleton()->get_ticks_msec() < timeout_msec) {
+			loading = ResourceLoader::load_threaded_get_status(save_paths[0]) == ResourceLoader::THREAD_LOAD_IN_PROGRESS ||
+					ResourceLoader::load_threaded_get_status(save_paths[1]) == ResourceLoader::THREAD_LOAD_IN_PROGRESS;
+			OS::get_singleton()->delay_usec(1000);
+		}
+		REQUIRE_MESSAGE(!loading, vformat("Both loads should finish on a pool of %d thread(s).", thread_count));
+
+		Ref<Resource> loaded_resources[2];
+		for (int i = 0; i < 2; i++) {
+			Error err = FAILED;
+			loaded_resources[i] = ResourceLoader::load_threaded_get(save_paths[i], &err);
+			CHECK(err == OK);
+			REQUIRE(loaded_resources[i].is_valid());
+		}
+		Ref<Resource> shared_resource = loaded_resources[0]->get_meta("other_resource");
+		REQUIRE(shared_resource.is_valid());
+		CHECK(shared_resource->get_name() == "I'm a shared resource");
+		CHECK_MESSAGE(
+				loaded_resources[1]->get_meta("other_resource") == Variant(shared_resource),
+				"Both loads should get the same instance of the shared dependency.");
+	}
+
+	pool->finish();
+	pool->init();
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE_H
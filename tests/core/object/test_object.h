@@ -35,6 +35,8 @@
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 
 #include "tests/test_macros.h"
 
@@ -359,6 +361,233 @@ TEST_CASE("[Object] Signals") {
 	}
 }
 
+TEST_CASE("[Object] ObjectDB lookups") {
+	Object *object = memnew(Object);
+	const ObjectID id = object->get_instance_id();
+	CHECK(ObjectDB::get_instance(id) == object);
+
+	memdelete(object);
+	CHECK_MESSAGE(ObjectDB::get_instance(id) == nullptr, "A freed object should not be found anymore.");
+
+	// The freed slot is reused, but the old ID must not resolve to the new object.
+	Object *reused = memnew(Object);
+	CHECK(ObjectDB::get_instance(id) == nullptr);
+	CHECK(ObjectDB::get_instance(reused->get_instance_id()) == reused);
+	memdelete(reused);
+}
+
+struct ObjectDBLookups {
+	static const int OBJECT_COUNT = 256;
+
+	Vector<Object *> objects;
+	Vector<ObjectID> ids;
+	int iterations = 0;
+	SafeFlag stop;
+	SafeNumeric<uint32_t> mismatches;
+
+	static void lookup_thread(void *p_userdata) {
+		ObjectDBLookups *self = (ObjectDBLookups *)p_userdata;
+		for (int i = 0; i < self->iterations; i++) {
+			for (int j = 0; j < OBJECT_COUNT; j++) {
+				if (ObjectDB::get_instance(self->ids[j]) != self->objects[j]) {
+					self->mismatches.increment();
+				}
+			}
+		}
+	}
+
+	static void churn_thread(void *p_userdata) {
+		ObjectDBLookups *self = (ObjectDBLookups *)p_userdata;
+		while (!self->stop.is_set()) {
+			Object *object = memnew(Object);
+			const ObjectID id = object->get_instance_id();
+			if (ObjectDB::get_instance(id) != object) {
+				self->mismatches.increment();
+			}
+			memdelete(object);
+			if (ObjectDB::get_instance(id) != nullptr) {
+				self->mismatches.increment();
+			}
+		}
+	}
+
+	void create_objects() {
+		for (int i = 0; i < OBJECT_COUNT; i++) {
+			Object *object = memnew(Object);
+			objects.push_back(object);
+			ids.push_back(object->get_instance_id());
+		}
+	}
+
+	void delete_objects() {
+		for (Object *object : objects) {
+			memdelete(object);
+		}
+	}
+
+	// Looks objects up from several threads while another one adds and removes instances.
+	uint64_t run(int p_thread_count) {
+		stop.clear();
+		Thread churn;
+		churn.start(churn_thread, this);
+
+		uint64_t usec = benchmark_usec([&]() {
+			Vector<Thread *> threads;
+			for (int i = 0; i < p_thread_count; i++) {
+				Thread *thread = memnew(Thread);
+				thread->start(lookup_thread, this);
+				threads.push_back(thread);
+			}
+			for (Thread *thread : threads) {
+				thread->wait_to_finish();
+				memdelete(thread);
+			}
+		});
+		usec = MAX(usec, (uint64_t)1);
+
+		stop.set();
+		churn.wait_to_finish();
+		return usec;
+	}
+};
+
+TEST_CASE("[Object] Concurrent ObjectDB lookups") {
+	ObjectDBLookups lookups;
+	lookups.iterations = 1000;
+	lookups.create_objects();
+	lookups.run(4);
+	lookups.delete_objects();
+
+	CHECK_MESSAGE(lookups.mismatches.get() == 0, "Lookups should only return the object an ID was given to.");
+}
+
+TEST_CASE_BENCHMARK("[Object][Benchmark] Concurrent ObjectDB lookups") {
+	ObjectDBLookups lookups;
+	lookups.iterations = 20000;
+	lookups.create_objects();
+
+	const int max_threads = OS::get_singleton()->get_processor_count();
+	for (int thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+		uint64_t usec = lookups.run(thread_count);
+		uint64_t count = uint64_t(thread_count) * lookups.iterations * ObjectDBLookups::OBJECT_COUNT;
+		MESSAGE(vformat("%d threads: %d lookups in %d usec (%d lookups/s).", thread_count, count, usec, count * 1000000 / usec));
+	}
+
+	lookups.delete_objects();
+	CHECK(lookups.mismatches.get() == 0);
+}
+
+class SignalReceiver : public Object {
+public:
+	int calls = 0;
+
+	// Changes connections of `emitter` from the callback when set.
+	Object *emitter = nullptr;
+	Callable to_disconnect;
+	Callable to_connect;
+
+	void on_value(const Variant &p_value) {
+		calls++;
+	}
+
+	void on_signal() {
+		calls++;
+		if (to_disconnect.is_valid()) {
+			emitter->disconnect("hit", to_disconnect);
+			to_disconnect = Callable();
+		}
+		if (to_connect.is_valid()) {
+			emitter->connect("hit", to_connect);
+			to_connect = Callable();
+		}
+	}
+};
+
+TEST_CASE("[Object] Signal emission") {
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("hit"));
+
+	SignalReceiver a;
+	SignalReceiver b;
+	SignalReceiver c;
+	emitter.connect("hit", callable_mp(&a, &SignalReceiver::on_signal));
+	emitter.connect("hit", callable_mp(&b, &SignalReceiver::on_signal));
+	emitter.emit_signal("hit");
+	CHECK(a.calls == 1);
+	CHECK(b.calls == 1);
+
+	SUBCASE("One shot connections are disconnected after the first emission") {
+		emitter.connect("hit", callable_mp(&c, &SignalReceiver::on_signal), Object::CONNECT_ONE_SHOT);
+		emitter.emit_signal("hit");
+		emitter.emit_signal("hit");
+		CHECK(a.calls == 3);
+		CHECK(c.calls == 1);
+		CHECK_FALSE(emitter.is_connected("hit", callable_mp(&c, &SignalReceiver::on_signal)));
+	}
+
+	SUBCASE("Connection changes during an emission apply to the next one") {
+		a.emitter = &emitter;
+		a.to_disconnect = callable_mp(&b, &SignalReceiver::on_signal);
+		a.to_connect = callable_mp(&c, &SignalReceiver::on_signal);
+
+		emitter.emit_signal("hit");
+		CHECK(a.calls == 2);
+		CHECK(b.calls == 2);
+		CHECK(c.calls == 0);
+
+		emitter.emit_signal("hit");
+		CHECK(a.calls == 3);
+		CHECK(b.calls == 2);
+		CHECK(c.calls == 1);
+	}
+
+	SUBCASE("Disconnecting releases the callable and its binds right away") {
+		Ref<RefCounted> bound;
+		bound.instantiate();
+		emitter.connect("hit", callable_mp(&c, &SignalReceiver::on_value).bind(bound));
+		emitter.emit_signal("hit");
+		CHECK(c.calls == 1);
+		CHECK(bound->get_reference_count() == 2);
+
+		emitter.disconnect("hit", callable_mp(&c, &SignalReceiver::on_value));
+		CHECK_MESSAGE(bound->get_reference_count() == 1, "The emission cache shouldn't keep disconnected callables alive.");
+	}
+
+	SUBCASE("Method callables") {
+		Object target;
+		emitter.add_user_signal(MethodInfo("named", PropertyInfo(Variant::STRING_NAME, "name"), PropertyInfo(Variant::INT, "value")));
+		emitter.connect("named", Callable(&target, "set_meta"));
+		emitter.emit_signal("named", StringName("hits"), 5);
+		CHECK(int(target.get_meta("hits")) == 5);
+	}
+}
+
+TEST_CASE_BENCHMARK("[Object][Benchmark] Signal emission") {
+	const StringName hit = "hit";
+	const int emissions = 1000000;
+	const int connection_counts[] = { 1, 4, 16 };
+
+	for (int connection_count : connection_counts) {
+		Object emitter;
+		emitter.add_user_signal(MethodInfo(hit));
+
+		SignalReceiver receivers[16];
+		for (int i = 0; i < connection_count; i++) {
+			emitter.connect(hit, callable_mp(&receivers[i], &SignalReceiver::on_signal));
+		}
+
+		uint64_t usec = benchmark_usec([&]() {
+			for (int i = 0; i < emissions; i++) {
+				emitter.emit_signal(hit);
+			}
+		});
+		usec = MAX(usec, (uint64_t)1);
+
+		MESSAGE(vformat("%d connections: %d emissions in %d usec (%d emissions/s).", connection_count, emissions, usec, uint64_t(emissions) * 1000000 / usec));
+		CHECK(receivers[0].calls == emissions);
+	}
+}
+
 } // namespace TestObject
 
 #endif // TEST_OBJECT_H
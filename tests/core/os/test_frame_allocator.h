@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*  test_frame_allocator.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FRAME_ALLOCATOR_H
+#define TEST_FRAME_ALLOCATOR_H
+
+#include "core/os/frame_allocator.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameAllocator {
+
+TEST_CASE("[FrameAllocator] Allocation and release") {
+	REQUIRE(FrameAllocator::get_live_allocations() == 0);
+
+	uint8_t *a = (uint8_t *)FrameAllocator::alloc(10);
+	uint8_t *b = (uint8_t *)FrameAllocator::alloc(100);
+	CHECK(((uintptr_t)a & 15) == 0);
+	CHECK(((uintptr_t)b & 15) == 0);
+	CHECK(b >= a + 10);
+	CHECK(FrameAllocator::get_live_allocations() == 2);
+	memset(a, 1, 10);
+	memset(b, 2, 100);
+
+	size_t used = FrameAllocator::get_used();
+	FrameAllocator::free(b);
+	CHECK_MESSAGE(FrameAllocator::get_used() < used, "Freeing the last allocation should rewind the arena.");
+	CHECK(a[9] == 1);
+
+	FrameAllocator::free(a);
+	CHECK(FrameAllocator::get_live_allocations() == 0);
+	CHECK_MESSAGE(FrameAllocator::get_used() == 0, "The arena should start over once everything is freed.");
+}
+
+TEST_CASE("[FrameAllocator] Reallocation") {
+	uint8_t *a = (uint8_t *)FrameAllocator::alloc(16);
+	for (int i = 0; i < 16; i++) {
+		a[i] = i;
+	}
+	uint8_t *grown = (uint8_t *)FrameAllocator::realloc(a, 64);
+	CHECK_MESSAGE(grown == a, "The last allocation should grow in place.");
+
+	uint8_t *b = (uint8_t *)FrameAllocator::alloc(16);
+	uint8_t *moved = (uint8_t *)FrameAllocator::realloc(a, 256);
+	CHECK(moved != a);
+	bool copied = true;
+	for (int i = 0; i < 16; i++) {
+		copied = copied && moved[i] == i;
+	}
+	CHECK(copied);
+	CHECK(FrameAllocator::get_live_allocations() == 2);
+
+	FrameAllocator::free(moved);
+	FrameAllocator::free(b);
+	CHECK(FrameAllocator::get_live_allocations() == 0);
+}
+
+TEST_CASE("[FrameAllocator] Growth past the arena capacity") {
+	LocalVector<void *> blocks;
+	for (int i = 0; i < 1000; i++) {
+		void *block = FrameAllocator::alloc(1024);
+		memset(block, i & 0xFF, 1024);
+		blocks.push_back(block);
+	}
+	CHECK(FrameAllocator::get_capacity() >= 1000 * 1024);
+
+	bool intact = true;
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		intact = intact && ((uint8_t *)blocks[i])[1023] == (i & 0xFF);
+	}
+	CHECK_MESSAGE(intact, "Blocks from earlier arenas should stay valid.");
+
+	for (void *block : blocks) {
+		FrameAllocator::free(block);
+	}
+	CHECK(FrameAllocator::get_used() == 0);
+
+	// A quiet frame gives the memory of the large one back.
+	size_t capacity = FrameAllocator::get_capacity();
+	FrameAllocator::end_frame();
+	FrameAllocator::free(FrameAllocator::alloc(16));
+	FrameAllocator::end_frame();
+	CHECK(FrameAllocator::get_capacity() < capacity);
+}
+
+TEST_CASE("[FrameAllocator] Containers") {
+	{
+		LocalVector<int, uint32_t, false, false, FrameAllocator> vector;
+		for (int i = 0; i < 1000; i++) {
+			vector.push_back(i);
+		}
+		CHECK(vector.size() == 1000);
+		CHECK(vector[999] == 999);
+		CHECK(FrameAllocator::get_live_allocations() == 1);
+	}
+	CHECK(FrameAllocator::get_live_allocations() == 0);
+
+	{
+		HashMap<int, String, HashMapHasherDefault, HashMapComparatorDefault<int>, FrameTypedAllocator<HashMapElement<int, String>>> map;
+		for (int i = 0; i < 100; i++) {
+			map.insert(i, itos(i));
+		}
+		map.erase(50);
+		CHECK(map.size() == 99);
+		CHECK(map[42] == "42");
+		CHECK(FrameAllocator::get_live_allocations() == 99);
+	}
+	CHECK(FrameAllocator::get_live_allocations() == 0);
+}
+
+} // namespace TestFrameAllocator
+
+#endif // TEST_FRAME_ALLOCATOR_H
@@ -0,0 +1,208 @@
+/**************************************************************************/
+/*  test_size_class_allocator.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SIZE_CLASS_ALLOCATOR_H
+#define TEST_SIZE_CLASS_ALLOCATOR_H
+
+#include "core/os/os.h"
+#include "core/os/size_class_allocator.h"
+#include "core/os/thread.h"
+#include "core/variant/dictionary.h"
+#include "scene/main/node.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSizeClassAllocator {
+
+TEST_CASE("[SizeClassAllocator] Size classes") {
+	CHECK(SizeClassAllocator::get_size_class(1) == 0);
+	CHECK(SizeClassAllocator::get_size_class(16) == 0);
+	CHECK(SizeClassAllocator::get_size_class(17) == 1);
+	CHECK(SizeClassAllocator::get_size_class(128) == 7);
+	CHECK(SizeClassAllocator::get_size_class(129) == 8);
+	CHECK(SizeClassAllocator::get_size_class(SizeClassAllocator::MAX_SIZE) == SizeClassAllocator::CLASS_COUNT - 1);
+
+	size_t previous = 0;
+	for (uint32_t i = 0; i < SizeClassAllocator::CLASS_COUNT; i++) {
+		size_t size = SizeClassAllocator::get_class_size(i);
+		CHECK(size > previous);
+		CHECK(size % 16 == 0);
+		CHECK(SizeClassAllocator::get_size_class(size) == i);
+		CHECK(SizeClassAllocator::get_size_class(previous + 1) == i);
+		previous = size;
+	}
+	CHECK(previous == SizeClassAllocator::MAX_SIZE);
+}
+
+TEST_CASE("[SizeClassAllocator] Allocation and release") {
+	const uint32_t size_class = SizeClassAllocator::get_size_class(200);
+	const size_t size = SizeClassAllocator::get_class_size(size_class);
+	SizeClassAllocator::Stats before = SizeClassAllocator::get_stats(size_class);
+
+	LocalVector<uint8_t *> blocks;
+	blocks.reserve(1000);
+	for (int i = 0; i < 1000; i++) {
+		uint8_t *block = (uint8_t *)SizeClassAllocator::alloc(size_class);
+		REQUIRE(block != nullptr);
+		CHECK(((uintptr_t)block & 15) == 0);
+		memset(block, i & 0xFF, size);
+		blocks.push_back(block);
+	}
+
+	SizeClassAllocator::Stats during = SizeClassAllocator::get_stats(size_class);
+	CHECK(during.size == size);
+	CHECK(during.allocations == before.allocations + 1000);
+	CHECK(during.in_use == before.in_use + 1000);
+	CHECK(during.reserved >= during.in_use);
+
+	bool intact = true;
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		for (size_t j = 0; j < size; j++) {
+			intact = intact && blocks[i][j] == (i & 0xFF);
+		}
+		SizeClassAllocator::free(blocks[i], size_class);
+	}
+	CHECK_MESSAGE(intact, "Blocks should not overlap.");
+
+	SizeClassAllocator::Stats after = SizeClassAllocator::get_stats(size_class);
+	CHECK(after.in_use == before.in_use);
+	CHECK(after.cached >= 1000);
+	CHECK(after.reserved == during.reserved);
+}
+
+static void free_blocks(void *p_userdata) {
+	LocalVector<void *> *blocks = (LocalVector<void *> *)p_userdata;
+	for (void *block : *blocks) {
+		SizeClassAllocator::free(block, 0);
+	}
+}
+
+TEST_CASE("[SizeClassAllocator] Blocks released on another thread") {
+	SizeClassAllocator::Stats before = SizeClassAllocator::get_stats(0);
+
+	LocalVector<void *> blocks;
+	blocks.reserve(5000);
+	for (int i = 0; i < 5000; i++) {
+		blocks.push_back(SizeClassAllocator::alloc(0));
+	}
+
+	Thread thread;
+	thread.start(free_blocks, &blocks);
+	thread.wait_to_finish();
+
+	// The exited thread handed its cache back, so the blocks are reused here.
+	SizeClassAllocator::Stats after = SizeClassAllocator::get_stats(0);
+	CHECK(after.in_use == before.in_use);
+	for (int i = 0; i < 5000; i++) {
+		blocks[i] = SizeClassAllocator::alloc(0);
+	}
+	CHECK(SizeClassAllocator::get_stats(0).reserved == after.reserved);
+	for (void *block : blocks) {
+		SizeClassAllocator::free(block, 0);
+	}
+}
+
+TEST_CASE_BENCHMARK("[SizeClassAllocator][Benchmark] Allocation-heavy workloads") {
+	// The engine allocator is chosen at build time, so compare the engine
+	// workloads by running this with `allocator=system` and `allocator=size_classes`.
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	MESSAGE("Allocator: size_classes");
+#else
+	MESSAGE("Allocator: system");
+#endif
+
+	uint64_t usec = benchmark_usec([]() {
+		for (int i = 0; i < 2000; i++) {
+			Dictionary d;
+			for (int j = 0; j < 100; j++) {
+				d[itos(j)] = Array();
+			}
+			for (int j = 0; j < 100; j += 2) {
+				d.erase(itos(j));
+			}
+		}
+	});
+	MESSAGE(vformat("Dictionary churn: %d usec.", usec));
+
+	Node *root = memnew(Node);
+	for (int i = 0; i < 50; i++) {
+		Node *child = memnew(Node);
+		child->set_name(vformat("Child%d", i));
+		root->add_child(child);
+		child->set_owner(root);
+	}
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	REQUIRE(scene->pack(root) == OK);
+	memdelete(root);
+
+	usec = benchmark_usec([&]() {
+		for (int i = 0; i < 500; i++) {
+			Node *instance = scene->instantiate();
+			memdelete(instance);
+		}
+	});
+	MESSAGE(vformat("Scene instancing: %d usec.", usec));
+
+	// Both backends are always compiled, so raw block churn can be compared in
+	// the same binary.
+	const int blocks_per_round = 1000;
+	LocalVector<void *> blocks;
+	blocks.resize(blocks_per_round);
+
+	usec = benchmark_usec([&]() {
+		for (int round = 0; round < 1000; round++) {
+			for (int i = 0; i < blocks_per_round; i++) {
+				blocks[i] = malloc(16 + (i % 32) * 16);
+			}
+			for (int i = 0; i < blocks_per_round; i++) {
+				free(blocks[i]);
+			}
+		}
+	});
+	MESSAGE(vformat("Block churn (malloc): %d usec.", usec));
+
+	usec = benchmark_usec([&]() {
+		for (int round = 0; round < 1000; round++) {
+			for (int i = 0; i < blocks_per_round; i++) {
+				blocks[i] = SizeClassAllocator::alloc(SizeClassAllocator::get_size_class(16 + (i % 32) * 16));
+			}
+			for (int i = 0; i < blocks_per_round; i++) {
+				SizeClassAllocator::free(blocks[i], SizeClassAllocator::get_size_class(16 + (i % 32) * 16));
+			}
+		}
+	});
+	MESSAGE(vformat("Block churn (size classes): %d usec.", usec));
+}
+
+} // namespace TestSizeClassAllocator
+
+#endif // TEST_SIZE_CLASS_ALLOCATOR_H
@@ -31,6 +31,8 @@
 #ifndef TEST_STRING_H
 #define TEST_STRING_H
 
+#include "core/os/os.h"
+#include "core/string/string_builder.h"
 #include "core/string/ustring.h"
 
 #include "tests/test_macros.h"
@@ -166,6 +168,27 @@ TEST_CASE("[String] UTF8 with CR") {
 	CHECK(no_cr == base.replace("\r", ""));
 }
 
+TEST_CASE("[String] UTF8 with ASCII runs") {
+	// Long ASCII runs around multibyte characters, so both the bulk ASCII
+	// path and the decoder are exercised.
+	const String base = U"res://characters/player/animations/idle_äöü_walk_run_jump/player_😀_final.tscn";
+	String s;
+	Error err = s.parse_utf8(base.utf8().get_data());
+	CHECK(err == OK);
+	CHECK(s == base);
+
+	const char *ascii = "Hello darkness my old friend\0ignored";
+	err = s.parse_utf8(ascii, 37);
+	CHECK(err == OK);
+	CHECK(s == "Hello darkness my old friend");
+
+	err = s.parse_utf8("0123456789abcdef\r\n0123456789", -1, true);
+	CHECK(err == OK);
+	CHECK(s == "0123456789abcdef\n0123456789");
+
+	CHECK(String("plain ASCII text, longer than eight bytes").utf8() == CharString("plain ASCII text, longer than eight bytes"));
+}
+
 TEST_CASE("[String] Invalid UTF8 (non-standard)") {
 	ERR_PRINT_OFF
 	static const uint8_t u8str[] = { 0x45, 0xE3, 0x81, 0x8A, 0xE3, 0x82, 0x88, 0xE3, 0x81, 0x86, 0xF0, 0x9F, 0x8E, 0xA4, 0xF0, 0x82, 0x82, 0xAC, 0xED, 0xA0, 0x81, 0 };
@@ -1785,6 +1808,45 @@ TEST_CASE("[Stress][String] Empty via `is_empty()`") {
 		}
 	}
 }
+
+TEST_CASE_BENCHMARK("[String][Benchmark] Concatenation") {
+	const int iterations = 200000;
+	const String parts[] = { "a", "node", "position", "a_somewhat_longer_identifier" };
+
+	for (const String &part : parts) {
+		int64_t length = 0;
+
+		uint64_t plus_usec = benchmark_usec([&]() {
+			for (int i = 0; i < iterations; i++) {
+				String s = part + part;
+				length += s.length();
+			}
+		});
+
+		uint64_t append_usec = benchmark_usec([&]() {
+			for (int i = 0; i < iterations; i++) {
+				String s;
+				for (int j = 0; j < 8; j++) {
+					s += part;
+				}
+				length += s.length();
+			}
+		});
+
+		uint64_t builder_usec = benchmark_usec([&]() {
+			for (int i = 0; i < iterations; i++) {
+				StringBuilder sb;
+				for (int j = 0; j < 8; j++) {
+					sb.append(part);
+				}
+				length += sb.as_string().length();
+			}
+		});
+
+		CHECK(length == int64_t(part.length()) * iterations * 18);
+		MESSAGE(vformat("%d characters: a + b %d usec, 8x += %d usec, 8x StringBuilder %d usec.", part.length(), plus_usec, append_usec, builder_usec));
+	}
+}
 } // namespace TestString
 
 #endif // TEST_STRING_H
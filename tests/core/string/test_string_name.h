@@ -0,0 +1,191 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName from_cstring = StringName("test_string_name_interning");
+	const StringName from_string = StringName(String("test_string_name_interning"));
+	const StringName from_static = StringName(StaticCString::create("test_string_name_interning"));
+
+	CHECK_MESSAGE(from_cstring == from_string, "Names created from a C string and a String should be the same.");
+	CHECK_MESSAGE(from_cstring == from_static, "Names created from a C string and a static C string should be the same.");
+	CHECK(from_cstring.data_unique_pointer() == from_string.data_unique_pointer());
+	CHECK(from_cstring != StringName("test_string_name_interning_other"));
+
+	CHECK(StringName::search("test_string_name_interning") == from_cstring);
+	CHECK(StringName::search(String("test_string_name_interning")) == from_cstring);
+	CHECK(StringName::search(U"test_string_name_interning") == from_cstring);
+}
+
+TEST_CASE("[StringName] Released names can be interned again") {
+	const String name = "test_string_name_released";
+	{
+		StringName temporary = name;
+		CHECK(StringName::search(name) == temporary);
+	}
+	CHECK_MESSAGE(!StringName::search(name), "The name should be removed once its last reference is released.");
+
+	StringName recreated = name;
+	CHECK(String(recreated) == name);
+	CHECK(StringName::search(name) == recreated);
+}
+
+TEST_CASE("[StringName] Many names") {
+	// More names than the initial table size, so it grows.
+	const int count = 100000;
+	Vector<StringName> names;
+	names.resize(count);
+	for (int i = 0; i < count; i++) {
+		names.write[i] = StringName("test_string_name_many_" + itos(i));
+	}
+
+	bool all_found = true;
+	for (int i = 0; i < count; i++) {
+		if (StringName("test_string_name_many_" + itos(i)) != names[i]) {
+			all_found = false;
+		}
+	}
+	CHECK_MESSAGE(all_found, "Every name should still be found after the table grew.");
+}
+
+struct ConcurrentInterning {
+	static const int NAME_COUNT = 1000;
+	static const int ITERATIONS = 50;
+
+	Vector<String> strings;
+	Vector<StringName> expected;
+	SafeNumeric<uint32_t> mismatches;
+
+	static void thread_func(void *p_userdata) {
+		ConcurrentInterning *self = (ConcurrentInterning *)p_userdata;
+		for (int i = 0; i < ITERATIONS; i++) {
+			for (int j = 0; j < NAME_COUNT; j++) {
+				// Even names are kept alive by the main thread, odd ones are
+				// created and released concurrently.
+				StringName name = self->strings[j];
+				if (j % 2 == 0 && name != self->expected[j / 2]) {
+					self->mismatches.increment();
+				} else if (String(name) != self->strings[j]) {
+					self->mismatches.increment();
+				}
+			}
+		}
+	}
+};
+
+TEST_CASE("[StringName] Concurrent interning") {
+	ConcurrentInterning data;
+	for (int i = 0; i < ConcurrentInterning::NAME_COUNT; i++) {
+		data.strings.push_back("test_string_name_concurrent_" + itos(i));
+		if (i % 2 == 0) {
+			data.expected.push_back(StringName(data.strings[i]));
+		}
+	}
+
+	const int thread_count = 8;
+	Thread threads[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].start(ConcurrentInterning::thread_func, &data);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	CHECK_MESSAGE(data.mismatches.get() == 0, "Every thread should get the same name for the same string.");
+	for (int i = 1; i < ConcurrentInterning::NAME_COUNT; i += 2) {
+		CHECK_MESSAGE(!StringName::search(data.strings[i]), "Names released by every thread should be removed.");
+	}
+}
+
+struct InterningBenchmark {
+	static const int NAME_COUNT = 4096;
+	static const int ITERATIONS = 200;
+
+	Vector<String> strings;
+
+	static void thread_func(void *p_userdata) {
+		InterningBenchmark *self = (InterningBenchmark *)p_userdata;
+		for (int i = 0; i < ITERATIONS; i++) {
+			for (int j = 0; j < NAME_COUNT; j++) {
+				StringName name = self->strings[j];
+			}
+		}
+	}
+
+	uint64_t run(int p_thread_count) {
+		uint64_t usec = benchmark_usec([&]() {
+			Vector<Thread *> threads;
+			for (int i = 0; i < p_thread_count; i++) {
+				Thread *thread = memnew(Thread);
+				thread->start(thread_func, this);
+				threads.push_back(thread);
+			}
+			for (Thread *thread : threads) {
+				thread->wait_to_finish();
+				memdelete(thread);
+			}
+		});
+		return MAX(usec, (uint64_t)1);
+	}
+};
+
+TEST_CASE_BENCHMARK("[StringName][Benchmark] Concurrent interning") {
+	InterningBenchmark benchmark;
+	Vector<StringName> kept;
+	for (int i = 0; i < InterningBenchmark::NAME_COUNT; i++) {
+		benchmark.strings.push_back("test_string_name_benchmark_" + itos(i));
+		// Half of the names exist already (lookups), the other half are
+		// created and released by the threads (insertions and removals).
+		if (i % 2 == 0) {
+			kept.push_back(StringName(benchmark.strings[i]));
+		}
+	}
+
+	const int max_threads = OS::get_singleton()->get_processor_count();
+	for (int thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+		uint64_t usec = benchmark.run(thread_count);
+		uint64_t operations = uint64_t(thread_count) * InterningBenchmark::NAME_COUNT * InterningBenchmark::ITERATIONS;
+		MESSAGE(vformat("%d threads: %d names in %d usec (%d names/s).", thread_count, operations, usec, operations * 1000000 / usec));
+	}
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -0,0 +1,237 @@
+/**************************************************************************/
+/*  test_string_simd.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_SIMD_H
+#define TEST_STRING_SIMD_H
+
+#include "core/os/os.h"
+#include "core/string/string_simd.h"
+#include "core/string/ustring.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringSIMD {
+
+// Lengths around the vector widths, so both the vector loops and the scalar tails run.
+static const int test_lengths[] = { 0, 1, 3, 4, 5, 15, 16, 17, 31, 33, 64, 67 };
+
+TEST_CASE("[StringSIMD] Find") {
+	for (int len : test_lengths) {
+		String s;
+		for (int i = 0; i < len; i++) {
+			s += 'a' + i % 3;
+		}
+		s += U"😀xyz";
+		const int full_len = s.length();
+
+		CHECK(StringSIMD::find_char(s.get_data(), full_len, U'😀') == len);
+		CHECK(StringSIMD::find_char(s.get_data(), full_len, 'q') == -1);
+		CHECK(StringSIMD::find_either_char(s.get_data(), full_len, 'q', 'y') == len + 2);
+		CHECK(StringSIMD::find(s.get_data(), full_len, U"😀xy", 3) == len);
+		CHECK(StringSIMD::find(s.get_data(), full_len, U"xz", 2) == -1);
+		CHECK(StringSIMD::find(s.get_data(), full_len, U"yz", 2) == len + 2);
+		CHECK(StringSIMD::find(s.get_data(), full_len, U"yzw", 3) == -1);
+	}
+}
+
+TEST_CASE("[StringSIMD] ASCII case conversion") {
+	for (int len : test_lengths) {
+		String s;
+		for (int i = 0; i < len; i++) {
+			s += "aZ@[`{ 9"[i % 8];
+		}
+		const String ascii = s;
+		s += U"é";
+		s += "mixed";
+
+		CHECK(StringSIMD::find_ascii_case_change(ascii.get_data(), len, true) == 0);
+		CHECK(StringSIMD::find_ascii_case_change(ascii.get_data(), len, false) == (len > 1 ? 1 : len));
+
+		Vector<char32_t> buffer;
+		buffer.resize(s.length());
+		memcpy(buffer.ptrw(), s.get_data(), s.length() * sizeof(char32_t));
+		CHECK(StringSIMD::convert_ascii_case(buffer.ptrw(), buffer.size(), true) == len);
+		bool converted = true;
+		for (int i = 0; i < len; i++) {
+			converted = converted && buffer[i] == ascii.to_upper()[i];
+		}
+		CHECK(converted);
+		CHECK(buffer[len] == U'é');
+		CHECK(buffer[len + 1] == 'm');
+	}
+}
+
+TEST_CASE("[StringSIMD] Whitespace") {
+	for (int len : test_lengths) {
+		String s;
+		for (int i = 0; i < len; i++) {
+			s += i % 2 ? ' ' : '\t';
+		}
+		CHECK(StringSIMD::skip_whitespace(s.get_data(), len) == len);
+		CHECK(StringSIMD::skip_whitespace_backwards(s.get_data(), len) == 0);
+
+		String padded = s + "word" + s;
+		CHECK(StringSIMD::skip_whitespace(padded.get_data(), padded.length()) == len);
+		CHECK(StringSIMD::skip_whitespace_backwards(padded.get_data(), padded.length()) == len + 4);
+	}
+}
+
+TEST_CASE("[StringSIMD] ASCII conversion") {
+	for (int len : test_lengths) {
+		CharString ascii;
+		ascii.resize(len + 1);
+		for (int i = 0; i < len; i++) {
+			ascii[i] = ' ' + i % 95;
+		}
+		ascii[len] = 0;
+
+		CHECK(StringSIMD::utf8_ascii_prefix_length(ascii.get_data(), len, false) == len);
+
+		Vector<char32_t> wide;
+		wide.resize(len + 1);
+		StringSIMD::widen_ascii(wide.ptrw(), ascii.get_data(), len);
+		CHECK(StringSIMD::ascii_prefix_length(wide.ptr(), len) == len);
+
+		CharString narrow;
+		narrow.resize(len + 1);
+		StringSIMD::narrow_ascii(narrow.ptrw(), wide.ptr(), len);
+		narrow[len] = 0;
+		CHECK(narrow == ascii);
+
+		if (len > 0) {
+			// Stops at non-ASCII, NUL and CR bytes.
+			const int middle = len / 2;
+			ascii[middle] = '\r';
+			CHECK(StringSIMD::utf8_ascii_prefix_length(ascii.get_data(), len, false) == len);
+			CHECK(StringSIMD::utf8_ascii_prefix_length(ascii.get_data(), len, true) == middle);
+			ascii[middle] = 0;
+			CHECK(StringSIMD::utf8_ascii_prefix_length(ascii.get_data(), len, false) == middle);
+			ascii[middle] = (char)0xc3;
+			CHECK(StringSIMD::utf8_ascii_prefix_length(ascii.get_data(), len, false) == middle);
+
+			wide.write[middle] = U'é';
+			CHECK(StringSIMD::ascii_prefix_length(wide.ptr(), len) == middle);
+		}
+	}
+}
+
+TEST_CASE("[StringSIMD] String operations") {
+	const String text = U"The quick brown fox jumps over the lazy dog. Ünïcödé Ωmega. The End.";
+
+	CHECK(text.find("The", 1) == 60);
+	CHECK(text.find(String("lazy")) == 35);
+	CHECK(text.find(String("dog."), 42) == -1);
+	CHECK(text.find_char(U'ü') == -1);
+	CHECK(text.find_char(U'ï') == 47);
+	CHECK(text.findn("THE END") == 60);
+	CHECK(text.findn(U"ünÏ") == 45);
+	CHECK(text.findn(U"ωMEGA") == 53);
+
+	CHECK(text.to_upper() == U"THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG. ÜNÏCÖDÉ ΩMEGA. THE END.");
+	CHECK(text.to_lower() == U"the quick brown fox jumps over the lazy dog. ünïcödé ωmega. the end.");
+	CHECK(String("already lower").to_lower() == "already lower");
+
+	CHECK(text.replace("The", "A") == U"A quick brown fox jumps over the lazy dog. Ünïcödé Ωmega. A End.");
+	CHECK(text.replace(String("o"), String()).count("o") == 0);
+	CHECK(String("aaaa").replace("aa", "b") == "bb");
+	CHECK(String("aaaa").replace("a", "") == "");
+	CHECK(text.count("the") == 1);
+	CHECK(text.countn("the") == 3);
+
+	CHECK(String(" \t\n  padded \t").strip_edges() == "padded");
+	CHECK(String(" \t\n  padded \t").strip_edges(true, false) == "padded \t");
+	CHECK(String("  \t  ").strip_edges() == "");
+}
+
+static String _make_text(int p_lines) {
+	// Dialogue-like text, mostly ASCII with some accented characters.
+	String text;
+	for (int i = 0; i < p_lines; i++) {
+		text += vformat("    npc_%d: \"Have you seen the old lighthouse, traveller? They say the keeper left in %d.\"\t\n", i % 50, 1800 + i % 200);
+		if (i % 10 == 0) {
+			text += U"    narrator: \"Le phare était silencieux, comme toujours.\"\n";
+		}
+	}
+	return text;
+}
+
+TEST_CASE_BENCHMARK("[StringSIMD][Benchmark] String operations") {
+	const String text = _make_text(20000);
+	const CharString utf8 = text.utf8();
+	const PackedStringArray lines = text.split("\n");
+	const int iterations = 20;
+	int64_t checksum = 0;
+
+#define STRING_BENCHMARK(m_name, m_bytes, m_code)                                          \
+	{                                                                                       \
+		uint64_t usec = benchmark_usec([&]() {                                              \
+			for (int iteration = 0; iteration < iterations; iteration++) {                  \
+				m_code;                                                                     \
+			}                                                                               \
+		});                                                                                 \
+		usec = MAX(usec, (uint64_t)1);                                                      \
+		double megabytes = double(m_bytes) * iterations / (1024 * 1024);                    \
+		MESSAGE(vformat("%s: %d usec, %.1f MiB/s.", m_name, usec, megabytes / usec * 1000000.0)); \
+	}
+
+	const int64_t text_bytes = text.length() * sizeof(char32_t);
+	STRING_BENCHMARK("find (missing)", text_bytes, checksum += text.find("submarine"));
+	STRING_BENCHMARK("find (frequent)", text_bytes, {
+		for (int pos = text.find("the"); pos >= 0; pos = text.find("the", pos + 3)) {
+			checksum++;
+		}
+	});
+	STRING_BENCHMARK("findn (missing)", text_bytes, checksum += text.findn("SUBMARINE"));
+	STRING_BENCHMARK("find_char", text_bytes, checksum += text.find_char('#'));
+	STRING_BENCHMARK("count", text_bytes, checksum += text.count("keeper"));
+	STRING_BENCHMARK("replace", text_bytes, checksum += text.replace("lighthouse", "tower").length());
+	STRING_BENCHMARK("split", text_bytes, checksum += text.split("\n").size());
+	STRING_BENCHMARK("to_lower", text_bytes, checksum += text.to_lower().length());
+	STRING_BENCHMARK("to_upper", text_bytes, checksum += text.to_upper().length());
+	STRING_BENCHMARK("strip_edges (per line)", text_bytes, {
+		for (const String &line : lines) {
+			checksum += line.strip_edges().length();
+		}
+	});
+	STRING_BENCHMARK("utf8", text_bytes, checksum += text.utf8().length());
+	STRING_BENCHMARK("parse_utf8", utf8.length(), {
+		String parsed;
+		parsed.parse_utf8(utf8.get_data(), utf8.length());
+		checksum += parsed.length();
+	});
+
+#undef STRING_BENCHMARK
+
+	MESSAGE(vformat("Checksum: %d.", checksum));
+}
+
+} // namespace TestStringSIMD
+
+#endif // TEST_STRING_SIMD_H
@@ -0,0 +1,314 @@
+/**************************************************************************/
+/*  test_ordered_hash_map.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_ORDERED_HASH_MAP_H
+#define TEST_ORDERED_HASH_MAP_H
+
+#include "core/os/os.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/ordered_hash_map.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+namespace TestOrderedHashMap {
+
+TEST_CASE("[OrderedHashMap] Insert element") {
+	OrderedHashMap<int, int> map;
+	OrderedHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+}
+
+TEST_CASE("[OrderedHashMap] Overwrite element") {
+	OrderedHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[OrderedHashMap] Erase via key") {
+	OrderedHashMap<int, int> map;
+	map.insert(42, 84);
+	CHECK(map.erase(42));
+	CHECK(!map.erase(42));
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[OrderedHashMap] Insertion order") {
+	OrderedHashMap<int, int> map;
+	map.insert(5, 0);
+	map.insert(-3, 1);
+	map.insert(100, 2);
+	map.insert(7, 3);
+	map.erase(-3);
+	map.insert(-3, 4);
+
+	const int expected_keys[] = { 5, 100, 7, -3 };
+	int index = 0;
+	for (const KeyValue<int, int> &E : map) {
+		REQUIRE(index < 4);
+		CHECK(E.key == expected_keys[index]);
+		index++;
+	}
+	CHECK(index == 4);
+}
+
+TEST_CASE("[OrderedHashMap] Access by index") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(i, i * 10);
+	}
+	CHECK(map.get_at_index(0)->key == 0);
+	CHECK(map.get_at_index(99)->value == 990);
+	CHECK(!map.get_at_index(100));
+
+	// Index lookup skips erased elements.
+	map.erase(0);
+	map.erase(50);
+	CHECK(map.get_at_index(0)->key == 1);
+	CHECK(map.get_at_index(49)->key == 51);
+}
+
+TEST_CASE("[OrderedHashMap] Erase and compaction") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i);
+	}
+	int *kept = map.getptr(500);
+	// Erase every key except multiples of 10, leaving tombstones.
+	for (int i = 0; i < 1000; i++) {
+		if (i % 10 != 0) {
+			CHECK(map.erase(i));
+		}
+	}
+	CHECK(map.size() == 100);
+	CHECK_MESSAGE(map.getptr(500) == kept, "Erasing shouldn't move the remaining elements.");
+	CHECK(map.get_at_index(42)->key == 420);
+
+	map.compact();
+
+	int expected = 0;
+	bool in_order = true;
+	for (const KeyValue<int, int> &E : map) {
+		in_order = in_order && E.key == expected && E.value == expected;
+		expected += 10;
+	}
+	CHECK(in_order);
+	CHECK(expected == 1000);
+
+	bool found = true;
+	for (int i = 0; i < 1000; i++) {
+		found = found && map.has(i) == (i % 10 == 0);
+	}
+	CHECK(found);
+	CHECK(map.get_at_index(42)->key == 420);
+}
+
+TEST_CASE("[OrderedHashMap] Compaction reuses erased space") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i);
+	}
+	uint32_t capacity = map.get_capacity();
+	for (int i = 0; i < 900; i++) {
+		map.erase(i);
+	}
+	map.compact();
+	for (int i = 1000; i < 1900; i++) {
+		map.insert(i, i);
+	}
+	CHECK(map.size() == 1000);
+	CHECK_MESSAGE(map.get_capacity() == capacity, "Compacted tombstones should leave room for new elements.");
+
+	int expected = 900;
+	bool in_order = true;
+	for (const KeyValue<int, int> &E : map) {
+		in_order = in_order && E.key == expected && E.value == expected;
+		expected++;
+	}
+	CHECK(in_order);
+	CHECK(expected == 1900);
+}
+
+TEST_CASE("[OrderedHashMap] Value pointers survive erasing and inserting") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 200; i++) {
+		map.insert(i, i);
+	}
+	map.insert(-1, 1234);
+	int *kept = map.getptr(-1);
+	for (int i = 0; i < 200; i++) {
+		map.erase(i);
+	}
+	// Each round leaves tombstones before its last element, so they outnumber the elements
+	// whenever a new segment is needed.
+	for (int round = 1; round <= 8; round++) {
+		for (int i = 0; i < 200; i++) {
+			map.insert(round * 1000 + i, i);
+		}
+		map.insert(-1 - round, round);
+		for (int i = 0; i < 200; i++) {
+			map.erase(round * 1000 + i);
+		}
+	}
+	CHECK_MESSAGE(map.getptr(-1) == kept, "Insertions should never move existing elements.");
+	CHECK(*kept == 1234);
+	CHECK(map.size() == 9);
+	CHECK(map.get_at_index(0)->key == -1);
+	CHECK(map.get_at_index(8)->key == -9);
+}
+
+TEST_CASE("[OrderedHashMap] Erase all and reuse") {
+	OrderedHashMap<int, int> map;
+	for (int round = 0; round < 3; round++) {
+		for (int i = 0; i < 500; i++) {
+			map.insert(i, round);
+		}
+		CHECK(map.size() == 500);
+		for (int i = 0; i < 500; i++) {
+			map.erase(i);
+		}
+		CHECK(map.is_empty());
+		CHECK(map.begin() == map.end());
+	}
+}
+
+TEST_CASE("[OrderedHashMap] Value references survive growth") {
+	OrderedHashMap<int, int> map;
+	int &value = map[0];
+	value = 1234;
+	for (int i = 1; i < 1000; i++) {
+		map.insert(i, i);
+	}
+	CHECK(value == 1234);
+	CHECK(&value == &map[0]);
+}
+
+TEST_CASE("[OrderedHashMap] Iterate from a found element") {
+	OrderedHashMap<String, int> map;
+	map.insert("a", 1);
+	map.insert("b", 2);
+	map.insert("c", 3);
+	map.erase("b");
+
+	OrderedHashMap<String, int>::Iterator E = map.find("a");
+	++E;
+	REQUIRE(E);
+	CHECK(E->key == "c");
+	++E;
+	CHECK(!E);
+}
+
+TEST_CASE("[OrderedHashMap] Copy and clear") {
+	OrderedHashMap<String, int> map;
+	map.insert("one", 1);
+	map.insert("two", 2);
+	map.erase("one");
+	map.insert("three", 3);
+
+	OrderedHashMap<String, int> copy = map;
+	CHECK(copy.size() == 2);
+	CHECK(copy.get_at_index(0)->key == "two");
+	CHECK(copy.get_at_index(1)->key == "three");
+
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(!map.has("two"));
+	CHECK(copy["two"] == 2);
+
+	map = copy;
+	CHECK(map["three"] == 3);
+}
+
+template <class M>
+static void _benchmark_map(const char *p_name, int p_count) {
+	// Small maps are rebuilt several times so each row does a similar amount of work.
+	const int repeats = MAX(1, 1000000 / p_count);
+	uint64_t insert_usec = 0;
+	uint64_t lookup_usec = 0;
+	uint64_t iterate_usec = 0;
+	uint64_t erase_usec = 0;
+	int64_t sum = 0;
+
+	for (int r = 0; r < repeats; r++) {
+		M map;
+
+		insert_usec += benchmark_usec([&]() {
+			for (int i = 0; i < p_count; i++) {
+				map[Variant(i * 7)] = Variant(i);
+			}
+		});
+
+		lookup_usec += benchmark_usec([&]() {
+			for (int i = 0; i < p_count; i++) {
+				const Variant *value = map.getptr(Variant(i * 7));
+				sum += value ? int64_t(*value) : 0;
+			}
+		});
+
+		iterate_usec += benchmark_usec([&]() {
+			for (const KeyValue<Variant, Variant> &E : map) {
+				sum += int64_t(E.value);
+			}
+		});
+
+		erase_usec += benchmark_usec([&]() {
+			for (int i = 0; i < p_count; i++) {
+				map.erase(Variant(i * 7));
+			}
+		});
+	}
+
+	MESSAGE(vformat("%s, %d entries (x%d): insert %d usec, lookup %d usec, iterate %d usec, erase %d usec (checksum %d).",
+			p_name, p_count, repeats, insert_usec, lookup_usec, iterate_usec, erase_usec, sum));
+}
+
+TEST_CASE_BENCHMARK("[OrderedHashMap][Benchmark] Dictionary storage") {
+	const int entry_counts[] = { 10, 1000, 1000000 };
+
+	for (int count : entry_counts) {
+		_benchmark_map<HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>>("HashMap", count);
+		_benchmark_map<OrderedHashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>>("OrderedHashMap", count);
+	}
+}
+
+} // namespace TestOrderedHashMap
+
+#endif // TEST_ORDERED_HASH_MAP_H
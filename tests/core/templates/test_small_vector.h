@@ -0,0 +1,158 @@
+/**************************************************************************/
+/*  test_small_vector.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SMALL_VECTOR_H
+#define TEST_SMALL_VECTOR_H
+
+#include "core/os/os.h"
+#include "core/string/node_path.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/small_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSmallVector {
+
+TEST_CASE("[SmallVector] Inline storage") {
+	SmallVector<int, 4> vector;
+	CHECK(vector.is_empty());
+	CHECK(vector.get_capacity() == 4);
+
+	for (int i = 0; i < 4; i++) {
+		vector.push_back(i);
+	}
+	CHECK(vector.size() == 4);
+	CHECK_FALSE(vector.is_using_heap());
+
+	vector.push_back(4);
+	CHECK_MESSAGE(vector.is_using_heap(), "Growing past the inline capacity should move to the heap.");
+	for (int i = 0; i < 5; i++) {
+		CHECK(vector[i] == i);
+	}
+
+	vector.resize(2);
+	CHECK(vector.size() == 2);
+	CHECK(vector[1] == 1);
+}
+
+TEST_CASE("[SmallVector] Non-trivial elements") {
+	SmallVector<String, 2> vector{ "a", "b" };
+	CHECK_FALSE(vector.is_using_heap());
+	vector.push_back("c");
+	vector.push_back("d");
+	CHECK(vector.is_using_heap());
+
+	SmallVector<String, 2> copy = vector;
+	copy[0] = "z";
+	CHECK(vector[0] == "a");
+	CHECK(copy.size() == 4);
+	CHECK(copy[3] == "d");
+
+	String joined;
+	for (const String &s : vector) {
+		joined += s;
+	}
+	CHECK(joined == "abcd");
+
+	Vector<String> converted = vector;
+	CHECK(converted.size() == 4);
+	CHECK(converted[2] == "c");
+
+	vector.resize(6);
+	CHECK(vector[5].is_empty());
+	vector.clear();
+	CHECK(vector.is_empty());
+}
+
+TEST_CASE("[SmallVector] Copy of an inline vector") {
+	SmallVector<int, 8> vector{ 1, 2, 3 };
+	SmallVector<int, 8> copy;
+	copy = vector;
+	CHECK_FALSE(copy.is_using_heap());
+	CHECK(copy.ptr() != vector.ptr());
+	CHECK(copy.size() == 3);
+	CHECK(copy[2] == 3);
+}
+
+TEST_CASE_BENCHMARK("[SmallVector][Benchmark] Vector construction") {
+	const int iterations = 1000000;
+	const int element_counts[] = { 1, 4, 8, 16 };
+
+	for (int count : element_counts) {
+		int64_t sum = 0;
+
+		uint64_t vector_usec = benchmark_usec([&]() {
+			for (int i = 0; i < iterations; i++) {
+				Vector<const Variant *> vector;
+				for (int j = 0; j < count; j++) {
+					vector.push_back(nullptr);
+				}
+				sum += vector.size();
+			}
+		});
+
+		uint64_t local_vector_usec = benchmark_usec([&]() {
+			for (int i = 0; i < iterations; i++) {
+				LocalVector<const Variant *> vector;
+				for (int j = 0; j < count; j++) {
+					vector.push_back(nullptr);
+				}
+				sum += vector.size();
+			}
+		});
+
+		uint64_t small_vector_usec = benchmark_usec([&]() {
+			for (int i = 0; i < iterations; i++) {
+				SmallVector<const Variant *, 8> vector;
+				for (int j = 0; j < count; j++) {
+					vector.push_back(nullptr);
+				}
+				sum += vector.size();
+			}
+		});
+
+		CHECK(sum == int64_t(count) * iterations * 3);
+		MESSAGE(vformat("%d elements: Vector %d usec, LocalVector %d usec, SmallVector<8> %d usec.", count, vector_usec, local_vector_usec, small_vector_usec));
+	}
+
+	int subnames = 0;
+	uint64_t usec = benchmark_usec([&]() {
+		for (int i = 0; i < 100000; i++) {
+			NodePath path("Parent/Child:position:x");
+			subnames += path.get_subname_count();
+		}
+	});
+	CHECK(subnames == 200000);
+	MESSAGE(vformat("NodePath parsing: %d usec.", usec));
+}
+
+} // namespace TestSmallVector
+
+#endif // TEST_SMALL_VECTOR_H
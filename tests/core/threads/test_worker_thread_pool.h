@@ -32,6 +32,7 @@
 #define TEST_WORKER_THREAD_POOL_H
 
 #include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 
 #include "tests/test_macros.h"
 
@@ -83,6 +84,33 @@ TEST_CASE("[WorkerThreadPool] Process 256 threads using native low priority") {
 	CHECK(counter.get() == count);
 }
 
+struct PoolThreadCounters {
+	SafeNumeric<uint32_t> done;
+	SafeNumeric<uint32_t> off_pool;
+};
+
+static void static_pool_thread_test(void *p_arg) {
+	PoolThreadCounters *counters = (PoolThreadCounters *)p_arg;
+	if (WorkerThreadPool::get_singleton()->get_thread_index() < 0) {
+		counters->off_pool.increment();
+	}
+	counters->done.increment();
+}
+
+TEST_CASE("[WorkerThreadPool] Low priority pool tasks run on pool threads") {
+	const int count = 256;
+	PoolThreadCounters counters;
+	for (int i = 0; i < count; i++) {
+		WorkerThreadPool::get_singleton()->add_native_pool_task(static_pool_thread_test, &counters, false);
+	}
+	// Pool tasks can't be waited for, they free themselves when done.
+	while (counters.done.get() < count) {
+		OS::get_singleton()->delay_usec(1);
+	}
+
+	CHECK_MESSAGE(counters.off_pool.get() == 0, "No task should get a system thread of its own.");
+}
+
 TEST_CASE("[WorkerThreadPool] Process 256 threads using callable") {
 	const int count = 256;
 	WorkerThreadPool::TaskID tasks[count];
@@ -31,6 +31,7 @@
 #ifndef TEST_VARIANT_H
 #define TEST_VARIANT_H
 
+#include "core/os/os.h"
 #include "core/variant/variant.h"
 #include "core/variant/variant_parser.h"
 
@@ -1163,6 +1164,46 @@ TEST_CASE("[Variant] Utility functions") {
 	}
 }
 
+TEST_CASE_BENCHMARK("[Variant][Benchmark] VariantParser throughput") {
+	// Resembles the properties of a text scene: node names, paths and math types.
+	Array nodes;
+	for (int i = 0; i < 5000; i++) {
+		Dictionary node;
+		node["name"] = vformat("CollisionShape%d", i);
+		node["parent"] = NodePath(vformat("Level/Props/Crate%d", i % 100));
+		node["script"] = vformat("res://scripts/props/crate_%d.gd", i % 20);
+		node["transform"] = Transform3D(Basis(), Vector3(i, i * 0.5, -i));
+		node["modulate"] = Color(1, 0.5, 0.25, 1);
+		node["groups"] = build_array("props", "destructible");
+		nodes.push_back(node);
+	}
+	String text;
+	VariantWriter::write_to_string(nodes, text);
+	const int iterations = 10;
+
+	uint64_t parse_usec = benchmark_usec([&]() {
+		for (int i = 0; i < iterations; i++) {
+			VariantParser::StreamString ss;
+			ss.s = text;
+			Variant parsed;
+			String errs;
+			int line = 0;
+			CHECK(VariantParser::parse(&ss, parsed, errs, line) == OK);
+		}
+	});
+
+	uint64_t write_usec = benchmark_usec([&]() {
+		for (int i = 0; i < iterations; i++) {
+			String written;
+			VariantWriter::write_to_string(nodes, written);
+		}
+	});
+
+	const double megabytes = double(text.length()) * iterations / (1024 * 1024);
+	MESSAGE(vformat("VariantParser: %.1f MiB/s, VariantWriter: %.1f MiB/s (%d characters of text).",
+			megabytes / MAX(parse_usec, 1u) * 1000000.0, megabytes / MAX(write_usec, 1u) * 1000000.0, text.length()));
+}
+
 } // namespace TestVariant
 
 #endif // TEST_VARIANT_H
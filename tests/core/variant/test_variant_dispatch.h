@@ -0,0 +1,268 @@
+/**************************************************************************/
+/*  test_variant_dispatch.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_VARIANT_DISPATCH_H
+#define TEST_VARIANT_DISPATCH_H
+
+#include "core/object/class_db.h"
+#include "core/object/method_bind.h"
+#include "core/object/object.h"
+#include "core/os/os.h"
+#include "core/variant/callable.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+// Benchmarks of the dynamic dispatch paths of Variant, Object and Callable,
+// to evaluate changes to variant_call.cpp, variant_op.cpp, variant_setget.cpp
+// and method_bind.h. Each one reports the average time per call.
+
+namespace TestVariantDispatch {
+
+static const int ITERATIONS = 1000000;
+
+template <class F>
+static void _measure(const String &p_name, F p_function) {
+	int64_t checksum = 0;
+	uint64_t usec = benchmark_usec([&]() {
+		for (int i = 0; i < ITERATIONS; i++) {
+			checksum += p_function();
+		}
+	});
+	MESSAGE(vformat("%s: %.1f ns/call (checksum %d).", p_name, usec * 1000.0 / ITERATIONS, checksum));
+}
+
+TEST_CASE_BENCHMARK("[Variant][Benchmark] Builtin method calls") {
+	struct Case {
+		Variant base;
+		StringName method;
+		Variant argument;
+		int argument_count = 0;
+	};
+	Array array;
+	array.resize(16);
+	Dictionary dictionary;
+	dictionary["key"] = 1;
+	const Case cases[] = {
+		{ String("benchmark"), "length" },
+		{ Vector2(3, 4), "length" },
+		{ Vector3(1, 2, 3), "dot", Vector3(4, 5, 6), 1 },
+		{ array, "size" },
+		{ dictionary, "has", "key", 1 },
+	};
+
+	for (const Case &c : cases) {
+		const String name = Variant::get_type_name(c.base.get_type()) + "." + c.method;
+		const Variant *args[1] = { &c.argument };
+
+		Variant base = c.base;
+		_measure(name + " (Variant::callp)", [&]() {
+			Variant ret;
+			Callable::CallError ce;
+			base.callp(c.method, args, c.argument_count, ret, ce);
+			return int64_t(ce.error);
+		});
+
+		Variant::ValidatedBuiltInMethod validated = Variant::get_validated_builtin_method(c.base.get_type(), c.method);
+		// Validated calls expect the return value initialized to the right type.
+		Variant ret;
+		Callable::CallError ce;
+		base.callp(c.method, args, c.argument_count, ret, ce);
+		_measure(name + " (validated)", [&]() {
+			validated(&base, args, c.argument_count, &ret);
+			return int64_t(ret.get_type());
+		});
+	}
+}
+
+TEST_CASE_BENCHMARK("[Variant][Benchmark] Operators") {
+	struct Case {
+		Variant::Operator op;
+		Variant a;
+		Variant b;
+	};
+	const Case cases[] = {
+		{ Variant::OP_ADD, 1, 2 },
+		{ Variant::OP_MULTIPLY, 1.5, 2.5 },
+		{ Variant::OP_LESS, 1, 2.5 },
+		{ Variant::OP_ADD, Vector3(1, 2, 3), Vector3(4, 5, 6) },
+		{ Variant::OP_MULTIPLY, Transform3D(), Vector3(4, 5, 6) },
+		{ Variant::OP_ADD, String("bench"), String("mark") },
+		{ Variant::OP_EQUAL, StringName("bench"), StringName("mark") },
+		{ Variant::OP_EQUAL, String("bench"), StringName("bench") },
+	};
+
+	for (const Case &c : cases) {
+		const String name = vformat("%s %s %s", Variant::get_type_name(c.a.get_type()), Variant::get_operator_name(c.op), Variant::get_type_name(c.b.get_type()));
+
+		_measure(name + " (Variant::evaluate)", [&]() {
+			Variant ret;
+			bool valid = false;
+			Variant::evaluate(c.op, c.a, c.b, ret, valid);
+			return int64_t(valid);
+		});
+
+		Variant::ValidatedOperatorEvaluator validated = Variant::get_validated_operator_evaluator(c.op, c.a.get_type(), c.b.get_type());
+		// Validated evaluators expect the return value initialized to the right type.
+		Variant ret;
+		bool valid = false;
+		Variant::evaluate(c.op, c.a, c.b, ret, valid);
+		_measure(name + " (validated)", [&]() {
+			validated(&c.a, &c.b, &ret);
+			return int64_t(ret.get_type());
+		});
+	}
+}
+
+TEST_CASE_BENCHMARK("[Variant][Benchmark] Member access") {
+	struct Case {
+		Variant base;
+		StringName member;
+	};
+	const Case cases[] = {
+		{ Vector2(1, 2), "y" },
+		{ Vector3(1, 2, 3), "z" },
+		{ Color(1, 0.5, 0.25), "g" },
+		{ Transform3D(), "origin" },
+		{ Rect2(1, 2, 3, 4), "size" },
+	};
+
+	for (const Case &c : cases) {
+		const String name = Variant::get_type_name(c.base.get_type()) + "." + c.member;
+
+		_measure(name + " (Variant::get_named)", [&]() {
+			bool valid = false;
+			Variant ret = c.base.get_named(c.member, valid);
+			return int64_t(valid);
+		});
+
+		Variant::ValidatedGetter getter = Variant::get_member_validated_getter(c.base.get_type(), c.member);
+		// Same for validated getters.
+		bool valid = false;
+		Variant ret = c.base.get_named(c.member, valid);
+		_measure(name + " (validated get)", [&]() {
+			getter(&c.base, &ret);
+			return int64_t(ret.get_type());
+		});
+
+		Variant base = c.base;
+		const Variant value = ret;
+		_measure(name + " (Variant::set_named)", [&]() {
+			bool set_valid = false;
+			base.set_named(c.member, value, set_valid);
+			return int64_t(set_valid);
+		});
+	}
+}
+
+TEST_CASE_BENCHMARK("[Object][Benchmark] Method calls") {
+	Object object;
+	object.set_meta("key", 1);
+
+	const StringName get_instance_id = "get_instance_id";
+	const StringName has_meta = "has_meta";
+	const Variant key = StringName("key");
+	const Variant *args[1] = { &key };
+
+	_measure("Object::callp (0 arguments)", [&]() {
+		Callable::CallError ce;
+		Variant ret = object.callp(get_instance_id, nullptr, 0, ce);
+		return int64_t(ce.error);
+	});
+	_measure("Object::callp (1 argument)", [&]() {
+		Callable::CallError ce;
+		Variant ret = object.callp(has_meta, args, 1, ce);
+		return int64_t(ce.error);
+	});
+
+	MethodBind *get_instance_id_bind = ClassDB::get_method("Object", get_instance_id);
+	MethodBind *has_meta_bind = ClassDB::get_method("Object", has_meta);
+	REQUIRE(get_instance_id_bind);
+	REQUIRE(has_meta_bind);
+
+	_measure("MethodBind::call (0 arguments)", [&]() {
+		Callable::CallError ce;
+		Variant ret = get_instance_id_bind->call(&object, nullptr, 0, ce);
+		return int64_t(ce.error);
+	});
+	_measure("MethodBind::call (1 argument)", [&]() {
+		Callable::CallError ce;
+		Variant ret = has_meta_bind->call(&object, args, 1, ce);
+		return int64_t(ce.error);
+	});
+
+	const StringName key_name = "key";
+	const void *ptr_args[1] = { &key_name };
+	_measure("MethodBind::ptrcall (0 arguments)", [&]() {
+		uint64_t ret = 0;
+		get_instance_id_bind->ptrcall(&object, nullptr, &ret);
+		return int64_t(ret);
+	});
+	_measure("MethodBind::ptrcall (1 argument)", [&]() {
+		bool ret = false;
+		has_meta_bind->ptrcall(&object, ptr_args, &ret);
+		return int64_t(ret);
+	});
+}
+
+TEST_CASE_BENCHMARK("[Callable][Benchmark] Calls") {
+	Object object;
+	object.set_meta("key", 1);
+	const Variant key = StringName("key");
+	const Variant *args[1] = { &key };
+
+	Callable method_callable(&object, "has_meta");
+	_measure("Method callable", [&]() {
+		Variant ret;
+		Callable::CallError ce;
+		method_callable.callp(args, 1, ret, ce);
+		return int64_t(ce.error);
+	});
+
+	const Callable custom_callable = callable_mp(&object, &Object::has_meta);
+	_measure("Method pointer callable", [&]() {
+		Variant ret;
+		Callable::CallError ce;
+		custom_callable.callp(args, 1, ret, ce);
+		return int64_t(ce.error);
+	});
+
+	const Callable bound_callable = method_callable.bind(StringName("key"));
+	_measure("Bound callable", [&]() {
+		Variant ret;
+		Callable::CallError ce;
+		bound_callable.callp(nullptr, 0, ret, ce);
+		return int64_t(ce.error);
+	});
+}
+
+} // namespace TestVariantDispatch
+
+#endif // TEST_VARIANT_DISPATCH_H
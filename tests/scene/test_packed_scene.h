@@ -0,0 +1,208 @@
+/**************************************************************************/
+/*  test_packed_scene.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PACKED_SCENE_H
+#define TEST_PACKED_SCENE_H
+
+#include "core/os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPackedScene {
+
+// A small scene, in the spirit of a bullet or an enemy: a root with a few
+// children and some properties changed from their defaults.
+static Ref<PackedScene> _create_packed_scene() {
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+	root->set_position(Vector2(10, 20));
+	root->set_rotation(0.5);
+	root->add_to_group("enemies", true);
+
+	for (int i = 0; i < 3; i++) {
+		Node2D *child = memnew(Node2D);
+		child->set_name(vformat("Child%d", i));
+		child->set_position(Vector2(i, -i));
+		child->set_z_index(i + 1);
+		child->set_meta("index", i);
+		root->add_child(child);
+		child->set_owner(root);
+	}
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(root) == OK);
+	memdelete(root);
+	return packed_scene;
+}
+
+static void _check_instance(Node *p_node) {
+	Node2D *root = Object::cast_to<Node2D>(p_node);
+	REQUIRE(root);
+	CHECK(root->get_name() == "Root");
+	CHECK(root->get_position() == Vector2(10, 20));
+	CHECK(root->get_rotation() == doctest::Approx(0.5));
+	CHECK(root->is_in_group("enemies"));
+	REQUIRE(root->get_child_count() == 3);
+	for (int i = 0; i < 3; i++) {
+		Node2D *child = Object::cast_to<Node2D>(root->get_child(i));
+		REQUIRE(child);
+		CHECK(child->get_name() == vformat("Child%d", i));
+		CHECK(child->get_position() == Vector2(i, -i));
+		CHECK(child->get_z_index() == i + 1);
+		CHECK(int(child->get_meta("index")) == i);
+		CHECK(child->get_owner() == root);
+	}
+}
+
+TEST_CASE("[PackedScene] Instantiation") {
+	Ref<PackedScene> packed_scene = _create_packed_scene();
+
+	SUBCASE("Single instances") {
+		// The second instance reuses the plan built by the first one.
+		for (int i = 0; i < 2; i++) {
+			Node *instance = packed_scene->instantiate();
+			_check_instance(instance);
+			memdelete(instance);
+		}
+	}
+
+	SUBCASE("Batch") {
+		TypedArray<Node> instances = packed_scene->instantiate_batch(4);
+		REQUIRE(instances.size() == 4);
+		for (int i = 0; i < instances.size(); i++) {
+			Node *instance = Object::cast_to<Node>(instances[i]);
+			_check_instance(instance);
+			memdelete(instance);
+		}
+
+		CHECK(packed_scene->instantiate_batch(0).is_empty());
+	}
+
+	SUBCASE("Changing the state") {
+		Node *instance = packed_scene->instantiate();
+		memdelete(instance);
+
+		// Properties added after a plan was built must be applied too.
+		Ref<SceneState> state = packed_scene->get_state();
+		state->add_node_property(0, state->add_name("visible"), state->add_value(false));
+		instance = packed_scene->instantiate();
+		CHECK_FALSE(Object::cast_to<Node2D>(instance)->is_visible());
+		memdelete(instance);
+	}
+}
+
+TEST_CASE("[SceneTree][PackedScene] Node pooling") {
+	Ref<PackedScene> packed_scene = _create_packed_scene();
+	packed_scene->set_path("res://test_pooled_scene.tscn");
+	SceneTree *tree = SceneTree::get_singleton();
+	const uint64_t hits = tree->get_node_pool_hit_count();
+	const uint64_t misses = tree->get_node_pool_miss_count();
+
+	Node *instance = tree->pool_instantiate(packed_scene);
+	_check_instance(instance);
+	CHECK(tree->get_node_pool_miss_count() == misses + 1);
+
+	// Change the instance as a game would do.
+	Node *spawner = memnew(Node);
+	tree->get_root()->add_child(spawner);
+	spawner->add_child(instance);
+	Node2D *root = Object::cast_to<Node2D>(instance);
+	root->set_position(Vector2(-5, -5));
+	root->add_to_group("hit");
+	root->remove_from_group("enemies");
+	root->set_meta("damage", 10);
+	Object::cast_to<Node2D>(root->get_child(1))->set_z_index(42);
+	root->connect("tree_exited", callable_mp(spawner, &Node::request_ready));
+
+	tree->pool_release(instance);
+	CHECK_MESSAGE(instance->get_parent() == spawner, "Released nodes should only be removed at the end of the frame.");
+	tree->process(0.0);
+	CHECK(tree->get_pooled_node_count() >= 1);
+
+	Node *reused = tree->pool_instantiate(packed_scene);
+	CHECK(reused == instance);
+	CHECK(tree->get_node_pool_hit_count() == hits + 1);
+	CHECK(reused->get_parent() == nullptr);
+	_check_instance(reused);
+	CHECK_FALSE(reused->is_in_group("hit"));
+	CHECK_FALSE(reused->has_meta("damage"));
+	CHECK_FALSE(reused->is_connected("tree_exited", callable_mp(spawner, &Node::request_ready)));
+
+	// Instances which structure changed can't be reset.
+	memdelete(reused->get_child(0));
+	tree->pool_release(reused);
+	tree->process(0.0);
+	Node *fresh = tree->pool_instantiate(packed_scene);
+	_check_instance(fresh);
+	CHECK(tree->get_node_pool_miss_count() == misses + 2);
+
+	// Pooled instances freed through a reference kept after releasing them are skipped.
+	tree->pool_release(fresh);
+	tree->process(0.0);
+	memdelete(fresh);
+	Node *next = tree->pool_instantiate(packed_scene);
+	_check_instance(next);
+	CHECK(tree->get_node_pool_miss_count() == misses + 3);
+
+	memdelete(next);
+	memdelete(spawner);
+	tree->pool_clear();
+	CHECK(tree->get_pooled_node_count() == 0);
+}
+
+TEST_CASE_BENCHMARK("[PackedScene][Benchmark] Instantiation") {
+	Ref<PackedScene> packed_scene = _create_packed_scene();
+	const int count = 10000;
+
+	uint64_t usec = benchmark_usec([&]() {
+		for (int i = 0; i < count; i++) {
+			memdelete(packed_scene->instantiate());
+		}
+	});
+	MESSAGE(vformat("PackedScene::instantiate: %d instances/s.", int64_t(count * 1000000.0 / MAX(usec, (uint64_t)1))));
+
+	TypedArray<Node> instances;
+	usec = benchmark_usec([&]() {
+		instances = packed_scene->instantiate_batch(count);
+	});
+	MESSAGE(vformat("PackedScene::instantiate_batch: %d instances/s.", int64_t(count * 1000000.0 / MAX(usec, (uint64_t)1))));
+	for (int i = 0; i < instances.size(); i++) {
+		memdelete(Object::cast_to<Node>(instances[i]));
+	}
+}
+
+} // namespace TestPackedScene
+
+#endif // TEST_PACKED_SCENE_H
@@ -36,6 +36,7 @@
 #include "core/core_globals.h"
 #include "core/input/input_map.h"
 #include "core/object/message_queue.h"
+#include "core/os/os.h"
 #include "core/variant/variant.h"
 
 // See documentation for doctest at:
@@ -45,6 +46,17 @@
 // The test is skipped with this, run pending tests with `--test --no-skip`.
 #define TEST_CASE_PENDING(name) TEST_CASE(name *doctest::skip())
 
+// Benchmarks are skipped by default, run them with `--test --no-skip --test-case="*[Benchmark]*"`.
+#define TEST_CASE_BENCHMARK(name) TEST_CASE(name *doctest::skip())
+
+// Runs `p_code` and returns how long it took, in microseconds. Use it to time benchmark loops.
+template <class F>
+uint64_t benchmark_usec(F p_code) {
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	p_code();
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
 // The test case is marked as failed, but does not fail the entire test run.
 #define TEST_CASE_MAY_FAIL(name) TEST_CASE(name *doctest::may_fail())
 